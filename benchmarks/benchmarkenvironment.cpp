@@ -0,0 +1,186 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "benchmarkenvironment.h"
+
+#include <filesystem>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include "../src/common/paths.h"
+#include "../src/config/configurationprovider.h"
+#include "../src/database/connectionprovider.h"
+#include "../src/database/sqliteconnectionfactory.h"
+
+namespace fs = std::filesystem;
+
+namespace app::benchmarks
+{
+BenchmarkEnvironment& BenchmarkEnvironment::Get()
+{
+    static BenchmarkEnvironment instance;
+    return instance;
+}
+
+BenchmarkEnvironment::BenchmarkEnvironment()
+    : pLogger(spdlog::stderr_color_st("benchmarks"))
+    , bActive(false)
+    , mActiveScale(DatasetScale::Small)
+{
+    /* the services log every failure, but their info output would drown the benchmark report */
+    pLogger->set_level(spdlog::level::warn);
+}
+
+std::shared_ptr<spdlog::logger> BenchmarkEnvironment::Logger()
+{
+    return pLogger;
+}
+
+bool BenchmarkEnvironment::Use(DatasetScale scale, Dataset& dataset)
+{
+    if (!Prepare(scale, dataset)) {
+        return false;
+    }
+
+    if (bActive && mActiveScale == scale) {
+        return true;
+    }
+
+    if (!InitializeConfiguration(dataset)) {
+        return false;
+    }
+    InitializeConnectionPool(dataset, 1);
+
+    bActive = true;
+    mActiveScale = scale;
+    return true;
+}
+
+bool BenchmarkEnvironment::InitializeConfiguration(const Dataset& dataset)
+{
+    try {
+        cfg::ConfigurationProvider::Get().Initialize(pLogger, TASKABLE_SOURCE_DIR "/taskable.toml");
+    } catch (const std::exception& e) {
+        pLogger->error("Failed to load configuration - {0}", e.what());
+        return false;
+    }
+
+    /* only the in memory configuration is changed, the checked in file is never saved */
+    auto& configuration = cfg::ConfigurationProvider::Get().Configuration;
+    configuration->SetDatabasePath(dataset.Directory);
+    configuration->SetBackupPath((fs::path(dataset.Directory) / "backups").string());
+    configuration->SetExportPath((fs::path(dataset.Directory) / "exports").string());
+    return true;
+}
+
+void BenchmarkEnvironment::InitializeConnectionPool(const Dataset& dataset, int connectionPoolSize)
+{
+    auto sqliteConnectionFactory = std::make_shared<db::SqliteConnectionFactory>(dataset.DatabaseFilePath);
+    auto connectionPool =
+        std::make_unique<db::ConnectionPool<db::SqliteConnection>>(sqliteConnectionFactory, connectionPoolSize);
+    db::ConnectionProvider::Get().ReInitializeConnectionPool(std::move(connectionPool));
+    bActive = false;
+}
+
+const char* BenchmarkEnvironment::GetScaleName(DatasetScale scale)
+{
+    switch (scale) {
+    case DatasetScale::Small:
+        return "small";
+    case DatasetScale::Large:
+        return "large";
+    case DatasetScale::Huge:
+        return "huge";
+    default:
+        return "unknown";
+    }
+}
+
+GeneratorOptions BenchmarkEnvironment::CreateOptions(DatasetScale scale) const
+{
+    GeneratorOptions options;
+
+    if (scale == DatasetScale::Large) {
+        options.Years = 10;
+        options.Projects = 40;
+        options.CategoriesPerProject = 6;
+        options.EntriesPerDay = 40;
+        options.MeetingsPerDay = 2;
+    } else if (scale == DatasetScale::Huge) {
+        options.Years = 20;
+        options.Projects = 60;
+        options.CategoriesPerProject = 6;
+        options.EntriesPerDay = 300;
+        options.MeetingsPerDay = 4;
+    }
+
+    return options;
+}
+
+bool BenchmarkEnvironment::Prepare(DatasetScale scale, Dataset& dataset)
+{
+    dataset.Scale = scale;
+    dataset.Options = CreateOptions(scale);
+    dataset.Directory =
+        (fs::temp_directory_path() / "taskable-benchmarks" / dataset.Options.Describe()).string();
+    dataset.DatabaseFilePath = common::GetDatabaseFilePath(dataset.Directory).ToStdString();
+
+    int startDay = 0;
+    if (!ParseIsoDate(dataset.Options.StartDate, startDay)) {
+        pLogger->error("Invalid start date {0}", dataset.Options.StartDate);
+        return false;
+    }
+
+    const int middleWeek = dataset.Options.Years * 52 / 2;
+    const int weekStartDay = startDay + middleWeek * 7;
+    dataset.SampleDate = FormatIsoDate(weekStartDay + 2);
+    dataset.WeekFromDate = FormatIsoDate(weekStartDay);
+    dataset.WeekToDate = FormatIsoDate(weekStartDay + 6);
+    dataset.QuarterFromDate = dataset.WeekFromDate;
+    dataset.QuarterToDate = FormatIsoDate(weekStartDay + 13 * 7 - 1);
+
+    std::error_code ec;
+    fs::create_directories(fs::path(dataset.Directory) / "backups", ec);
+    fs::create_directories(fs::path(dataset.Directory) / "exports", ec);
+    if (ec) {
+        pLogger->error("Failed to create benchmark directory {0} - {1}", dataset.Directory, ec.message());
+        return false;
+    }
+
+    if (fs::exists(dataset.DatabaseFilePath)) {
+        return true;
+    }
+
+    /* generate next to the final file and rename so an interrupted run never leaves a partial cache */
+    const std::string generatedFilePath = dataset.DatabaseFilePath + ".tmp";
+    GeneratorSummary summary;
+    DataGenerator generator(pLogger, dataset.Options);
+    if (!generator.Generate(generatedFilePath, summary)) {
+        return false;
+    }
+
+    fs::rename(generatedFilePath, dataset.DatabaseFilePath, ec);
+    if (ec) {
+        pLogger->error("Failed to move {0} into place - {1}", generatedFilePath, ec.message());
+        return false;
+    }
+
+    return true;
+}
+} // namespace app::benchmarks
@@ -0,0 +1,85 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "datagenerator.h"
+
+namespace app::benchmarks
+{
+enum class DatasetScale : int {
+    Small = 0,
+    Large = 1,
+    /* ~1.5m task items, around 200MB on disk, only used by the backup benchmarks */
+    Huge = 2,
+};
+
+struct Dataset {
+    DatasetScale Scale;
+    GeneratorOptions Options;
+    std::string Directory;
+    std::string DatabaseFilePath;
+
+    /* a Wednesday in the middle of the generated range */
+    std::string SampleDate;
+    /* Monday and Sunday of the week containing SampleDate */
+    std::string WeekFromDate;
+    std::string WeekToDate;
+    /* thirteen weeks starting with WeekFromDate */
+    std::string QuarterFromDate;
+    std::string QuarterToDate;
+};
+
+/*
+ Owns the generated benchmark databases and points the configuration and connection provider at
+ them. Databases are cached in the temporary directory keyed on the generator options, so only the
+ first run of a given scale pays for generating the data.
+ */
+class BenchmarkEnvironment final
+{
+public:
+    static BenchmarkEnvironment& Get();
+
+    BenchmarkEnvironment(const BenchmarkEnvironment&) = delete;
+    BenchmarkEnvironment& operator=(const BenchmarkEnvironment&) = delete;
+
+    std::shared_ptr<spdlog::logger> Logger();
+
+    bool Use(DatasetScale scale, Dataset& dataset);
+    bool InitializeConfiguration(const Dataset& dataset);
+    void InitializeConnectionPool(const Dataset& dataset, int connectionPoolSize);
+
+    static const char* GetScaleName(DatasetScale scale);
+
+private:
+    BenchmarkEnvironment();
+
+    GeneratorOptions CreateOptions(DatasetScale scale) const;
+    bool Prepare(DatasetScale scale, Dataset& dataset);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    bool bActive;
+    DatasetScale mActiveScale;
+};
+} // namespace app::benchmarks
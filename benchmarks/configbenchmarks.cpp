@@ -0,0 +1,90 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/config/configuration.h"
+
+#include "benchmarkenvironment.h"
+
+namespace app::benchmarks
+{
+namespace
+{
+/*
+ A burst of settings changes, each one saved straight away like the preferences dialog does. Only the
+ setter and Save calls are timed, that is what the UI thread pays. The debounce window is far longer than
+ any burst can take, even on a loaded machine or under sanitizers, and Flush then writes what is pending:
+ the writer must have written the file exactly once, with the last value.
+ */
+void BM_Configuration_SaveBurst(benchmark::State& state)
+{
+    static const int Changes = 1000;
+    static const std::chrono::milliseconds DebounceWindow = std::chrono::minutes(10);
+
+    /* concurrent runs, e.g. ctest -j or two build directories, must not share the file */
+    std::random_device random;
+    std::string configFileName = "taskable-benchmarks-" + std::to_string(random()) + ".toml";
+    std::string configFilePath = (std::filesystem::temp_directory_path() / configFileName).string();
+    auto logger = BenchmarkEnvironment::Get().Logger();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::error_code ec;
+        std::filesystem::copy_file(TASKABLE_SOURCE_DIR "/taskable.toml",
+            configFilePath,
+            std::filesystem::copy_options::overwrite_existing,
+            ec);
+        if (ec) {
+            state.SkipWithError("Failed to copy the configuration file");
+            break;
+        }
+
+        cfg::Configuration configuration(logger, configFilePath, DebounceWindow);
+        state.ResumeTiming();
+
+        for (int i = 1; i <= Changes; i++) {
+            configuration.SetNotificationTimerInterval(i);
+            configuration.Save();
+        }
+
+        state.PauseTiming();
+        if (!configuration.Flush() || configuration.GetWriteCount() != 1) {
+            state.SkipWithError("The burst of changes was not written exactly once");
+            break;
+        }
+
+        cfg::Configuration written(logger, configFilePath);
+        if (written.GetNotificationTimerInterval() != Changes) {
+            state.SkipWithError("The configuration file does not hold the last change");
+            break;
+        }
+        state.ResumeTiming();
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove(configFilePath, ignored);
+}
+BENCHMARK(BM_Configuration_SaveBurst)->Iterations(3)->Unit(benchmark::kMicrosecond);
+} // namespace
+} // namespace app::benchmarks
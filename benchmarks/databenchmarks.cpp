@@ -0,0 +1,626 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <sqlite_modern_cpp.h>
+
+#include "../src/common/constants.h"
+#include "../src/config/configurationprovider.h"
+#include "../src/data/taskitemdata.h"
+#include "../src/services/backupchunkstore.h"
+#include "../src/services/backupcompressor.h"
+#include "../src/services/csvexporter.h"
+#include "../src/services/databasebackup.h"
+#include "../src/services/databasemigrator.h"
+#include "../src/services/exporter.h"
+#include "../src/services/reportservice.h"
+
+#include "benchmarkenvironment.h"
+
+namespace app::benchmarks
+{
+namespace
+{
+/*
+ Every benchmark takes the dataset scale as its first argument, prepares (or reuses) the matching
+ database and labels the run with it so the JSON output can be compared between scales.
+ */
+bool UseDataset(benchmark::State& state, Dataset& dataset)
+{
+    auto scale = static_cast<DatasetScale>(state.range(0));
+    if (!BenchmarkEnvironment::Get().Use(scale, dataset)) {
+        state.SkipWithError("Failed to prepare the benchmark database");
+        return false;
+    }
+
+    state.SetLabel(BenchmarkEnvironment::GetScaleName(scale));
+    return true;
+}
+
+/*
+ Rolls a copy of the dataset back to schema version 0, the shape of the oldest released databases:
+ projects still has the hours column and there is no meetings table or task_items.meeting_id.
+ Rebuilt on every run so it always follows the current dataset and the statements below.
+
+ With failLastMigration the copy also gets the table the last migration rebuilds task_items into,
+ so the migration fails after the earlier ones were applied and everything has to be rolled back.
+ */
+bool CreateVersionZeroDatabase(const std::string& databaseFilePath,
+    const std::string& versionZeroFilePath,
+    bool failLastMigration)
+{
+    const std::string temporaryFilePath = versionZeroFilePath + ".tmp";
+    std::error_code ec;
+    std::filesystem::copy_file(
+        databaseFilePath, temporaryFilePath, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) {
+        return false;
+    }
+
+    try {
+        sqlite::database database(temporaryFilePath);
+        database << "BEGIN;";
+        database << "ALTER TABLE projects ADD COLUMN hours INTEGER NULL;";
+        database << "CREATE TABLE task_items_v0 AS "
+                    "SELECT task_item_id, start_time, end_time, duration, description, billable, calculated_rate, "
+                    "date_created, date_modified, is_active, task_item_type_id, project_id, task_id, category_id "
+                    "FROM task_items;";
+        database << "DROP TABLE task_items;";
+        database << "ALTER TABLE task_items_v0 RENAME TO task_items;";
+        database << "DROP TABLE meetings;";
+        if (failLastMigration) {
+            database << "CREATE TABLE sqlb_temp_table_1 (task_item_id INTEGER);";
+        }
+        database << "PRAGMA user_version = 0;";
+        database << "COMMIT;";
+    } catch (const sqlite::sqlite_exception&) {
+        return false;
+    }
+
+    std::filesystem::rename(temporaryFilePath, versionZeroFilePath, ec);
+    return !ec;
+}
+
+struct SchemaState {
+    int Version;
+    bool HasProjectsHoursColumn;
+    bool HasMeetingsTable;
+    bool HasTaskItemsMeetingIdColumn;
+};
+
+bool ReadSchemaState(const std::string& databaseFilePath, SchemaState& schemaState)
+{
+    try {
+        sqlite::database database(databaseFilePath);
+        int count = 0;
+        database << "PRAGMA user_version;" >> schemaState.Version;
+        database << "SELECT COUNT(*) FROM pragma_table_info('projects') WHERE name = 'hours';" >> count;
+        schemaState.HasProjectsHoursColumn = count > 0;
+        database << "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'meetings';" >> count;
+        schemaState.HasMeetingsTable = count > 0;
+        database << "SELECT COUNT(*) FROM pragma_table_info('task_items') WHERE name = 'meeting_id';" >> count;
+        schemaState.HasTaskItemsMeetingIdColumn = count > 0;
+    } catch (const sqlite::sqlite_exception&) {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ Copies the version 0 database over the migration database and runs DatabaseMigrator on it, only the
+ migration itself is timed. Stops the benchmark with an error when Execute does not return
+ expectedResult.
+ */
+bool RunMigration(benchmark::State& state,
+    const Dataset& dataset,
+    const std::string& versionZeroFilePath,
+    bool expectedResult)
+{
+    state.PauseTiming();
+    std::error_code ec;
+    std::filesystem::copy_file(
+        versionZeroFilePath, dataset.DatabaseFilePath, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) {
+        state.SkipWithError("Failed to copy the version 0 database");
+        return false;
+    }
+    /* also marks the environment inactive, so the next benchmark switches back to the dataset */
+    auto& environment = BenchmarkEnvironment::Get();
+    environment.InitializeConnectionPool(dataset, 1);
+    state.ResumeTiming();
+
+    svc::DatabaseMigrator databaseMigrator(environment.Logger());
+    if (databaseMigrator.Execute() != expectedResult) {
+        state.SkipWithError(
+            expectedResult ? "DatabaseMigrator::Execute failed" : "DatabaseMigrator::Execute did not fail");
+        return false;
+    }
+
+    return true;
+}
+
+void BM_TaskItemData_GetByDate(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    data::TaskItemData taskItemData;
+    std::size_t taskItems = 0;
+    for (auto _ : state) {
+        auto result = taskItemData.GetByDate(dataset.SampleDate);
+        taskItems += result.size();
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["task_items"] =
+        benchmark::Counter(static_cast<double>(taskItems), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_TaskItemData_GetByDate)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+void BM_TaskItemData_GetByWeek(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    data::TaskItemData taskItemData;
+    std::size_t taskItems = 0;
+    for (auto _ : state) {
+        auto result = taskItemData.GetByWeek(dataset.WeekFromDate, dataset.WeekToDate);
+        taskItems += result.size();
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["task_items"] =
+        benchmark::Counter(static_cast<double>(taskItems), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_TaskItemData_GetByWeek)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+void BM_TaskItemData_GetHours(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    data::TaskItemData taskItemData;
+    for (auto _ : state) {
+        auto result = taskItemData.GetHours(dataset.SampleDate);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_TaskItemData_GetHours)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+void BM_TaskItemData_GetHoursByWeek(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    data::TaskItemData taskItemData;
+    for (auto _ : state) {
+        auto result = taskItemData.GetHoursByWeek(dataset.WeekFromDate, dataset.WeekToDate);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_TaskItemData_GetHoursByWeek)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+void BM_CsvExporter_ExportData(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    const std::string exportFilePath =
+        (std::filesystem::path(dataset.Directory) / "exports" / "benchmark.csv").string();
+    for (auto _ : state) {
+        svc::CsvExporter csvExporter(
+            BenchmarkEnvironment::Get().Logger(), dataset.QuarterFromDate, dataset.QuarterToDate, exportFilePath);
+        if (!csvExporter.ExportData()) {
+            state.SkipWithError("CsvExporter::ExportData failed");
+            break;
+        }
+    }
+
+    std::error_code ec;
+    auto bytes = std::filesystem::file_size(exportFilePath, ec);
+    if (!ec) {
+        state.SetBytesProcessed(static_cast<int64_t>(bytes) * state.iterations());
+    }
+}
+BENCHMARK(BM_CsvExporter_ExportData)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+void BM_Exporter_ExportData(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    auto format = static_cast<constants::ExportFormats>(state.range(1));
+    const std::string exportFilePath = (std::filesystem::path(dataset.Directory) / "exports" /
+                                        ("benchmark" + svc::GetExportFileExtension(format)))
+                                           .string();
+    for (auto _ : state) {
+        auto exporter = svc::CreateExporter(format,
+            BenchmarkEnvironment::Get().Logger(),
+            dataset.QuarterFromDate,
+            dataset.QuarterToDate,
+            exportFilePath);
+        if (exporter == nullptr || !exporter->ExportData()) {
+            state.SkipWithError("IExporter::ExportData failed");
+            break;
+        }
+    }
+
+    std::error_code ec;
+    auto bytes = std::filesystem::file_size(exportFilePath, ec);
+    if (!ec) {
+        state.SetBytesProcessed(static_cast<int64_t>(bytes) * state.iterations());
+    }
+}
+BENCHMARK(BM_Exporter_ExportData)
+    ->ArgsProduct({ { 0, 1 },
+        { static_cast<int64_t>(constants::ExportFormats::JsonLines),
+            static_cast<int64_t>(constants::ExportFormats::Columnar) } })
+    ->Unit(benchmark::kMillisecond);
+
+/*
+ Reports over every generated task item (more than 100k at the large scale) grouped by the second argument. The
+ summary reports are meant to stay sub-second at that size, so the slowest run is checked against it.
+ */
+void BM_ReportService_Run(benchmark::State& state)
+{
+    const double ReportTimeLimitMilliseconds = 1000.0;
+
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    int startDay = 0;
+    if (!ParseIsoDate(dataset.Options.StartDate, startDay)) {
+        state.SkipWithError("Invalid dataset start date");
+        return;
+    }
+    const std::string toDate = FormatIsoDate(startDay + (dataset.Options.Years + 1) * 366);
+
+    auto grouping = static_cast<constants::ReportGroupings>(state.range(1));
+    svc::ReportService reportService(BenchmarkEnvironment::Get().Logger());
+    svc::ReportTable table;
+    double slowestMilliseconds = 0.0;
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+        if (!reportService.Run(grouping, constants::ReportGroupings::None, dataset.Options.StartDate, toDate, table)) {
+            state.SkipWithError("ReportService::Run failed");
+            return;
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        slowestMilliseconds = std::max(slowestMilliseconds, elapsed.count());
+    }
+
+    state.counters["task_items"] = static_cast<double>(table.Totals.Entries);
+    state.counters["rows"] = static_cast<double>(table.Rows.size());
+    state.counters["slowest_ms"] = slowestMilliseconds;
+    if (static_cast<DatasetScale>(state.range(0)) == DatasetScale::Large &&
+        slowestMilliseconds > ReportTimeLimitMilliseconds) {
+        state.SkipWithError("ReportService::Run took longer than a second");
+    }
+}
+BENCHMARK(BM_ReportService_Run)
+    ->ArgsProduct({ { 0, 1 },
+        { static_cast<int64_t>(constants::ReportGroupings::Project),
+            static_cast<int64_t>(constants::ReportGroupings::Client),
+            static_cast<int64_t>(constants::ReportGroupings::Week) } })
+    ->Unit(benchmark::kMillisecond);
+
+void BM_DatabaseBackup_Execute(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    for (auto _ : state) {
+        svc::DatabaseBackup databaseBackup(BenchmarkEnvironment::Get().Logger());
+        if (!databaseBackup.Execute()) {
+            state.SkipWithError("DatabaseBackup::Execute failed");
+            break;
+        }
+    }
+
+    std::error_code ec;
+    auto bytes = std::filesystem::file_size(dataset.DatabaseFilePath, ec);
+    if (!ec) {
+        state.SetBytesProcessed(static_cast<int64_t>(bytes) * state.iterations());
+    }
+}
+BENCHMARK(BM_DatabaseBackup_Execute)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/*
+ The paced backup used by the backup dialog. The second argument is the number of pages copied per
+ step (-1 copies everything in one step), between steps the backup sleeps for the default interval.
+ "max_step_ms" is the longest time a single step held the source database, which is how long a
+ writer on another connection can be blocked.
+ */
+void BM_DatabaseBackup_ExecutePaced(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    const int pagesPerStep = static_cast<int>(state.range(1));
+    const int sleepMilliseconds = pagesPerStep > 0 ? svc::DatabaseBackup::DefaultStepSleepMilliseconds : 0;
+    double steps = 0;
+    double maxStepMilliseconds = 0;
+    for (auto _ : state) {
+        auto stepStart = std::chrono::steady_clock::now();
+        auto progressCallback = [&](int, int) {
+            auto now = std::chrono::steady_clock::now();
+            maxStepMilliseconds =
+                std::max(maxStepMilliseconds, std::chrono::duration<double, std::milli>(now - stepStart).count());
+            steps++;
+            /* the callback runs before the sleep, the next step starts once it is over */
+            stepStart = now + std::chrono::milliseconds(sleepMilliseconds);
+            return true;
+        };
+
+        svc::DatabaseBackup databaseBackup(BenchmarkEnvironment::Get().Logger());
+        if (!databaseBackup.Execute(pagesPerStep, sleepMilliseconds, progressCallback)) {
+            state.SkipWithError("DatabaseBackup::Execute failed");
+            break;
+        }
+    }
+
+    state.counters["steps"] = benchmark::Counter(steps, benchmark::Counter::kAvgIterations);
+    state.counters["max_step_ms"] = maxStepMilliseconds;
+
+    std::error_code ec;
+    auto bytes = std::filesystem::file_size(dataset.DatabaseFilePath, ec);
+    if (!ec) {
+        state.SetBytesProcessed(static_cast<int64_t>(bytes) * state.iterations());
+    }
+}
+BENCHMARK(BM_DatabaseBackup_ExecutePaced)
+    ->ArgsProduct({ { static_cast<int64_t>(DatasetScale::Huge) }, { -1, 256, 1024, 4096 } })
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3);
+
+void BM_BackupCompressor_Compress(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    const std::string compressedFilePath =
+        (std::filesystem::path(dataset.Directory) / "backups" / "benchmark.db.gz").string();
+    for (auto _ : state) {
+        svc::BackupCompressor backupCompressor(BenchmarkEnvironment::Get().Logger());
+        if (!backupCompressor.Compress(dataset.DatabaseFilePath, compressedFilePath)) {
+            state.SkipWithError("BackupCompressor::Compress failed");
+            break;
+        }
+    }
+
+    std::error_code ec;
+    auto bytes = std::filesystem::file_size(dataset.DatabaseFilePath, ec);
+    auto compressedBytes = std::filesystem::file_size(compressedFilePath, ec);
+    if (!ec) {
+        state.SetBytesProcessed(static_cast<int64_t>(bytes) * state.iterations());
+        state.counters["ratio"] = static_cast<double>(bytes) / static_cast<double>(compressedBytes);
+    }
+}
+BENCHMARK(BM_BackupCompressor_Compress)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+void BM_BackupCompressor_Decompress(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    const std::string compressedFilePath =
+        (std::filesystem::path(dataset.Directory) / "backups" / "benchmark.db.gz").string();
+    const std::string restoredFilePath = (std::filesystem::path(dataset.Directory) / "restored.db").string();
+
+    svc::BackupCompressor backupCompressor(BenchmarkEnvironment::Get().Logger());
+    if (!backupCompressor.Compress(dataset.DatabaseFilePath, compressedFilePath)) {
+        state.SkipWithError("BackupCompressor::Compress failed");
+        return;
+    }
+
+    for (auto _ : state) {
+        if (!backupCompressor.Decompress(compressedFilePath, restoredFilePath)) {
+            state.SkipWithError("BackupCompressor::Decompress failed");
+            break;
+        }
+    }
+
+    std::error_code ec;
+    auto bytes = std::filesystem::file_size(restoredFilePath, ec);
+    if (!ec) {
+        state.SetBytesProcessed(static_cast<int64_t>(bytes) * state.iterations());
+    }
+}
+BENCHMARK(BM_BackupCompressor_Decompress)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/* the steady state of incremental backups: every chunk of an unchanged database is already stored */
+void BM_BackupChunkStore_Store(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    const std::string backupDirectory = (std::filesystem::path(dataset.Directory) / "backups").string();
+    const std::string manifestFilePath = (std::filesystem::path(backupDirectory) / "benchmark.db.manifest").string();
+
+    svc::BackupChunkStore backupChunkStore(BenchmarkEnvironment::Get().Logger(), backupDirectory);
+    if (!backupChunkStore.Store(dataset.DatabaseFilePath, manifestFilePath)) {
+        state.SkipWithError("BackupChunkStore::Store failed");
+        return;
+    }
+
+    for (auto _ : state) {
+        if (!backupChunkStore.Store(dataset.DatabaseFilePath, manifestFilePath)) {
+            state.SkipWithError("BackupChunkStore::Store failed");
+            break;
+        }
+    }
+
+    std::error_code ec;
+    auto bytes = std::filesystem::file_size(dataset.DatabaseFilePath, ec);
+    auto manifestBytes = std::filesystem::file_size(manifestFilePath, ec);
+    if (!ec) {
+        state.SetBytesProcessed(static_cast<int64_t>(bytes) * state.iterations());
+        state.counters["manifest_bytes"] = static_cast<double>(manifestBytes);
+    }
+}
+BENCHMARK(BM_BackupChunkStore_Store)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/* every migration on a fresh copy of a version 0 database, then checks the result is the current schema */
+void BM_DatabaseMigrator_Execute(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    const std::string versionZeroFilePath = (std::filesystem::path(dataset.Directory) / "migration-v0.db").string();
+    if (!CreateVersionZeroDatabase(dataset.DatabaseFilePath, versionZeroFilePath, false)) {
+        state.SkipWithError("Failed to prepare the version 0 database");
+        return;
+    }
+
+    Dataset migrationDataset = dataset;
+    migrationDataset.DatabaseFilePath = (std::filesystem::path(dataset.Directory) / "migration.db").string();
+
+    for (auto _ : state) {
+        if (!RunMigration(state, migrationDataset, versionZeroFilePath, true)) {
+            break;
+        }
+    }
+    if (state.error_occurred()) {
+        return;
+    }
+
+    SchemaState schemaState{};
+    if (!ReadSchemaState(migrationDataset.DatabaseFilePath, schemaState)) {
+        state.SkipWithError("Failed to read the migrated schema");
+    } else if (schemaState.Version != svc::DatabaseMigrator::LatestVersion) {
+        state.SkipWithError("Migrated database is not at DatabaseMigrator::LatestVersion");
+    } else if (schemaState.HasProjectsHoursColumn) {
+        state.SkipWithError("Migrated projects table still has the hours column");
+    } else if (!schemaState.HasMeetingsTable) {
+        state.SkipWithError("Migrated database has no meetings table");
+    } else if (!schemaState.HasTaskItemsMeetingIdColumn) {
+        state.SkipWithError("Migrated task_items table has no meeting_id column");
+    }
+}
+BENCHMARK(BM_DatabaseMigrator_Execute)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/* the last migration fails, the earlier ones and user_version have to be rolled back with it */
+void BM_DatabaseMigrator_Rollback(benchmark::State& state)
+{
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    const std::string versionZeroFilePath =
+        (std::filesystem::path(dataset.Directory) / "migration-v0-failing.db").string();
+    if (!CreateVersionZeroDatabase(dataset.DatabaseFilePath, versionZeroFilePath, true)) {
+        state.SkipWithError("Failed to prepare the version 0 database");
+        return;
+    }
+
+    Dataset migrationDataset = dataset;
+    migrationDataset.DatabaseFilePath = (std::filesystem::path(dataset.Directory) / "migration.db").string();
+
+    for (auto _ : state) {
+        if (!RunMigration(state, migrationDataset, versionZeroFilePath, false)) {
+            break;
+        }
+    }
+    if (state.error_occurred()) {
+        return;
+    }
+
+    SchemaState schemaState{};
+    if (!ReadSchemaState(migrationDataset.DatabaseFilePath, schemaState)) {
+        state.SkipWithError("Failed to read the rolled back schema");
+    } else if (schemaState.Version != 0) {
+        state.SkipWithError("Rolled back database is not at version 0");
+    } else if (!schemaState.HasProjectsHoursColumn || schemaState.HasMeetingsTable ||
+               schemaState.HasTaskItemsMeetingIdColumn) {
+        state.SkipWithError("Rolled back database does not have the version 0 schema");
+    }
+}
+BENCHMARK(BM_DatabaseMigrator_Rollback)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/*
+ The data layer part of Application::OnInit: load the configuration, open the connection pool,
+ check the schema version and query what the main frame shows first.
+ */
+void BM_Startup(benchmark::State& state)
+{
+    static int ConnectionPoolSize = 14;
+
+    Dataset dataset;
+    if (!UseDataset(state, dataset)) {
+        return;
+    }
+
+    auto& environment = BenchmarkEnvironment::Get();
+    for (auto _ : state) {
+        if (!environment.InitializeConfiguration(dataset)) {
+            state.SkipWithError("Failed to initialize the configuration");
+            break;
+        }
+        environment.InitializeConnectionPool(dataset, ConnectionPoolSize);
+
+        svc::DatabaseMigrator databaseMigrator(environment.Logger());
+        if (!databaseMigrator.Execute()) {
+            state.SkipWithError("DatabaseMigrator::Execute failed");
+            break;
+        }
+
+        data::TaskItemData taskItemData;
+        auto taskItems = taskItemData.GetByDate(dataset.SampleDate);
+        auto hours = taskItemData.GetHours(dataset.SampleDate);
+        benchmark::DoNotOptimize(taskItems);
+        benchmark::DoNotOptimize(hours);
+    }
+}
+BENCHMARK(BM_Startup)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+} // namespace
+} // namespace app::benchmarks
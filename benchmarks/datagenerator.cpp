@@ -0,0 +1,512 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "datagenerator.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <sqlite3.h>
+
+#include "sqlscripts.h"
+
+#include "../src/common/constants.h"
+#include "../src/services/databasemigrator.h"
+
+namespace app::benchmarks
+{
+namespace
+{
+const char* Words[] = { "review", "fix", "meeting", "notes", "deploy", "build", "report", "client", "call", "design",
+    "refactor", "update", "database", "invoice", "planning", "support", "ticket", "feature", "test", "release",
+    "documentation", "analysis", "follow-up", "estimate", "prototype", "migration", "backlog", "retro", "demo",
+    "onboarding" };
+
+const char* Locations[] = { "Board Room", "Teams", "Zoom", "Office 3.1", "Client Site" };
+
+/* FNV-1a, only used to tell one version of the embedded scripts from another */
+std::uint32_t HashScript(const char* script, std::uint32_t hash = 2166136261u)
+{
+    for (; *script != '\0'; script++) {
+        hash = (hash ^ static_cast<unsigned char>(*script)) * 16777619u;
+    }
+    return hash;
+}
+
+/* Howard Hinnant's days_from_civil / civil_from_days */
+int DaysFromCivil(int year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int>(doe) - 719468;
+}
+
+void CivilFromDays(int days, int& year, unsigned& month, unsigned& day)
+{
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(yoe) + era * 400 + (month <= 2);
+}
+
+/* 0 = Monday ... 6 = Sunday, 1970-01-01 was a Thursday */
+int Weekday(int days)
+{
+    return ((days % 7) + 10) % 7;
+}
+
+std::string FormatTime(int secondsOfDay)
+{
+    char buffer[32];
+    std::snprintf(buffer,
+        sizeof(buffer),
+        "%02d:%02d:%02d",
+        secondsOfDay / 3600,
+        (secondsOfDay / 60) % 60,
+        secondsOfDay % 60);
+    return buffer;
+}
+
+struct Statement {
+    sqlite3_stmt* pStatement;
+
+    explicit Statement(sqlite3_stmt* statement)
+        : pStatement(statement)
+    {
+    }
+
+    ~Statement()
+    {
+        sqlite3_finalize(pStatement);
+    }
+
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+
+    void Bind(int index, std::int64_t value)
+    {
+        sqlite3_bind_int64(pStatement, index, value);
+    }
+
+    void Bind(int index, double value)
+    {
+        sqlite3_bind_double(pStatement, index, value);
+    }
+
+    void Bind(int index, const std::string& value)
+    {
+        sqlite3_bind_text(pStatement, index, value.c_str(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
+    }
+
+    void BindNull(int index)
+    {
+        sqlite3_bind_null(pStatement, index);
+    }
+
+    bool Step()
+    {
+        int rc = sqlite3_step(pStatement);
+        sqlite3_reset(pStatement);
+        sqlite3_clear_bindings(pStatement);
+        return rc == SQLITE_DONE;
+    }
+};
+} // namespace
+
+GeneratorOptions::GeneratorOptions()
+    : Years(1)
+    , Projects(10)
+    , CategoriesPerProject(4)
+    , EntriesPerDay(8)
+    , MeetingsPerDay(1)
+    , Seed(42)
+    , StartDate("2016-01-04")
+{
+}
+
+/*
+ Also names the cached dataset directory, so it includes the schema version and a hash of the embedded
+ scripts: a schema change must not reuse a database generated from the previous scripts
+ */
+std::string GeneratorOptions::Describe() const
+{
+    const std::uint32_t scriptsHash = HashScript(scripts::SeedTaskable, HashScript(scripts::CreateTaskable));
+
+    char buffer[128];
+    std::snprintf(buffer,
+        sizeof(buffer),
+        "y%d-p%d-c%d-e%d-m%d-s%u-v%d-%08x",
+        Years,
+        Projects,
+        CategoriesPerProject,
+        EntriesPerDay,
+        MeetingsPerDay,
+        Seed,
+        svc::DatabaseMigrator::LatestVersion,
+        scriptsHash);
+    return buffer;
+}
+
+DataGenerator::DataGenerator(std::shared_ptr<spdlog::logger> logger, const GeneratorOptions& options)
+    : pLogger(logger)
+    , mOptions(options)
+    , mRandom(options.Seed)
+    , pDatabase(nullptr)
+    , mProjects()
+{
+}
+
+DataGenerator::~DataGenerator()
+{
+    if (pDatabase != nullptr) {
+        sqlite3_close(pDatabase);
+    }
+}
+
+bool DataGenerator::Generate(const std::string& databaseFilePath, GeneratorSummary& summary)
+{
+    summary = GeneratorSummary{ 0, 0, 0, "", "" };
+
+    std::remove(databaseFilePath.c_str());
+
+    int rc = sqlite3_open_v2(
+        databaseFilePath.c_str(), &pDatabase, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    if (rc != SQLITE_OK) {
+        pLogger->error("Failed to create database {0} - {1:d} : {2}", databaseFilePath, rc, sqlite3_errstr(rc));
+        return false;
+    }
+
+    if (!Execute(scripts::CreateTaskable) || !Execute(scripts::SeedTaskable)) {
+        return false;
+    }
+
+    /* nothing needs to survive a crash half way through, so skip the journal while bulk loading */
+    if (!Execute("PRAGMA journal_mode = OFF") || !Execute("PRAGMA synchronous = OFF") || !Execute("BEGIN")) {
+        return false;
+    }
+
+    if (!InsertEntities() || !InsertDays(summary)) {
+        Execute("ROLLBACK");
+        return false;
+    }
+
+    if (!Execute("COMMIT") || !Execute("PRAGMA journal_mode = DELETE") || !Execute("ANALYZE")) {
+        return false;
+    }
+
+    sqlite3_close(pDatabase);
+    pDatabase = nullptr;
+
+    pLogger->info("Generated {0} ({1}) : {2:d} tasks, {3:d} task items, {4:d} meetings from {5} to {6}",
+        databaseFilePath,
+        mOptions.Describe(),
+        summary.Tasks,
+        summary.TaskItems,
+        summary.Meetings,
+        summary.FirstDate,
+        summary.LastDate);
+    return true;
+}
+
+bool DataGenerator::Execute(const std::string& sql)
+{
+    char* errorMessage = nullptr;
+    int rc = sqlite3_exec(pDatabase, sql.c_str(), nullptr, nullptr, &errorMessage);
+    if (rc != SQLITE_OK) {
+        pLogger->error("Error occured in DataGenerator::Execute() - {0:d} : {1}",
+            rc,
+            errorMessage != nullptr ? errorMessage : sqlite3_errstr(rc));
+        sqlite3_free(errorMessage);
+        return false;
+    }
+    return true;
+}
+
+sqlite3_stmt* DataGenerator::Prepare(const std::string& sql)
+{
+    sqlite3_stmt* statement = nullptr;
+    int rc = sqlite3_prepare_v2(pDatabase, sql.c_str(), static_cast<int>(sql.size()), &statement, nullptr);
+    if (rc != SQLITE_OK) {
+        pLogger->error("Error occured in DataGenerator::Prepare() - {0:d} : {1}", rc, sqlite3_errmsg(pDatabase));
+        return nullptr;
+    }
+    return statement;
+}
+
+bool DataGenerator::InsertEntities()
+{
+    const int employerCount = std::max(1, mOptions.Projects / 10);
+    const int clientCount = std::max(1, mOptions.Projects / 3);
+
+    Statement employer(Prepare("INSERT INTO employers (name, is_active) VALUES (?, 1)"));
+    Statement client(Prepare("INSERT INTO clients (name, is_active, employer_id) VALUES (?, 1, ?)"));
+    Statement project(Prepare("INSERT INTO projects "
+                              "(name, display_name, billable, rate, is_default, is_active, "
+                              "employer_id, client_id, rate_type_id, currency_id) "
+                              "VALUES (?, ?, ?, ?, 0, 1, ?, ?, ?, ?)"));
+    Statement category(Prepare("INSERT INTO categories (name, color, is_active, project_id) VALUES (?, ?, 1, ?)"));
+    if (!employer.pStatement || !client.pStatement || !project.pStatement || !category.pStatement) {
+        return false;
+    }
+
+    for (int i = 1; i <= employerCount; i++) {
+        employer.Bind(1, "Employer " + std::to_string(i));
+        if (!employer.Step()) {
+            return false;
+        }
+    }
+
+    for (int i = 1; i <= clientCount; i++) {
+        client.Bind(1, "Client " + std::to_string(i));
+        client.Bind(2, static_cast<std::int64_t>(1 + (i - 1) % employerCount));
+        if (!client.Step()) {
+            return false;
+        }
+    }
+
+    std::uniform_real_distribution<double> rateDistribution(25.0, 150.0);
+    std::uniform_int_distribution<std::int64_t> colorDistribution(0, 0xFFFFFF);
+
+    for (int i = 1; i <= mOptions.Projects; i++) {
+        Project generatedProject{ i, i % 2 == 1, 0.0, {} };
+        const std::string name = "Project " + std::to_string(i);
+
+        project.Bind(1, name);
+        project.Bind(2, name);
+        project.Bind(3, static_cast<std::int64_t>(generatedProject.Billable));
+        if (generatedProject.Billable) {
+            generatedProject.Rate = static_cast<int>(rateDistribution(mRandom));
+            project.Bind(4, generatedProject.Rate);
+        } else {
+            project.BindNull(4);
+        }
+        project.Bind(5, static_cast<std::int64_t>(1 + (i - 1) % employerCount));
+        /* every fourth project has no client */
+        if (i % 4 == 0) {
+            project.BindNull(6);
+        } else {
+            project.Bind(6, static_cast<std::int64_t>(1 + (i - 1) % clientCount));
+        }
+        if (generatedProject.Billable) {
+            project.Bind(7, static_cast<std::int64_t>(constants::RateTypes::Hourly));
+            project.Bind(8, static_cast<std::int64_t>(2));
+        } else {
+            project.BindNull(7);
+            project.BindNull(8);
+        }
+        if (!project.Step()) {
+            return false;
+        }
+
+        for (int c = 1; c <= mOptions.CategoriesPerProject; c++) {
+            category.Bind(1, "Category " + std::to_string(i) + "." + std::to_string(c));
+            category.Bind(2, colorDistribution(mRandom));
+            category.Bind(3, generatedProject.ProjectId);
+            if (!category.Step()) {
+                return false;
+            }
+            generatedProject.CategoryIds.push_back(sqlite3_last_insert_rowid(pDatabase));
+        }
+
+        mProjects.push_back(std::move(generatedProject));
+    }
+
+    return true;
+}
+
+bool DataGenerator::InsertDays(GeneratorSummary& summary)
+{
+    int startDay = 0;
+    if (!ParseIsoDate(mOptions.StartDate, startDay)) {
+        pLogger->error("Invalid start date {0}", mOptions.StartDate);
+        return false;
+    }
+
+    Statement task(Prepare("INSERT INTO tasks (task_date, is_active) VALUES (?, 1)"));
+    Statement meeting(Prepare("INSERT INTO meetings "
+                              "(attended, duration, starting, ending, location, subject, body, is_active, task_id) "
+                              "VALUES (?, ?, ?, ?, ?, ?, ?, 1, ?)"));
+    Statement taskItem(Prepare("INSERT INTO task_items "
+                               "(start_time, end_time, duration, description, billable, calculated_rate, is_active, "
+                               "task_item_type_id, project_id, task_id, category_id, meeting_id) "
+                               "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
+    if (!task.pStatement || !meeting.pStatement || !taskItem.pStatement) {
+        return false;
+    }
+
+    std::uniform_int_distribution<int> projectDistribution(0, static_cast<int>(mProjects.size()) - 1);
+    std::uniform_int_distribution<int> entriesJitter(-mOptions.EntriesPerDay / 4, mOptions.EntriesPerDay / 4);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    const int dayCount = mOptions.Years * 365;
+    for (int day = startDay; day < startDay + dayCount; day++) {
+        /* only working days have entries */
+        if (Weekday(day) >= 5) {
+            continue;
+        }
+
+        const std::string taskDate = FormatIsoDate(day);
+        task.Bind(1, taskDate);
+        if (!task.Step()) {
+            return false;
+        }
+        const std::int64_t taskId = sqlite3_last_insert_rowid(pDatabase);
+
+        if (summary.FirstDate.empty()) {
+            summary.FirstDate = taskDate;
+        }
+        summary.LastDate = taskDate;
+        summary.Tasks++;
+
+        const int entries = std::max(1, mOptions.EntriesPerDay + entriesJitter(mRandom));
+        /* keep the whole day between 08:00 and midnight */
+        std::uniform_int_distribution<int> durationMinutes(1, std::max(2, std::min(90, 15 * 60 / entries)));
+        int secondsOfDay = 8 * 3600;
+
+        for (int entry = 0; entry < entries; entry++) {
+            const Project& project = mProjects[projectDistribution(mRandom)];
+            std::uniform_int_distribution<std::size_t> categoryDistribution(0, project.CategoryIds.size() - 1);
+
+            const int seconds = durationMinutes(mRandom) * 60 + percent(mRandom) % 60;
+            if (secondsOfDay + seconds >= 24 * 3600) {
+                break;
+            }
+
+            const bool isMeeting = entry < mOptions.MeetingsPerDay;
+            const bool isTimed = isMeeting || percent(mRandom) < 70;
+
+            std::int64_t meetingId = 0;
+            if (isMeeting) {
+                meeting.Bind(1, static_cast<std::int64_t>(percent(mRandom) < 90));
+                meeting.Bind(2, static_cast<std::int64_t>(seconds / 60));
+                meeting.Bind(3, taskDate + "T" + FormatTime(secondsOfDay));
+                meeting.Bind(4, taskDate + "T" + FormatTime(secondsOfDay + seconds));
+                meeting.Bind(5, std::string(Locations[percent(mRandom) % (sizeof(Locations) / sizeof(Locations[0]))]));
+                meeting.Bind(6, "Sync " + CreateDescription());
+                meeting.Bind(7, CreateDescription() + "\n" + CreateDescription());
+                meeting.Bind(8, taskId);
+                if (!meeting.Step()) {
+                    return false;
+                }
+                meetingId = sqlite3_last_insert_rowid(pDatabase);
+                summary.Meetings++;
+            }
+
+            if (isTimed) {
+                taskItem.Bind(1, FormatTime(secondsOfDay));
+                taskItem.Bind(2, FormatTime(secondsOfDay + seconds));
+            } else {
+                taskItem.BindNull(1);
+                taskItem.BindNull(2);
+            }
+            taskItem.Bind(3, FormatTime(seconds));
+            taskItem.Bind(4, CreateDescription());
+            taskItem.Bind(5, static_cast<std::int64_t>(project.Billable));
+            if (project.Billable) {
+                taskItem.Bind(6, project.Rate * seconds / 3600.0);
+            } else {
+                taskItem.BindNull(6);
+            }
+            /* a small share of entries are soft deleted */
+            taskItem.Bind(7, static_cast<std::int64_t>(percent(mRandom) >= 2));
+            taskItem.Bind(8,
+                static_cast<std::int64_t>(isTimed ? constants::TaskItemTypes::TimedTask
+                                                  : constants::TaskItemTypes::EntryTask));
+            taskItem.Bind(9, project.ProjectId);
+            taskItem.Bind(10, taskId);
+            taskItem.Bind(11, project.CategoryIds[categoryDistribution(mRandom)]);
+            if (isMeeting) {
+                taskItem.Bind(12, meetingId);
+            } else {
+                taskItem.BindNull(12);
+            }
+            if (!taskItem.Step()) {
+                pLogger->error("Error occured in DataGenerator::InsertDays() : {0}", sqlite3_errmsg(pDatabase));
+                return false;
+            }
+
+            summary.TaskItems++;
+            secondsOfDay += seconds;
+        }
+    }
+
+    return true;
+}
+
+/*
+ Short descriptions of random words. Some contain commas, quotes or line breaks so exports
+ exercise their escaping paths the way real user input does.
+ */
+std::string DataGenerator::CreateDescription()
+{
+    std::uniform_int_distribution<int> wordCount(3, 12);
+    std::uniform_int_distribution<std::size_t> wordIndex(0, sizeof(Words) / sizeof(Words[0]) - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::string description;
+    const int words = wordCount(mRandom);
+    for (int i = 0; i < words; i++) {
+        if (i > 0) {
+            int punctuation = percent(mRandom);
+            description += punctuation < 3 ? ", " : (punctuation < 4 ? "\n" : " ");
+        }
+        description += Words[wordIndex(mRandom)];
+    }
+
+    if (percent(mRandom) < 2) {
+        description += " \"urgent\"";
+    }
+
+    return description;
+}
+
+std::string FormatIsoDate(int daysSinceEpoch)
+{
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    CivilFromDays(daysSinceEpoch, year, month, day);
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", year, month, day);
+    return buffer;
+}
+
+bool ParseIsoDate(const std::string& date, int& daysSinceEpoch)
+{
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    if (std::sscanf(date.c_str(), "%4d-%2u-%2u", &year, &month, &day) != 3 || month < 1 || month > 12 || day < 1 ||
+        day > 31) {
+        return false;
+    }
+
+    daysSinceEpoch = DaysFromCivil(year, month, day);
+    return true;
+}
+} // namespace app::benchmarks
@@ -0,0 +1,97 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace app::benchmarks
+{
+struct GeneratorOptions {
+    int Years;
+    int Projects;
+    int CategoriesPerProject;
+    int EntriesPerDay;
+    int MeetingsPerDay;
+    unsigned int Seed;
+    /* first (Monday) date of the generated range in ISO format */
+    std::string StartDate;
+
+    GeneratorOptions();
+    std::string Describe() const;
+};
+
+struct GeneratorSummary {
+    std::int64_t Tasks;
+    std::int64_t TaskItems;
+    std::int64_t Meetings;
+    std::string FirstDate;
+    std::string LastDate;
+};
+
+/*
+ Creates a database with the real schema and seed data (the scripts embedded in taskable_core) and fills it
+ with deterministic (seeded) synthetic data: employers, clients, projects with categories, one
+ task per working day, a varying number of timed and entry task items per day and meetings
+ linked to task items. Everything is inserted with prepared statements in a single transaction.
+ */
+class DataGenerator final
+{
+public:
+    DataGenerator() = delete;
+    DataGenerator(std::shared_ptr<spdlog::logger> logger, const GeneratorOptions& options);
+    ~DataGenerator();
+
+    bool Generate(const std::string& databaseFilePath, GeneratorSummary& summary);
+
+private:
+    bool Execute(const std::string& sql);
+    sqlite3_stmt* Prepare(const std::string& sql);
+
+    bool InsertEntities();
+    bool InsertDays(GeneratorSummary& summary);
+    std::string CreateDescription();
+
+    struct Project {
+        std::int64_t ProjectId;
+        bool Billable;
+        double Rate;
+        std::vector<std::int64_t> CategoryIds;
+    };
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    GeneratorOptions mOptions;
+    std::mt19937 mRandom;
+    sqlite3* pDatabase;
+    std::vector<Project> mProjects;
+};
+
+std::string FormatIsoDate(int daysSinceEpoch);
+
+bool ParseIsoDate(const std::string& date, int& daysSinceEpoch);
+} // namespace app::benchmarks
@@ -0,0 +1,204 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/services/csvwriter.h"
+
+namespace app::benchmarks
+{
+namespace
+{
+using Row = std::vector<std::string>;
+
+const int CorpusRows = 20000;
+const int FieldsPerRow = 6;
+
+/*
+ Random rows weighted towards the bytes the writer has to care about: delimiters, quotes, CR and LF land
+ anywhere in a field, including the very first and last byte of a wide scan block. Field lengths straddle
+ the 8 and 16 byte scan widths. The seed is fixed so a failure can be reproduced.
+ */
+std::vector<Row> CreateFuzzedCorpus(char delimiter)
+{
+    const char specialBytes[] = { delimiter, '"', '\n', '\r' };
+
+    std::mt19937 generator(20201019);
+    std::uniform_int_distribution<int> lengthDistribution(0, 70);
+    std::uniform_int_distribution<int> kindDistribution(0, 99);
+    std::uniform_int_distribution<int> specialDistribution(0, 3);
+    std::uniform_int_distribution<int> byteDistribution(0, 255);
+
+    std::vector<Row> corpus(CorpusRows);
+    for (auto& row : corpus) {
+        for (int i = 0; i < FieldsPerRow; i++) {
+            std::string field(static_cast<std::size_t>(lengthDistribution(generator)), 'a');
+            for (auto& byte : field) {
+                int kind = kindDistribution(generator);
+                if (kind < 3) {
+                    byte = specialBytes[specialDistribution(generator)];
+                } else if (kind < 20) {
+                    byte = static_cast<char>(byteDistribution(generator));
+                } else {
+                    byte = static_cast<char>('a' + kind % 26);
+                }
+            }
+
+            /* about half of the rows have nothing to escape, as in a real export */
+            if (kindDistribution(generator) < 50) {
+                for (auto& byte : field) {
+                    for (char special : specialBytes) {
+                        if (byte == special) {
+                            byte = '_';
+                        }
+                    }
+                }
+            }
+            row.push_back(std::move(field));
+        }
+    }
+    return corpus;
+}
+
+/* a deliberately simple RFC 4180 reader, independent of the writer's scanning code */
+bool ParseCsv(const std::string& text, char delimiter, std::vector<Row>& rows)
+{
+    Row row;
+    std::string field;
+    std::size_t i = 0;
+
+    while (i < text.size()) {
+        if (text[i] == '"') {
+            i++;
+            while (true) {
+                if (i >= text.size()) {
+                    return false;
+                }
+                if (text[i] == '"') {
+                    if (i + 1 < text.size() && text[i + 1] == '"') {
+                        field.push_back('"');
+                        i += 2;
+                        continue;
+                    }
+                    i++;
+                    break;
+                }
+                field.push_back(text[i++]);
+            }
+        } else {
+            while (i < text.size() && text[i] != delimiter && text[i] != '\n') {
+                if (text[i] == '"' || text[i] == '\r') {
+                    /* an unquoted field must never contain these */
+                    return false;
+                }
+                field.push_back(text[i++]);
+            }
+        }
+
+        if (i >= text.size()) {
+            return false;
+        }
+
+        row.push_back(std::move(field));
+        field.clear();
+        if (text[i] == '\n') {
+            rows.push_back(std::move(row));
+            row.clear();
+        } else if (text[i] != delimiter) {
+            return false;
+        }
+        i++;
+    }
+
+    return row.empty();
+}
+
+bool NaiveRequiresQuoting(const std::string& value, char delimiter)
+{
+    for (char byte : value) {
+        if (byte == delimiter || byte == '"' || byte == '\n' || byte == '\r') {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string WriteCorpus(const std::vector<Row>& corpus, char delimiter)
+{
+    std::ostringstream output;
+    svc::CsvWriter writer(output, delimiter);
+    for (const auto& row : corpus) {
+        for (const auto& field : row) {
+            writer.WriteField(field);
+        }
+        writer.EndRow();
+    }
+    return output.str();
+}
+
+/*
+ Escapes a fuzzed corpus with CsvWriter. Before timing, every field's RequiresQuoting result is checked
+ against a byte by byte scan and the written text is parsed back and compared with the corpus, so a
+ broken SSE2 or SWAR path fails the run instead of producing a number. The argument is the delimiter.
+ */
+void BM_CsvWriter_FuzzedCorpus(benchmark::State& state)
+{
+    const char delimiter = static_cast<char>(state.range(0));
+    const std::vector<Row> corpus = CreateFuzzedCorpus(delimiter);
+
+    std::ostringstream unused;
+    svc::CsvWriter writer(unused, delimiter);
+    for (const auto& row : corpus) {
+        for (const auto& field : row) {
+            /* every offset, so the special byte is found at every position of a scan block */
+            for (std::size_t offset = 0; offset < field.size() && offset < 17; offset++) {
+                std::string tail = field.substr(offset);
+                if (writer.RequiresQuoting(tail.data(), tail.size()) != NaiveRequiresQuoting(tail, delimiter)) {
+                    state.SkipWithError("CsvWriter::RequiresQuoting disagrees with a byte by byte scan");
+                    return;
+                }
+            }
+        }
+    }
+
+    std::vector<Row> parsedRows;
+    if (!ParseCsv(WriteCorpus(corpus, delimiter), delimiter, parsedRows) || parsedRows != corpus) {
+        state.SkipWithError("CsvWriter output does not parse back to the original fields");
+        return;
+    }
+
+    std::size_t bytesWritten = 0;
+    for (auto _ : state) {
+        std::string text = WriteCorpus(corpus, delimiter);
+        bytesWritten += text.size();
+        benchmark::DoNotOptimize(text.data());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytesWritten));
+    state.counters["rows"] = CorpusRows;
+}
+BENCHMARK(BM_CsvWriter_FuzzedCorpus)->Arg(',')->Arg(';')->Unit(benchmark::kMillisecond);
+} // namespace
+} // namespace app::benchmarks
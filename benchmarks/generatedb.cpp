@@ -0,0 +1,121 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include "datagenerator.h"
+
+namespace
+{
+void PrintUsage()
+{
+    std::cerr << "Usage: taskable-datagen --output <file> [options]\n"
+              << "  --years <n>        number of years of data (default 1)\n"
+              << "  --projects <n>     number of projects (default 10)\n"
+              << "  --categories <n>   categories per project (default 4)\n"
+              << "  --entries <n>      average task items per working day (default 8)\n"
+              << "  --meetings <n>     meetings per working day (default 1)\n"
+              << "  --seed <n>         random seed (default 42)\n"
+              << "  --start <date>     first date of the range (default 2016-01-04)\n";
+}
+
+bool ParseCount(const char* value, int& count)
+{
+    char* end = nullptr;
+    long parsed = std::strtol(value, &end, 10);
+    if (end == value || *end != '\0' || parsed < 0 || parsed > 100000) {
+        return false;
+    }
+    count = static_cast<int>(parsed);
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto logger = spdlog::stderr_color_st("datagen");
+
+    app::benchmarks::GeneratorOptions options;
+    std::string outputFilePath;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "-h" || argument == "--help") {
+            PrintUsage();
+            return EXIT_SUCCESS;
+        }
+        if (i + 1 >= argc) {
+            PrintUsage();
+            return 2;
+        }
+
+        const char* value = argv[++i];
+        int seed = 0;
+        bool valid = true;
+        if (argument == "--output") {
+            outputFilePath = value;
+        } else if (argument == "--years") {
+            valid = ParseCount(value, options.Years);
+        } else if (argument == "--projects") {
+            valid = ParseCount(value, options.Projects) && options.Projects > 0;
+        } else if (argument == "--categories") {
+            valid = ParseCount(value, options.CategoriesPerProject) && options.CategoriesPerProject > 0;
+        } else if (argument == "--entries") {
+            valid = ParseCount(value, options.EntriesPerDay) && options.EntriesPerDay > 0;
+        } else if (argument == "--meetings") {
+            valid = ParseCount(value, options.MeetingsPerDay);
+        } else if (argument == "--seed") {
+            valid = ParseCount(value, seed);
+            options.Seed = static_cast<unsigned int>(seed);
+        } else if (argument == "--start") {
+            int days = 0;
+            valid = app::benchmarks::ParseIsoDate(value, days);
+            options.StartDate = value;
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value \"" << value << "\" for " << argument << "\n";
+            return 2;
+        }
+    }
+
+    if (outputFilePath.empty()) {
+        PrintUsage();
+        return 2;
+    }
+
+    app::benchmarks::GeneratorSummary summary;
+    app::benchmarks::DataGenerator generator(logger, options);
+    if (!generator.Generate(outputFilePath, summary)) {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "tasks:      " << summary.Tasks << "\n"
+              << "task items: " << summary.TaskItems << "\n"
+              << "meetings:   " << summary.Meetings << "\n"
+              << "range:      " << summary.FirstDate << " - " << summary.LastDate << "\n";
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/common/instancechannel.h"
+
+#include "benchmarkenvironment.h"
+
+namespace app::benchmarks
+{
+namespace
+{
+/* next to the application's own socket, the channel only listens in a directory private to the user */
+std::string GetBenchmarkSocketPath(const std::string& fileName)
+{
+    auto directory = std::filesystem::path(common::InstanceChannel::GetDefaultSocketPath()).parent_path();
+    return (directory / fileName).string();
+}
+
+/*
+ What a second launch pays before it exits: connect to the running instance's socket, write the command
+ and wait for the acknowledgement. The listening side only counts the commands, like the application
+ which hands them over to the UI thread before it acknowledges.
+ */
+void BM_InstanceChannel_Forward(benchmark::State& state)
+{
+    std::string socketPath = GetBenchmarkSocketPath("taskable-benchmarks.sock");
+
+    std::atomic<int> received(0);
+    common::InstanceChannel instanceChannel(BenchmarkEnvironment::Get().Logger(), socketPath);
+    if (!instanceChannel.Listen([&received](common::InstanceCommands) { received++; })) {
+        state.SkipWithError("Failed to listen on the instance channel socket");
+        return;
+    }
+
+    for (auto _ : state) {
+        if (!common::InstanceChannel::Forward(socketPath, common::InstanceCommands::Show)) {
+            state.SkipWithError("InstanceChannel::Forward failed");
+            break;
+        }
+    }
+
+    instanceChannel.Close();
+    state.counters["received"] = static_cast<double>(received.load());
+}
+BENCHMARK(BM_InstanceChannel_Forward)->Unit(benchmark::kMicrosecond);
+
+/* a launch when no instance is running, this is the cost added in front of a normal startup */
+void BM_InstanceChannel_ForwardNotRunning(benchmark::State& state)
+{
+    std::string socketPath = GetBenchmarkSocketPath("taskable-benchmarks-none.sock");
+
+    for (auto _ : state) {
+        bool forwarded = common::InstanceChannel::Forward(socketPath, common::InstanceCommands::Show);
+        benchmark::DoNotOptimize(forwarded);
+    }
+}
+BENCHMARK(BM_InstanceChannel_ForwardNotRunning)->Unit(benchmark::kMicrosecond);
+} // namespace
+} // namespace app::benchmarks
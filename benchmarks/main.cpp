@@ -0,0 +1,65 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <wx/init.h>
+
+#include "../src/common/version.h"
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer(argc, argv);
+    if (!initializer.IsOk()) {
+        std::fprintf(stderr, "Failed to initialize the wxWidgets library\n");
+        return EXIT_FAILURE;
+    }
+
+    /* write JSON results next to the console report unless the caller chose an output file */
+    std::vector<char*> arguments(argv, argv + argc);
+    bool outputRequested = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0) {
+            outputRequested = true;
+        }
+    }
+
+    std::string outputArgument = "--benchmark_out=taskable-benchmarks.json";
+    std::string formatArgument = "--benchmark_out_format=json";
+    if (!outputRequested) {
+        arguments.push_back(outputArgument.data());
+        arguments.push_back(formatArgument.data());
+    }
+
+    int argumentCount = static_cast<int>(arguments.size());
+    benchmark::AddCustomContext("taskable_version", FILE_VERSION_STR);
+    benchmark::Initialize(&argumentCount, arguments.data());
+    if (benchmark::ReportUnrecognizedArguments(argumentCount, arguments.data())) {
+        return EXIT_FAILURE;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+# Embeds SQL scripts into a generated C++ header so the application does not have to find them on disk.
+# Runs in script mode from an add_custom_command:
+#   cmake -DOUTPUT=<header> -DSCRIPT_NAMES=<Name,...> -DSCRIPT_FILES=<path,...> -P EmbedSqlScripts.cmake
+# Every script becomes a null terminated string that can be handed to sqlite3_exec as is, written as
+# hex escapes so any byte (UTF-8 currency symbols, line endings) survives unchanged.
+
+string (REPLACE "," ";" SCRIPT_NAMES "${SCRIPT_NAMES}")
+string (REPLACE "," ";" SCRIPT_FILES "${SCRIPT_FILES}")
+
+set (BYTES_PER_LINE 16)
+math (EXPR HEX_CHARACTERS_PER_LINE "${BYTES_PER_LINE} * 2")
+
+set (CONTENT "// Generated by cmake/EmbedSqlScripts.cmake from the scripts directory, do not edit\n\n")
+string (APPEND CONTENT "#pragma once\n\nnamespace app::scripts\n{\n")
+
+list (LENGTH SCRIPT_NAMES SCRIPT_COUNT)
+math (EXPR LAST_SCRIPT "${SCRIPT_COUNT} - 1")
+foreach (SCRIPT_INDEX RANGE ${LAST_SCRIPT})
+    list (GET SCRIPT_NAMES ${SCRIPT_INDEX} SCRIPT_NAME)
+    list (GET SCRIPT_FILES ${SCRIPT_INDEX} SCRIPT_FILE)
+    get_filename_component (SCRIPT_FILE_NAME "${SCRIPT_FILE}" NAME)
+
+    file (READ "${SCRIPT_FILE}" HEX_CONTENT HEX)
+    string (LENGTH "${HEX_CONTENT}" HEX_LENGTH)
+
+    string (APPEND CONTENT "/* ${SCRIPT_FILE_NAME} */\ninline constexpr char ${SCRIPT_NAME}[] =\n")
+    set (OFFSET 0)
+    while (OFFSET LESS HEX_LENGTH)
+        string (SUBSTRING "${HEX_CONTENT}" ${OFFSET} ${HEX_CHARACTERS_PER_LINE} LINE)
+        string (REGEX REPLACE "([0-9a-f][0-9a-f])" "\\\\x\\1" LINE "${LINE}")
+        string (APPEND CONTENT "    \"${LINE}\"\n")
+        math (EXPR OFFSET "${OFFSET} + ${HEX_CHARACTERS_PER_LINE}")
+    endwhile ()
+    string (APPEND CONTENT "    \"\";\n\n")
+endforeach ()
+
+string (APPEND CONTENT "} // namespace app::scripts\n")
+
+# only rewrite the header when a script changed, so its dependents are not rebuilt for nothing
+set (PREVIOUS_CONTENT "")
+if (EXISTS "${OUTPUT}")
+    file (READ "${OUTPUT}" PREVIOUS_CONTENT)
+endif ()
+
+if (NOT "${CONTENT}" STREQUAL "${PREVIOUS_CONTENT}")
+    file (WRITE "${OUTPUT}" "${CONTENT}")
+endif ()
@@ -1,3 +1,6 @@
+PRAGMA auto_vacuum = INCREMENTAL;
+PRAGMA user_version = 3;
+
 CREATE TABLE employers
 (
     employer_id INTEGER PRIMARY KEY NOT NULL,
@@ -22,11 +22,14 @@
 #include <algorithm>
 
 #include <wx/file.h>
+#include <wx/filename.h>
 #include <wx/stdpaths.h>
 #include <wx/msw/registry.h>
 
 #include "common/common.h"
 #include "common/constants.h"
+#include "common/perflog.h"
+#include "common/tracer.h"
 #include "config/configurationprovider.h"
 #include "database/sqliteconnectionfactory.h"
 #include "database/sqliteconnection.h"
@@ -34,7 +37,7 @@
 #include "frame/mainframe.h"
 #include "services/setupdatabase.h"
 #include "services/databasebackup.h"
-#include "services/databasestructureupdater.h"
+#include "services/databasemigrator.h"
 #include "wizards/setupwizard.h"
 #include "wizards/databaserestorewizard.h"
 
@@ -42,14 +45,27 @@ namespace app
 {
 Application::Application()
     : pInstanceChecker(std::make_unique<wxSingleInstanceChecker>())
+    , pInstanceChannel(nullptr)
+    , pConfigurationWatcher(nullptr)
+    , mConfigurationSubscription(0)
 {
 }
 
 bool Application::OnInit()
 {
+    InitializeTracing();
+    common::TraceSpan traceSpan("Application::OnInit");
+
 #ifndef TASKABLE_DEBUG
+    /* without a name the checker holds no lock and never sees another instance */
+    pInstanceChecker->CreateDefault();
     bool isInstanceAlreadyRunning = pInstanceChecker->IsAnotherRunning();
     if (isInstanceAlreadyRunning) {
+        /* the running instance was still starting up when main tried to forward the command */
+        if (common::InstanceChannel::Forward(common::GetLaunchCommand(argc, argv))) {
+            return false;
+        }
+
         wxMessageBox(wxT("Another instance of the application is already running."),
             common::GetProgramName(),
             wxOK_DEFAULT | wxICON_WARNING);
@@ -61,6 +77,9 @@ bool Application::OnInit()
         return false;
     }
 
+    /* listen before the slow startup work so later launches do not find this instance deaf and start a second one */
+    StartInstanceChannel();
+
     if (!ConfigurationFileExists()) {
         return false;
     }
@@ -75,16 +94,69 @@ bool Application::OnInit()
         }
     }
 
+    mConfigurationSubscription = cfg::ConfigurationProvider::Get().Subscribe(
+        [this](const cfg::ConfigurationChanges& changes) { OnConfigurationChanged(changes); });
+
     auto frame = new frm::MainFrame(pLogger);
     frame->CreateFrame();
-    frame->Show(true);
+    {
+        common::TraceSpan showTraceSpan("MainFrame::Show");
+        frame->Show(true);
+    }
     SetTopWindow(frame);
 
+    /* the first launch runs its own command before the ones forwarded while the frame did not exist yet */
+    auto launchCommand = common::GetLaunchCommand(argc, argv);
+    if (launchCommand != common::InstanceCommands::Show) {
+        mPendingInstanceCommands.insert(mPendingInstanceCommands.begin(), launchCommand);
+    }
+    for (auto command : mPendingInstanceCommands) {
+        CallAfter([this, command]() { OnInstanceCommand(command); });
+    }
+    mPendingInstanceCommands.clear();
+
     return true;
 }
 
+int Application::OnExit()
+{
+    pInstanceChannel.reset();
+    pConfigurationWatcher.reset();
+    cfg::ConfigurationProvider::Get().Unsubscribe(mConfigurationSubscription);
+
+    /* the main frame saves its size while being destroyed, make sure that write lands before we go */
+    if (!cfg::ConfigurationProvider::Get().Configuration->Flush()) {
+        pLogger->error("Unable to write configuration file");
+    }
+
+    if (common::Tracer::Get().IsEnabled()) {
+        if (common::Tracer::Get().Write()) {
+            pLogger->info("Trace written to {0}", common::Tracer::Get().GetTraceFilePath());
+        } else {
+            pLogger->error("Unable to write trace to {0}", common::Tracer::Get().GetTraceFilePath());
+        }
+    }
+
+    /* drains the queued messages and stops the logging threads */
+    spdlog::shutdown();
+
+    return wxApp::OnExit();
+}
+
+void Application::OnEventLoopEnter(wxEventLoopBase* loop)
+{
+    /* the watcher needs a running event loop, nested modal loops during OnInit are not the main loop */
+    if (loop->IsMain() && pConfigurationWatcher == nullptr) {
+        StartConfigurationWatcher();
+    }
+
+    wxApp::OnEventLoopEnter(loop);
+}
+
 bool Application::FirstStartupInitialization()
 {
+    common::TraceSpan traceSpan("Application::FirstStartupInitialization");
+
     if (!CreateDatabaseFile()) {
         return false;
     }
@@ -110,58 +182,95 @@ bool Application::FirstStartupInitialization()
 
 bool Application::StartupInitialization()
 {
+    common::TraceSpan traceSpan("Application::StartupInitialization");
+
     if (!DatabaseFileExists()) {
         return false;
     } else {
         InitializeDatabaseConnectionProvider();
     }
 
-    if (CheckForDatabaseUpgrade()) {
-        svc::DatabaseStructureUpdater dbStructureUpdater(pLogger);
+    svc::DatabaseMigrator databaseMigrator(pLogger);
+    if (!databaseMigrator.Execute()) {
+        wxString errorMessage =
+            wxString::Format(wxT("%s encountered an error while executing a database update operation.\n"
+                                 "The operation was aborted."),
+                common::GetProgramName());
+        wxMessageBox(errorMessage, common::GetProgramName(), wxICON_ERROR | wxOK_DEFAULT);
+        return false;
+    }
 
-        if (!dbStructureUpdater.ExecuteScripts()) {
-            wxString errorMessage =
-                wxString::Format(wxT("%s encountered an error while executing a database update operation.\n"
-                                     "The operation was aborted."),
-                    common::GetProgramName());
-            wxMessageBox(errorMessage, common::GetProgramName(), wxICON_ERROR | wxOK_DEFAULT);
-            return false;
-        }
+    return true;
+}
 
-        if (!CompleteDatabaseUpgrade()) {
-            return false;
+void Application::InitializeTracing()
+{
+    const char* TraceFilename = "Taskable.trace.json";
+
+    /* --trace or --trace=<file> on the command line, or TASKABLE_TRACE=<file> in the environment.
+       The trace is written when the application exits, to the logs directory unless a file is given */
+    wxString traceFilePath;
+    bool traceRequested = wxGetEnv(wxT("TASKABLE_TRACE"), &traceFilePath);
+
+    /* scanned by hand, wxCmdLineParser would show a message box for arguments it does not know */
+    for (int i = 1; i < argc; i++) {
+        wxString argument = argv[i];
+        if (argument == wxT("--trace")) {
+            traceRequested = true;
+        } else if (argument.StartsWith(wxT("--trace="), &traceFilePath)) {
+            traceRequested = true;
         }
     }
 
-    return true;
+    if (!traceRequested) {
+        return;
+    }
+
+    if (traceFilePath.empty()) {
+        wxFileName traceFile(wxStandardPaths::Get().GetUserDataDir(), TraceFilename);
+        traceFile.AppendDir(wxT("logs"));
+        traceFilePath = traceFile.GetFullPath();
+    }
+
+    common::Tracer::Get().Enable(traceFilePath.ToStdString());
 }
 
 bool Application::InitializeLogging()
 {
+    common::TraceSpan traceSpan("Application::InitializeLogging");
+
     const std::string LoggerName = "Taskable_Daily";
     const char* LogsFilename = "Taskable.log.txt";
+    /* messages, not bytes, when the queue is full the oldest message is dropped rather than blocking the UI */
+    const std::size_t LogQueueSize = 8192;
 
     if (!CreateLogsDirectory()) {
         return false;
     }
 
-    auto logDirectory =
-        wxString::Format(wxT("%s\\logs\\%s"), wxStandardPaths::Get().GetUserDataDir(), LogsFilename).ToStdString();
+    wxFileName logsDirectoryName = wxFileName::DirName(wxStandardPaths::Get().GetUserDataDir());
+    logsDirectoryName.AppendDir(wxT("logs"));
+    auto logsDirectory = logsDirectoryName.GetPath().ToStdString();
+    auto logDirectory = wxFileName(logsDirectory, LogsFilename).GetFullPath().ToStdString();
 
     try {
-        auto msvcSink = std::make_shared<spdlog::sinks::msvc_sink_st>();
+        /* one background thread formats and writes for every logger, callers only enqueue */
+        spdlog::init_thread_pool(LogQueueSize, 1);
 
-        auto msvcLogger = std::make_shared<spdlog::logger>("msvc", msvcSink);
-        msvcLogger->set_level(spdlog::level::debug);
-        spdlog::register_logger(msvcLogger);
+#ifdef _WIN32
+        auto debugSink = std::make_shared<spdlog::sinks::msvc_sink_mt>();
+#else
+        auto debugSink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+#endif // _WIN32
 
-        auto dialySink = std::make_shared<spdlog::sinks::daily_file_sink_st>(logDirectory, 23, 59);
+        auto dialySink = std::make_shared<spdlog::sinks::daily_file_sink_mt>(logDirectory, 23, 59);
         dialySink->set_level(spdlog::level::err);
 
-        auto combinedLoggers = std::make_shared<spdlog::sinks::dist_sink_st>();
-        combinedLoggers->add_sink(msvcSink);
-        combinedLoggers->add_sink(dialySink);
-        pLogger = std::make_shared<spdlog::logger>(LoggerName, combinedLoggers);
+        pLogger = std::make_shared<spdlog::async_logger>(LoggerName,
+            spdlog::sinks_init_list{ debugSink, dialySink },
+            spdlog::thread_pool(),
+            spdlog::async_overflow_policy::overrun_oldest);
+        spdlog::register_logger(pLogger);
     } catch (const spdlog::spdlog_ex& e) {
         wxMessageBox(wxString::Format(wxT("Error initializing logger: %s"), e.what()),
             common::GetProgramName(),
@@ -169,15 +278,55 @@ bool Application::InitializeLogging()
         return false;
     }
 
+    /* both only queue a flush for the background thread, nothing here waits on the disk */
     pLogger->flush_on(spdlog::level::err);
+    spdlog::flush_every(std::chrono::seconds(3));
     pLogger->enable_backtrace(32);
 
+    if (!InitializePerfLogging(logsDirectory)) {
+        pLogger->warn("Unable to open the performance log, performance events are not recorded");
+    }
+
+    return true;
+}
+
+bool Application::InitializePerfLogging(const std::string& logsDirectory)
+{
+    const char* PerfLogFilename = "Taskable.perf.jsonl";
+    const std::size_t PerfLogMaxFileSize = 5 * 1024 * 1024;
+    const std::size_t PerfLogMaxFiles = 3;
+    const std::size_t PerfLogQueueSize = 8192;
+
+    auto perfLogFilePath = wxFileName(logsDirectory, PerfLogFilename).GetFullPath().ToStdString();
+
+    try {
+        auto perfSink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+            perfLogFilePath, PerfLogMaxFileSize, PerfLogMaxFiles);
+        /* the events are complete JSON objects, a line holds nothing else */
+        perfSink->set_pattern("%v");
+
+        /* a queue and thread of its own, a burst of events must not push the application log's messages out */
+        auto perfThreadPool = std::make_shared<spdlog::details::thread_pool>(PerfLogQueueSize, 1);
+        auto perfLogger = std::make_shared<spdlog::async_logger>(common::PerfLog::LoggerName,
+            perfSink,
+            perfThreadPool,
+            spdlog::async_overflow_policy::overrun_oldest);
+        spdlog::register_logger(perfLogger);
+
+        common::PerfLog::Get().Initialize(perfLogger, perfThreadPool);
+    } catch (const spdlog::spdlog_ex& e) {
+        pLogger->error("Error initializing performance log: {0}", e.what());
+        return false;
+    }
+
     return true;
 }
 
 bool Application::CreateLogsDirectory()
 {
-    wxString logs = wxString::Format(wxT("%s\\logs"), wxStandardPaths::Get().GetUserDataDir());
+    wxFileName logsDirectoryName = wxFileName::DirName(wxStandardPaths::Get().GetUserDataDir());
+    logsDirectoryName.AppendDir(wxT("logs"));
+    wxString logs = logsDirectoryName.GetPath();
     bool logDirectoryExists = wxDirExists(logs);
     if (!logDirectoryExists) {
         bool success = wxMkDir(logs);
@@ -189,12 +338,13 @@ bool Application::CreateLogsDirectory()
 
 bool Application::InitializeDatabaseConnectionProvider()
 {
-    static int ConnectionPoolSize = 14;
+    common::TraceSpan traceSpan("Application::InitializeDatabaseConnectionProvider");
 
     auto sqliteConnectionFactory = std::make_shared<db::SqliteConnectionFactory>(
         common::GetDatabaseFilePath(cfg::ConfigurationProvider::Get().Configuration->GetDatabasePath()).ToStdString());
     auto connectionPool =
-        std::make_unique<db::ConnectionPool<db::SqliteConnection>>(sqliteConnectionFactory, ConnectionPoolSize);
+        std::make_unique<db::ConnectionPool<db::SqliteConnection>>(sqliteConnectionFactory,
+        cfg::ConfigurationProvider::Get().Configuration->GetConnectionPoolSize());
     db::ConnectionProvider::Get().InitializeConnectionPool(std::move(connectionPool));
 
     return true;
@@ -202,6 +352,8 @@ bool Application::InitializeDatabaseConnectionProvider()
 
 bool Application::IsSetup()
 {
+    common::TraceSpan traceSpan("Application::IsSetup");
+
 #ifdef TASKABLE_DEBUG
     wxRegKey key(wxRegKey::HKCU, "Software\\Taskabled");
 #else
@@ -249,6 +401,8 @@ bool Application::ConfigureRegistry()
 
 bool Application::ConfigurationFileExists()
 {
+    common::TraceSpan traceSpan("Application::ConfigurationFileExists");
+
     bool configFileExists = wxFileExists(common::GetConfigFilePath());
     if (!configFileExists) {
         wxMessageBox(wxT("Error: Program cannot locate configuration file!"),
@@ -258,7 +412,7 @@ bool Application::ConfigurationFileExists()
         return false;
     }
 
-    cfg::ConfigurationProvider::Get().Initialize();
+    cfg::ConfigurationProvider::Get().Initialize(pLogger);
 
     if (cfg::ConfigurationProvider::Get().Configuration->GetDatabasePath().empty()) {
         cfg::ConfigurationProvider::Get().Configuration->SetDatabasePath(wxStandardPaths::Get().GetAppDocumentsDir());
@@ -274,7 +428,9 @@ bool Application::CreateBackupsDirectory()
     if (IsSetup() && !cfg::ConfigurationProvider::Get().Configuration->GetBackupPath().empty()) {
         backupsDirectory = cfg::ConfigurationProvider::Get().Configuration->GetBackupPath();
     } else {
-        backupsDirectory = wxString::Format(wxT("%s\\backups"), wxStandardPaths::Get().GetUserDataDir());
+        wxFileName backupsDirectoryName = wxFileName::DirName(wxStandardPaths::Get().GetUserDataDir());
+        backupsDirectoryName.AppendDir(wxT("backups"));
+        backupsDirectory = backupsDirectoryName.GetPath();
     }
 
     if (!wxDirExists(backupsDirectory)) {
@@ -367,44 +523,114 @@ bool Application::DatabaseFileExists()
     return true;
 }
 
-bool Application::CheckForDatabaseUpgrade()
+bool Application::InitializeDatabaseTables()
 {
-#ifdef TASKABLE_DEBUG
-    wxRegKey key(wxRegKey::HKCU, "Software\\Taskabled");
-#else
-    wxRegKey key(wxRegKey::HKCU, "Software\\Taskable");
-#endif // TASKABLE_DEBUG
+    svc::SetupTables tables(pLogger);
+    return tables.CreateTables();
+}
 
-    if (key.HasValue(wxT("DatabaseUpgrade"))) {
-        long value = 0;
-        key.QueryValue(wxT("DatabaseUpgrade"), &value);
+void Application::StartInstanceChannel()
+{
+    pInstanceChannel = std::make_unique<common::InstanceChannel>(pLogger);
+
+    /* the channel calls back on its own thread, the frame is only touched on the UI thread */
+    bool listening = pInstanceChannel->Listen([this](common::InstanceCommands command) {
+        CallAfter([this, command]() { OnInstanceCommand(command); });
+    });
+    if (!listening) {
+        pLogger->warn("Later launches cannot forward their commands to this instance");
+    }
+}
 
-        return !!value;
+void Application::OnInstanceCommand(common::InstanceCommands command)
+{
+    auto frame = dynamic_cast<frm::MainFrame*>(GetTopWindow());
+    if (frame == nullptr) {
+        /* still starting up, OnInit replays the command once the frame is shown */
+        mPendingInstanceCommands.push_back(command);
+        return;
     }
-    return false;
+    frame->ExecuteInstanceCommand(command);
 }
 
-bool Application::CompleteDatabaseUpgrade()
+void Application::StartConfigurationWatcher()
 {
-#ifdef TASKABLE_DEBUG
-    wxRegKey key(wxRegKey::HKCU, "Software\\Taskabled");
-#else
-    wxRegKey key(wxRegKey::HKCU, "Software\\Taskable");
-#endif // TASKABLE_DEBUG
+    if (cfg::ConfigurationProvider::Get().Configuration == nullptr) {
+        return;
+    }
 
-    if (key.HasValue(wxT("DatabaseUpgrade"))) {
-        long value = 0;
-        return key.SetValue(wxT("DatabaseUpgrade"), value);
+    pConfigurationWatcher = std::make_unique<wxFileSystemWatcher>();
+    pConfigurationWatcher->SetOwner(this);
+    Bind(wxEVT_FSWATCHER, &Application::OnConfigurationFileChanged, this);
+
+    /* watch the directory, editors often save by writing a new file and renaming it over the old one */
+    wxFileName configFile(common::GetConfigFilePath());
+    wxFileName configDirectory = wxFileName::DirName(configFile.GetPath());
+    if (!pConfigurationWatcher->Add(configDirectory, wxFSW_EVENT_CREATE | wxFSW_EVENT_MODIFY | wxFSW_EVENT_RENAME)) {
+        pLogger->warn("Unable to watch {0} for configuration changes", configDirectory.GetPath().ToStdString());
+        return;
     }
 
-    return false;
+    pLogger->info("Watching {0} for configuration changes", configFile.GetFullPath().ToStdString());
 }
 
-bool Application::InitializeDatabaseTables()
+void Application::OnConfigurationFileChanged(wxFileSystemWatcherEvent& event)
 {
-    svc::SetupTables tables(pLogger);
-    return tables.CreateTables();
+    if (event.GetChangeType() == wxFSW_EVENT_WARNING || event.GetChangeType() == wxFSW_EVENT_ERROR) {
+        pLogger->warn("Configuration watcher reported: {0}", event.GetErrorDescription().ToStdString());
+        return;
+    }
+
+    const wxString configFileName = wxFileName(common::GetConfigFilePath()).GetFullName();
+    bool isConfigFile = event.GetPath().GetFullName().IsSameAs(configFileName, false) ||
+                        event.GetNewPath().GetFullName().IsSameAs(configFileName, false);
+    if (!isConfigFile) {
+        return;
+    }
+
+    if (!cfg::ConfigurationProvider::Get().Reload()) {
+        pLogger->warn("Unable to reload configuration file, keeping the current settings");
+    }
+}
+
+void Application::OnConfigurationChanged(const cfg::ConfigurationChanges& changes)
+{
+    pLogger->info("Configuration file changed, applying the new settings");
+
+    if (changes.ConnectionPoolSize && db::ConnectionProvider::Get().Handle() != nullptr) {
+        auto poolSize = cfg::ConfigurationProvider::Get().Configuration->GetConnectionPoolSize();
+        if (poolSize > 0) {
+            db::ConnectionProvider::Get().Handle()->Resize(static_cast<std::size_t>(poolSize));
+            pLogger->info("Connection pool resized to {0}", poolSize);
+        }
+    }
+
+    if (changes.DatabasePath) {
+        pLogger->warn("Database path changed, it takes effect after a restart");
+    }
 }
 } // namespace app
 
-wxIMPLEMENT_APP(app::Application);
+wxIMPLEMENT_APP_NO_MAIN(app::Application);
+
+/*
+ A second launch hands its command to the running instance and exits before wxWidgets, the configuration or the
+ database are initialized. When nothing is listening the application starts as usual.
+ */
+#ifdef __WXMSW__
+int WINAPI WinMain(HINSTANCE instance, HINSTANCE previousInstance, wxCmdLineArgType commandLine, int showCommand)
+{
+    if (app::common::InstanceChannel::Forward(app::common::GetLaunchCommand(__argc, __argv))) {
+        return 0;
+    }
+    return wxEntry(instance, previousInstance, commandLine, showCommand);
+}
+#else
+int main(int argc, char** argv)
+{
+    if (app::common::InstanceChannel::Forward(app::common::GetLaunchCommand(argc, argv))) {
+        return 0;
+    }
+    return wxEntry(argc, argv);
+}
+#endif // __WXMSW__
@@ -20,14 +20,24 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <wx/wx.h>
+#include <wx/fswatcher.h>
 #include <wx/snglinst.h>
 
 #include <spdlog/spdlog.h>
-#include <spdlog/sinks/dist_sink.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/daily_file_sink.h>
+#include <spdlog/sinks/rotating_file_sink.h>
+#ifdef _WIN32
 #include <spdlog/sinks/msvc_sink.h>
+#else
+#include <spdlog/sinks/stdout_color_sinks.h>
+#endif // _WIN32
+
+#include "common/instancechannel.h"
+#include "config/configuration.h"
 
 namespace app
 {
@@ -38,12 +48,16 @@ class Application : public wxApp
     virtual ~Application() = default;
 
     bool OnInit() override;
+    int OnExit() override;
+    void OnEventLoopEnter(wxEventLoopBase* loop) override;
 
 private:
     bool FirstStartupInitialization();
     bool StartupInitialization();
 
+    void InitializeTracing();
     bool InitializeLogging();
+    bool InitializePerfLogging(const std::string& logsDirectory);
     bool CreateLogsDirectory();
     bool InitializeDatabaseConnectionProvider();
 
@@ -59,12 +73,20 @@ class Application : public wxApp
     void DeleteDatabaseFile();
     bool DatabaseFileExists();
 
-    bool CheckForDatabaseUpgrade();
-    bool CompleteDatabaseUpgrade();
-
     bool InitializeDatabaseTables();
 
+    void StartInstanceChannel();
+    void OnInstanceCommand(common::InstanceCommands command);
+
+    void StartConfigurationWatcher();
+    void OnConfigurationFileChanged(wxFileSystemWatcherEvent& event);
+    void OnConfigurationChanged(const cfg::ConfigurationChanges& changes);
+
     std::shared_ptr<spdlog::logger> pLogger;
     std::unique_ptr<wxSingleInstanceChecker> pInstanceChecker;
+    std::unique_ptr<common::InstanceChannel> pInstanceChannel;
+    std::unique_ptr<wxFileSystemWatcher> pConfigurationWatcher;
+    int mConfigurationSubscription;
+    std::vector<common::InstanceCommands> mPendingInstanceCommands;
 };
 } // namespace app
@@ -0,0 +1,389 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "cliapplication.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include <wx/cmdline.h>
+#include <wx/datetime.h>
+#include <wx/filename.h>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <sqlite_modern_cpp/errors.h>
+
+#include "../common/paths.h"
+#include "../config/configurationprovider.h"
+#include "../database/connectionprovider.h"
+#include "../database/sqliteconnectionfactory.h"
+#include "../services/databasebackupdeleter.h"
+#include "../services/exporter.h"
+#include "../services/reportservice.h"
+
+namespace app::cli
+{
+namespace
+{
+const int ExitUsageError = 2;
+
+// clang-format off
+const wxCmdLineEntryDesc CommandLineDescription[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", "show this help message", wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", "log diagnostic messages to stderr" },
+    { wxCMD_LINE_SWITCH, "n", "dry-run", "prune-backups only prints which backups it would delete" },
+    { wxCMD_LINE_OPTION, "f", "from", "first date to export (YYYY-MM-DD)", wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "t", "to", "last date to export (YYYY-MM-DD)", wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "m", "format", "export format: csv, jsonl or columnar (default: csv)", wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "o", "output", "output file (default: export path for exports, stdout for reports)", wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "g", "group", "report grouping: project, client, employer, category, type, day, week or month (default: project)", wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "b", "by", "report breakdown within each group, same values as --group", wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "c", "config", "configuration file to use instead of the user's", wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "d", "database", "database file to use instead of the configured one", wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, "command: export, report or prune-backups", wxCMD_LINE_VAL_STRING },
+    wxCMD_LINE_DESC_END
+};
+// clang-format on
+} // namespace
+
+CliApplication::CliApplication()
+    : pLogger(nullptr)
+    , mCommand()
+    , mFromDate()
+    , mToDate()
+    , mExportFormat(constants::ExportFormats::Csv)
+    , mReportGrouping(constants::ReportGroupings::Project)
+    , mReportBreakdown(constants::ReportGroupings::None)
+    , mOutputPath()
+    , mConfigFilePath()
+    , mDatabaseFilePath()
+    , bVerbose(false)
+    , bDryRun(false)
+    , bHelpRequested(false)
+    , bDatabaseInitialized(false)
+{
+}
+
+CliApplication::~CliApplication()
+{
+    if (bDatabaseInitialized) {
+        db::ConnectionProvider::Get().PurgeConnectionPool();
+    }
+}
+
+int CliApplication::Run(int argc, char** argv)
+{
+    if (!ParseCommandLine(argc, argv)) {
+        return bHelpRequested ? EXIT_SUCCESS : ExitUsageError;
+    }
+
+    if (!InitializeLogging()) {
+        return EXIT_FAILURE;
+    }
+
+    if (!InitializeConfiguration()) {
+        return EXIT_FAILURE;
+    }
+
+    /* retention only reads the backup index, the database is not opened */
+    if (mCommand == wxT("prune-backups")) {
+        return RunPruneBackups();
+    }
+
+    if (!InitializeDatabaseConnectionProvider()) {
+        return EXIT_FAILURE;
+    }
+
+    /* the command was validated by ParseCommandLine */
+    return mCommand == wxT("export") ? RunExport() : RunReport();
+}
+
+bool CliApplication::ParseCommandLine(int argc, char** argv)
+{
+    wxCmdLineParser parser(CommandLineDescription, argc, argv);
+    parser.SetLogo(wxT("Taskable command line tool"));
+
+    int parseResult = parser.Parse();
+    if (parseResult != 0) {
+        /* -1 means --help was given and the usage has already been printed */
+        bHelpRequested = parseResult == -1;
+        return false;
+    }
+
+    mCommand = parser.GetParam(0);
+    if (mCommand != wxT("export") && mCommand != wxT("report") && mCommand != wxT("prune-backups")) {
+        std::fprintf(stderr,
+            "Unknown command '%s' (expected 'export', 'report' or 'prune-backups')\n",
+            mCommand.ToStdString().c_str());
+        return false;
+    }
+
+    bVerbose = parser.Found(wxT("verbose"));
+    bDryRun = parser.Found(wxT("dry-run"));
+
+    wxString value;
+    parser.Found(wxT("config"), &mConfigFilePath);
+    parser.Found(wxT("database"), &mDatabaseFilePath);
+
+    if (mCommand == wxT("prune-backups")) {
+        return true;
+    }
+
+    if (!parser.Found(wxT("from"), &value) || !ParseDate(value, mFromDate)) {
+        std::fprintf(stderr, "A valid --from date (YYYY-MM-DD) is required\n");
+        return false;
+    }
+
+    if (!parser.Found(wxT("to"), &value) || !ParseDate(value, mToDate)) {
+        std::fprintf(stderr, "A valid --to date (YYYY-MM-DD) is required\n");
+        return false;
+    }
+
+    /* ISO dates compare correctly as strings */
+    if (mFromDate > mToDate) {
+        std::fprintf(stderr, "--from date must be on or before the --to date\n");
+        return false;
+    }
+
+    if (parser.Found(wxT("format"), &value) && !ParseExportFormat(value)) {
+        std::fprintf(stderr, "Unknown format '%s' (expected csv, jsonl or columnar)\n", value.ToStdString().c_str());
+        return false;
+    }
+
+    if (parser.Found(wxT("group"), &value) && !ParseReportGrouping(value, mReportGrouping)) {
+        std::fprintf(stderr, "Unknown report grouping '%s'\n", value.ToStdString().c_str());
+        return false;
+    }
+
+    if (parser.Found(wxT("by"), &value) && !ParseReportGrouping(value, mReportBreakdown)) {
+        std::fprintf(stderr, "Unknown report breakdown '%s'\n", value.ToStdString().c_str());
+        return false;
+    }
+
+    if (parser.Found(wxT("output"), &value)) {
+        wxFileName outputFile(value);
+        outputFile.MakeAbsolute();
+        mOutputPath = outputFile.GetFullPath();
+    }
+
+    return true;
+}
+
+bool CliApplication::InitializeLogging()
+{
+    const std::string LoggerName = "Taskable_Cli";
+
+    try {
+        auto stderrSink = std::make_shared<spdlog::sinks::stderr_color_sink_st>();
+        pLogger = std::make_shared<spdlog::logger>(LoggerName, stderrSink);
+        pLogger->set_level(bVerbose ? spdlog::level::debug : spdlog::level::warn);
+    } catch (const spdlog::spdlog_ex& e) {
+        std::fprintf(stderr, "Error initializing logger: %s\n", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+bool CliApplication::InitializeConfiguration()
+{
+    if (mConfigFilePath.IsEmpty()) {
+        mConfigFilePath = common::GetConfigFilePath();
+    }
+
+    if (!wxFileExists(mConfigFilePath)) {
+        pLogger->error("Configuration file \"{0}\" does not exist", mConfigFilePath.ToStdString());
+        return false;
+    }
+
+    try {
+        cfg::ConfigurationProvider::Get().Initialize(pLogger, mConfigFilePath.ToStdString());
+    } catch (const std::exception& e) {
+        pLogger->error("Error occured reading configuration file \"{0}\" : {1}", mConfigFilePath.ToStdString(), e.what());
+        return false;
+    }
+
+    pLogger->debug("Using configuration file \"{0}\"", mConfigFilePath.ToStdString());
+    return true;
+}
+
+/*
+ A scheduled export opens exactly one connection, so the pool is sized to one instead of the
+ fourteen the desktop application keeps around for its dialogs
+ */
+bool CliApplication::InitializeDatabaseConnectionProvider()
+{
+    static int ConnectionPoolSize = 1;
+
+    if (mDatabaseFilePath.IsEmpty()) {
+        mDatabaseFilePath =
+            common::GetDatabaseFilePath(cfg::ConfigurationProvider::Get().Configuration->GetDatabasePath());
+    }
+
+    if (!wxFileExists(mDatabaseFilePath)) {
+        pLogger->error("Database file \"{0}\" does not exist", mDatabaseFilePath.ToStdString());
+        return false;
+    }
+
+    try {
+        auto sqliteConnectionFactory = std::make_shared<db::SqliteConnectionFactory>(mDatabaseFilePath.ToStdString());
+        auto connectionPool =
+            std::make_unique<db::ConnectionPool<db::SqliteConnection>>(sqliteConnectionFactory, ConnectionPoolSize);
+        db::ConnectionProvider::Get().InitializeConnectionPool(std::move(connectionPool));
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured opening database \"{0}\" - {1:d} : {2}",
+            mDatabaseFilePath.ToStdString(),
+            e.get_code(),
+            e.what());
+        return false;
+    }
+
+    bDatabaseInitialized = true;
+    pLogger->debug("Using database file \"{0}\"", mDatabaseFilePath.ToStdString());
+    return true;
+}
+
+int CliApplication::RunExport()
+{
+    std::string fileName = mOutputPath.ToStdString();
+    if (fileName.empty()) {
+        fileName = "Taskable " + mFromDate + " to " + mToDate + svc::GetExportFileExtension(mExportFormat);
+    }
+
+    auto exporter = svc::CreateExporter(mExportFormat, pLogger, mFromDate, mToDate, fileName);
+    if (exporter == nullptr) {
+        pLogger->error("No exporter available for format {0:d}", static_cast<int>(mExportFormat));
+        return EXIT_FAILURE;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!exporter->ExportData()) {
+        std::fprintf(stderr, "Export failed, see the log output for details\n");
+        return EXIT_FAILURE;
+    }
+
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    pLogger->debug("Export completed in {0:d} ms", elapsed);
+
+    std::printf("%s\n", svc::GetExportFilePath(fileName).c_str());
+    return EXIT_SUCCESS;
+}
+
+int CliApplication::RunReport()
+{
+    svc::ReportTable table;
+    svc::ReportService reportService(pLogger);
+    if (!reportService.Run(mReportGrouping, mReportBreakdown, mFromDate, mToDate, table)) {
+        std::fprintf(stderr, "Report failed, see the log output for details\n");
+        return EXIT_FAILURE;
+    }
+
+    std::string configDelimiter = cfg::ConfigurationProvider::Get().Configuration->GetDelimiter();
+    char delimiter = configDelimiter.empty() ? ',' : configDelimiter[0];
+
+    if (mOutputPath.IsEmpty()) {
+        return svc::WriteReportCsv(table, std::cout, delimiter) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::ofstream reportFile(mOutputPath.ToStdString(), std::ios_base::out | std::ios_base::binary);
+    if (!reportFile || !svc::WriteReportCsv(table, reportFile, delimiter)) {
+        pLogger->error("Error when trying to write the report to {0}", mOutputPath.ToStdString());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%s\n", mOutputPath.ToStdString().c_str());
+    return EXIT_SUCCESS;
+}
+
+int CliApplication::RunPruneBackups()
+{
+    svc::DatabaseBackupDeleter databaseBackupDeleter(pLogger);
+    if (!databaseBackupDeleter.Execute(bDryRun)) {
+        std::fprintf(stderr, "Pruning backups failed, see the log output for details\n");
+        return EXIT_FAILURE;
+    }
+
+    const char* deleteAction = bDryRun ? "would delete" : "deleted";
+    for (const auto& decision : databaseBackupDeleter.GetRetentionPlan()) {
+        std::printf("%-12s %s (%s)\n",
+            decision.Keep ? "keep" : deleteAction,
+            decision.FileName.c_str(),
+            decision.Reason.c_str());
+    }
+    return EXIT_SUCCESS;
+}
+
+bool CliApplication::ParseDate(const wxString& value, std::string& date)
+{
+    wxDateTime parsedDate;
+    wxString::const_iterator end;
+    if (!parsedDate.ParseISODate(value, &end) || end != value.end()) {
+        return false;
+    }
+
+    date = parsedDate.FormatISODate().ToStdString();
+    return true;
+}
+
+bool CliApplication::ParseExportFormat(const wxString& value)
+{
+    wxString format = value.Lower();
+    if (format == wxT("csv")) {
+        mExportFormat = constants::ExportFormats::Csv;
+    } else if (format == wxT("jsonl") || format == wxT("ndjson")) {
+        mExportFormat = constants::ExportFormats::JsonLines;
+    } else if (format == wxT("columnar") || format == wxT("tskc")) {
+        mExportFormat = constants::ExportFormats::Columnar;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+bool CliApplication::ParseReportGrouping(const wxString& value, constants::ReportGroupings& grouping)
+{
+    wxString name = value.Lower();
+    if (name == wxT("project")) {
+        grouping = constants::ReportGroupings::Project;
+    } else if (name == wxT("client")) {
+        grouping = constants::ReportGroupings::Client;
+    } else if (name == wxT("employer")) {
+        grouping = constants::ReportGroupings::Employer;
+    } else if (name == wxT("category")) {
+        grouping = constants::ReportGroupings::Category;
+    } else if (name == wxT("type")) {
+        grouping = constants::ReportGroupings::TaskItemType;
+    } else if (name == wxT("day")) {
+        grouping = constants::ReportGroupings::Day;
+    } else if (name == wxT("week")) {
+        grouping = constants::ReportGroupings::Week;
+    } else if (name == wxT("month")) {
+        grouping = constants::ReportGroupings::Month;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+} // namespace app::cli
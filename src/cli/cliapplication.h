@@ -0,0 +1,80 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <wx/string.h>
+
+#include <spdlog/spdlog.h>
+
+#include "../common/constants.h"
+
+namespace app::cli
+{
+/*
+ Headless entry point used by scheduled jobs. Only links the configuration, database and
+ exporting layers (wxBase, no GUI) and runs against a single database connection.
+
+ Usage: taskable-cli export --from 2020-01-01 --to 2020-01-31 [--format csv] [--output file]
+        taskable-cli report --from 2020-01-01 --to 2020-01-31 [--group project] [--by week] [--output file]
+        taskable-cli prune-backups [--dry-run]
+ */
+class CliApplication final
+{
+public:
+    CliApplication();
+    ~CliApplication();
+
+    int Run(int argc, char** argv);
+
+private:
+    bool ParseCommandLine(int argc, char** argv);
+
+    bool InitializeLogging();
+    bool InitializeConfiguration();
+    bool InitializeDatabaseConnectionProvider();
+
+    int RunExport();
+    int RunReport();
+    int RunPruneBackups();
+
+    bool ParseDate(const wxString& value, std::string& date);
+    bool ParseExportFormat(const wxString& value);
+    bool ParseReportGrouping(const wxString& value, constants::ReportGroupings& grouping);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+
+    wxString mCommand;
+    std::string mFromDate;
+    std::string mToDate;
+    constants::ExportFormats mExportFormat;
+    constants::ReportGroupings mReportGrouping;
+    constants::ReportGroupings mReportBreakdown;
+    wxString mOutputPath;
+    wxString mConfigFilePath;
+    wxString mDatabaseFilePath;
+    bool bVerbose;
+    bool bDryRun;
+    bool bHelpRequested;
+    bool bDatabaseInitialized;
+};
+} // namespace app::cli
@@ -19,7 +19,6 @@
 
 #include "common.h"
 
-#include <wx/stdpaths.h>
 #include <wx/richtooltip.h>
 
 #include "constants.h"
@@ -56,30 +55,6 @@ wxString app::common::GetProgramName()
 #endif // TASKABLE_DEBUG
 }
 
-wxString app::common::GetDatabaseFileName()
-{
-#ifdef TASKABLE_DEBUG
-    return wxT("taskable-d.db");
-#else
-    return wxT("taskable.db");
-#endif // TASKABLE_DEBUG
-}
-
-wxString app::common::GetDatabaseFilePath(const wxString& databasePath)
-{
-    return wxString::Format(wxT("%s\\%s"), databasePath, common::GetDatabaseFileName());
-}
-
-wxString app::common::GetConfigFilePath()
-{
-    return wxString::Format(wxT("%s\\%s"), wxStandardPaths::Get().GetUserDataDir(), common::GetConfigFileName());
-}
-
-wxString app::common::GetConfigFileName()
-{
-    return wxT("taskable.toml");
-}
-
 wxString app::common::GetAppId()
 {
     return wxT("ifexception.Taskable");
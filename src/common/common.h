@@ -21,6 +21,7 @@
 
 #include <wx/wx.h>
 
+#include "paths.h"
 #include "version.h"
 
 namespace app::common
@@ -52,13 +53,5 @@ wxString GetVersion();
 
 wxString GetProgramName();
 
-wxString GetDatabaseFileName();
-
-wxString GetDatabaseFilePath(const wxString& databasePath);
-
-wxString GetConfigFilePath();
-
-wxString GetConfigFileName();
-
 wxString GetAppId();
 } // namespace app::common
@@ -44,7 +44,9 @@ enum class TaskItemTypes : int {
 
 enum Days { Monday = 0, Tuesday, Wednesday, Thursday, Friday, Saturday, Sunday };
 
-enum class ExportFormats : int { OfficeXml = 1, Excel };
+enum class ExportFormats : int { OfficeXml = 1, Excel, Csv, JsonLines, Columnar };
+
+enum class ReportGroupings : int { None = 0, Project, Client, Employer, Category, TaskItemType, Day, Week, Month };
 
 Days MapIndexToEnum(int index);
 
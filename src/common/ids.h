@@ -30,6 +30,7 @@ enum class MenuIds : int {
     File_NewCategoryId,
     File_View_WeeklyView,
     File_View_MeetingsView,
+    File_View_ReportView,
     File_StopwatchTaskId,
     Edit_EditEmployerId,
     Edit_EditClientId,
@@ -40,6 +41,7 @@ enum class MenuIds : int {
     Help_CheckForUpdateId,
     Tools_RestoreDatabaseId,
     Tools_BackupDatabaseId,
+    Help_DiagnosticsId,
 
     Unp_ReturnToCurrentDate = 32,
 };
@@ -53,6 +55,7 @@ static const int ID_NEW_CATEGORY = static_cast<int>(ids::MenuIds::File_NewCatego
 static const int ID_STOPWATCH_TASK = static_cast<int>(ids::MenuIds::File_StopwatchTaskId);
 static const int ID_WEEKLY_VIEW = static_cast<int>(ids::MenuIds::File_View_WeeklyView);
 static const int ID_MEETINGS_VIEW = static_cast<int>(ids::MenuIds::File_View_MeetingsView);
+static const int ID_REPORT_VIEW = static_cast<int>(ids::MenuIds::File_View_ReportView);
 
 static const int ID_EDIT_EMPLOYER = static_cast<int>(MenuIds::Edit_EditEmployerId);
 static const int ID_EDIT_CLIENT = static_cast<int>(MenuIds::Edit_EditClientId);
@@ -62,6 +65,7 @@ static const int ID_EDIT_CATEGORY = static_cast<int>(MenuIds::Edit_EditCategoryI
 static const int ID_PREFERENCES = static_cast<int>(MenuIds::Edit_PreferencesId);
 
 static const int ID_CHECK_FOR_UPDATE = static_cast<int>(MenuIds::Help_CheckForUpdateId);
+static const int ID_DIAGNOSTICS = static_cast<int>(MenuIds::Help_DiagnosticsId);
 
 static const int ID_RESTORE_DATABASE = static_cast<int>(MenuIds::Tools_RestoreDatabaseId);
 static const int ID_BACKUP_DATABASE = static_cast<int>(MenuIds::Tools_BackupDatabaseId);
@@ -0,0 +1,567 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "instancechannel.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace app::common
+{
+namespace
+{
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+const NativeSocket InvalidSocket = INVALID_SOCKET;
+#else
+using NativeSocket = int;
+const NativeSocket InvalidSocket = -1;
+#endif // _WIN32
+
+struct InstanceCommandName {
+    InstanceCommands Command;
+    const char* Name;
+};
+
+const InstanceCommandName InstanceCommandNames[] = {
+    { InstanceCommands::Show, "show" },
+    { InstanceCommands::StartStopwatch, "start-stopwatch" },
+    { InstanceCommands::NewEntry, "new-entry" },
+};
+
+/* commands are a word or two, a longer line is not one of ours */
+const std::size_t MaxLineLength = 64;
+
+bool InitializeSockets()
+{
+#ifdef _WIN32
+    static std::once_flag initializeFlag;
+    static bool initialized = false;
+    std::call_once(initializeFlag, []() {
+        WSADATA data;
+        initialized = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    });
+    return initialized;
+#else
+    return true;
+#endif // _WIN32
+}
+
+void CloseSocket(NativeSocket socket)
+{
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif // _WIN32
+}
+
+int GetLastSocketError()
+{
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif // _WIN32
+}
+
+bool IsConnectionRefused(int error)
+{
+#ifdef _WIN32
+    return error == WSAECONNREFUSED;
+#else
+    return error == ECONNREFUSED;
+#endif // _WIN32
+}
+
+/* the socket's directory is only accessible to its owner on Windows, elsewhere the peer has to prove it is us */
+bool IsPeerCurrentUser(NativeSocket socket)
+{
+#if defined(_WIN32)
+    (void) socket;
+    return true;
+#elif defined(SO_PEERCRED)
+    ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (getsockopt(socket, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) {
+        return false;
+    }
+    return credentials.uid == geteuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(socket, &uid, &gid) != 0) {
+        return false;
+    }
+    return uid == geteuid();
+#endif // defined(_WIN32)
+}
+
+bool FillAddress(const std::string& socketPath, sockaddr_un& address)
+{
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    return true;
+}
+
+void SetReceiveTimeout(NativeSocket socket, int milliseconds)
+{
+#ifdef _WIN32
+    DWORD timeout = static_cast<DWORD>(milliseconds);
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+#else
+    timeval timeout;
+    timeout.tv_sec = milliseconds / 1000;
+    timeout.tv_usec = (milliseconds % 1000) * 1000;
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#endif // _WIN32
+}
+
+bool SendLine(NativeSocket socket, const std::string& text)
+{
+#ifdef MSG_NOSIGNAL
+    /* a peer that went away must not raise SIGPIPE */
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif // MSG_NOSIGNAL
+
+    std::string line = text + "\n";
+    std::size_t sent = 0;
+    while (sent < line.size()) {
+        auto result = send(socket, line.c_str() + sent, static_cast<int>(line.size() - sent), flags);
+        if (result <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+/* reads up to the first newline, false on error, timeout or a line that is too long */
+bool ReceiveLine(NativeSocket socket, std::string& line)
+{
+    char buffer[MaxLineLength];
+
+    line.clear();
+    while (line.size() < MaxLineLength) {
+        auto result = recv(socket, buffer, static_cast<int>(MaxLineLength - line.size()), 0);
+        if (result <= 0) {
+            return false;
+        }
+
+        line.append(buffer, static_cast<std::size_t>(result));
+        auto newline = line.find('\n');
+        if (newline != std::string::npos) {
+            line.erase(newline);
+            return true;
+        }
+    }
+    return false;
+}
+
+/* connectError is set to the socket error when connecting fails, 0 when it failed before connecting */
+NativeSocket Connect(const std::string& socketPath, int* connectError = nullptr)
+{
+    if (connectError != nullptr) {
+        *connectError = 0;
+    }
+
+    sockaddr_un address;
+    if (!InitializeSockets() || !FillAddress(socketPath, address)) {
+        return InvalidSocket;
+    }
+
+    NativeSocket connectSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connectSocket == InvalidSocket) {
+        return InvalidSocket;
+    }
+
+    if (connect(connectSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        if (connectError != nullptr) {
+            *connectError = GetLastSocketError();
+        }
+        CloseSocket(connectSocket);
+        return InvalidSocket;
+    }
+    return connectSocket;
+}
+
+#ifndef _WIN32
+/* creates the directory when missing, it must be a real directory owned by us that nobody else can enter */
+bool PreparePrivateDirectory(const std::string& directory, std::string& problem)
+{
+    if (mkdir(directory.c_str(), S_IRWXU) != 0 && errno != EEXIST) {
+        problem = "cannot be created";
+        return false;
+    }
+
+    struct stat status;
+    if (lstat(directory.c_str(), &status) != 0 || !S_ISDIR(status.st_mode)) {
+        problem = "is not a directory";
+        return false;
+    }
+    if (status.st_uid != geteuid()) {
+        problem = "is owned by another user";
+        return false;
+    }
+    if ((status.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+        problem = "is accessible to other users";
+        return false;
+    }
+    return true;
+}
+#endif // _WIN32
+} // namespace
+
+const int InstanceChannel::ReplyTimeoutMilliseconds = 2000;
+
+const char* GetInstanceCommandName(InstanceCommands command)
+{
+    for (const auto& commandName : InstanceCommandNames) {
+        if (commandName.Command == command) {
+            return commandName.Name;
+        }
+    }
+    return "";
+}
+
+InstanceCommands GetInstanceCommandFromName(const std::string& name)
+{
+    for (const auto& commandName : InstanceCommandNames) {
+        if (name == commandName.Name) {
+            return commandName.Command;
+        }
+    }
+    return InstanceCommands::None;
+}
+
+InstanceCommands GetInstanceCommandFromArgument(const std::string& argument)
+{
+    if (argument.size() <= 2 || argument.compare(0, 2, "--") != 0) {
+        return InstanceCommands::None;
+    }
+    return GetInstanceCommandFromName(argument.substr(2));
+}
+
+InstanceCommands GetLaunchCommand(int argc, char** argv)
+{
+    auto launchCommand = InstanceCommands::Show;
+    for (int i = 1; i < argc; i++) {
+        auto command = GetInstanceCommandFromArgument(argv[i]);
+        if (command != InstanceCommands::None) {
+            launchCommand = command;
+        }
+    }
+    return launchCommand;
+}
+
+InstanceChannel::InstanceChannel(std::shared_ptr<spdlog::logger> logger)
+    : InstanceChannel(logger, GetDefaultSocketPath())
+{
+}
+
+InstanceChannel::InstanceChannel(std::shared_ptr<spdlog::logger> logger, const std::string& socketPath)
+    : pLogger(logger)
+    , mSocketPath(socketPath)
+    , mHandler()
+    , mListenSocket(static_cast<std::intptr_t>(InvalidSocket))
+    , bListening(false)
+    , mAcceptThread()
+{
+}
+
+InstanceChannel::~InstanceChannel()
+{
+    Close();
+}
+
+bool InstanceChannel::Listen(CommandHandler handler)
+{
+    if (IsListening()) {
+        return true;
+    }
+    /* an accept thread that stopped after an error is joined and its socket cleaned up first */
+    Close();
+
+    sockaddr_un address;
+    if (!InitializeSockets()) {
+        pLogger->error("Unable to initialize sockets for the instance channel");
+        return false;
+    }
+    if (!FillAddress(mSocketPath, address)) {
+        pLogger->error("Instance channel socket path \"{0}\" is empty or too long", mSocketPath);
+        return false;
+    }
+
+#ifndef _WIN32
+    /* the socket is bound inside a directory only we can enter, so it is never reachable by anyone else */
+    std::string directory = std::filesystem::path(mSocketPath).parent_path().string();
+    std::string problem;
+    if (!PreparePrivateDirectory(directory, problem)) {
+        pLogger->error("Instance channel directory \"{0}\" {1}", directory, problem);
+        return false;
+    }
+#endif // _WIN32
+
+    if (!RemoveStaleSocket()) {
+        return false;
+    }
+
+    NativeSocket listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket == InvalidSocket) {
+        pLogger->error("Unable to create the instance channel socket");
+        return false;
+    }
+
+    if (bind(listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenSocket, SOMAXCONN) != 0) {
+        pLogger->error("Unable to listen on instance channel socket \"{0}\"", mSocketPath);
+        CloseSocket(listenSocket);
+        return false;
+    }
+
+    mHandler = handler;
+    mListenSocket = static_cast<std::intptr_t>(listenSocket);
+    bListening = true;
+    mAcceptThread = std::thread(&InstanceChannel::AcceptCommands, this);
+
+    pLogger->info("Instance channel listening on \"{0}\"", mSocketPath);
+    return true;
+}
+
+void InstanceChannel::Close()
+{
+    bool wasListening = bListening.exchange(false);
+    if (!mAcceptThread.joinable()) {
+        return;
+    }
+
+    auto listenSocket = static_cast<NativeSocket>(mListenSocket);
+
+    /* closing the socket does not wake a blocked accept everywhere, a connection of our own does. After an
+       accept error the thread has already stopped and there is nothing to wake */
+    NativeSocket wakeSocket = wasListening ? Connect(mSocketPath) : InvalidSocket;
+    if (wakeSocket != InvalidSocket) {
+        CloseSocket(wakeSocket);
+    } else if (wasListening) {
+#ifdef _WIN32
+        CloseSocket(listenSocket);
+        listenSocket = InvalidSocket;
+#else
+        shutdown(listenSocket, SHUT_RDWR);
+#endif // _WIN32
+    }
+
+    if (mAcceptThread.joinable()) {
+        mAcceptThread.join();
+    }
+
+    if (listenSocket != InvalidSocket) {
+        CloseSocket(listenSocket);
+    }
+    mListenSocket = static_cast<std::intptr_t>(InvalidSocket);
+
+    std::error_code ec;
+    std::filesystem::remove(mSocketPath, ec);
+}
+
+bool InstanceChannel::RemoveStaleSocket()
+{
+    std::error_code ec;
+    if (!std::filesystem::exists(std::filesystem::symlink_status(mSocketPath, ec))) {
+        return true;
+    }
+
+#ifndef _WIN32
+    struct stat status;
+    if (lstat(mSocketPath.c_str(), &status) != 0 || !S_ISSOCK(status.st_mode) || status.st_uid != geteuid()) {
+        pLogger->error("Instance channel socket path \"{0}\" is taken by a file that is not our socket", mSocketPath);
+        return false;
+    }
+#endif // _WIN32
+
+    /* only a socket nobody listens on is left over from an instance that crashed */
+    int connectError = 0;
+    NativeSocket probeSocket = Connect(mSocketPath, &connectError);
+    if (probeSocket != InvalidSocket) {
+        CloseSocket(probeSocket);
+        pLogger->error("Another instance is already listening on \"{0}\"", mSocketPath);
+        return false;
+    }
+    if (!IsConnectionRefused(connectError)) {
+        pLogger->error("Unable to tell whether instance channel socket \"{0}\" is still in use", mSocketPath);
+        return false;
+    }
+
+    pLogger->info("Removing instance channel socket \"{0}\" left behind by an instance that crashed", mSocketPath);
+    if (!std::filesystem::remove(mSocketPath, ec)) {
+        pLogger->error("Unable to remove instance channel socket \"{0}\"", mSocketPath);
+        return false;
+    }
+    return true;
+}
+
+bool InstanceChannel::IsListening() const
+{
+    return bListening;
+}
+
+const std::string& InstanceChannel::GetSocketPath() const
+{
+    return mSocketPath;
+}
+
+bool InstanceChannel::Forward(InstanceCommands command)
+{
+    return Forward(GetDefaultSocketPath(), command);
+}
+
+bool InstanceChannel::Forward(const std::string& socketPath, InstanceCommands command)
+{
+    if (command == InstanceCommands::None) {
+        return false;
+    }
+
+    NativeSocket forwardSocket = Connect(socketPath);
+    if (forwardSocket == InvalidSocket) {
+        return false;
+    }
+
+    /* an "ok" from a socket another user put in our place means nothing */
+    if (!IsPeerCurrentUser(forwardSocket)) {
+        CloseSocket(forwardSocket);
+        return false;
+    }
+
+    SetReceiveTimeout(forwardSocket, ReplyTimeoutMilliseconds);
+
+    std::string reply;
+    bool forwarded = SendLine(forwardSocket, GetInstanceCommandName(command)) && ReceiveLine(forwardSocket, reply) &&
+                     reply == "ok";
+
+    CloseSocket(forwardSocket);
+    return forwarded;
+}
+
+std::string InstanceChannel::GetDefaultSocketPath()
+{
+#ifdef TASKABLE_DEBUG
+    std::string fileName = "taskable-d";
+#else
+    std::string fileName = "taskable";
+#endif // TASKABLE_DEBUG
+
+    std::error_code ec;
+    std::filesystem::path directory;
+#ifdef _WIN32
+    directory = std::filesystem::temp_directory_path(ec);
+#else
+    /* the runtime directory is private to the user already, in the shared temp directory we make one of our own */
+    const char* runtimeDirectory = std::getenv("XDG_RUNTIME_DIR");
+    if (runtimeDirectory != nullptr && *runtimeDirectory != '\0') {
+        directory = runtimeDirectory;
+    } else {
+        directory = std::filesystem::temp_directory_path(ec) / ("taskable-" + std::to_string(geteuid()));
+    }
+#endif // _WIN32
+
+    return (directory / (fileName + ".sock")).string();
+}
+
+void InstanceChannel::AcceptCommands()
+{
+    auto listenSocket = static_cast<NativeSocket>(mListenSocket);
+
+    while (bListening) {
+        NativeSocket clientSocket = accept(listenSocket, nullptr, nullptr);
+        if (clientSocket == InvalidSocket) {
+#ifndef _WIN32
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+#endif // _WIN32
+            /* IsListening tells the owner, Close still joins this thread and removes the socket file */
+            if (bListening.exchange(false)) {
+                pLogger->error("Instance channel stopped accepting connections");
+            }
+            break;
+        }
+
+        if (!bListening) {
+            CloseSocket(clientSocket);
+            break;
+        }
+
+        HandleClient(static_cast<std::intptr_t>(clientSocket));
+        CloseSocket(clientSocket);
+    }
+}
+
+void InstanceChannel::HandleClient(std::intptr_t clientSocket)
+{
+    auto socket = static_cast<NativeSocket>(clientSocket);
+    if (!IsPeerCurrentUser(socket)) {
+        pLogger->warn("Instance channel rejected a connection from another user");
+        return;
+    }
+
+    SetReceiveTimeout(socket, ReplyTimeoutMilliseconds);
+
+    std::string line;
+    if (!ReceiveLine(socket, line)) {
+        /* a launch checking whether we still listen connects and hangs up without a word */
+        if (!line.empty()) {
+            pLogger->warn("Instance channel discarded an incomplete command");
+        }
+        return;
+    }
+
+    auto command = GetInstanceCommandFromName(line);
+    if (command == InstanceCommands::None) {
+        pLogger->warn("Instance channel received unknown command \"{0}\"", line);
+        SendLine(socket, "error");
+        return;
+    }
+
+    pLogger->info("Instance channel received \"{0}\"", line);
+    mHandler(command);
+    SendLine(socket, "ok");
+}
+} // namespace app::common
@@ -0,0 +1,97 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+namespace app::common
+{
+enum class InstanceCommands : int { None = 0, Show, StartStopwatch, NewEntry };
+
+/* name on the wire, the command line argument is the name prefixed with -- */
+const char* GetInstanceCommandName(InstanceCommands command);
+InstanceCommands GetInstanceCommandFromName(const std::string& name);
+/* maps an argument such as --start-stopwatch to its command, None when it is not one */
+InstanceCommands GetInstanceCommandFromArgument(const std::string& argument);
+/* the last command argument wins, a launch without one brings the running instance to the front */
+InstanceCommands GetLaunchCommand(int argc, char** argv);
+
+/*
+ Local channel between launches of the application. The running instance listens on a Unix domain socket
+ (AF_UNIX is also available on Windows 10) in the user's runtime directory, or in a taskable-<uid> directory only
+ the user can enter in the temp directory, and both ends check the other one runs as the same user. A second launch
+ connects, writes its command as one line and waits for "ok", which takes well under a millisecond, and exits.
+ Forwarding needs neither wxWidgets nor the configuration or the database, so it can run before any of them is
+ initialized.
+ */
+class InstanceChannel final
+{
+public:
+    using CommandHandler = std::function<void(InstanceCommands)>;
+
+    explicit InstanceChannel(std::shared_ptr<spdlog::logger> logger);
+    InstanceChannel(std::shared_ptr<spdlog::logger> logger, const std::string& socketPath);
+    InstanceChannel(const InstanceChannel&) = delete;
+    ~InstanceChannel();
+
+    InstanceChannel& operator=(const InstanceChannel&) = delete;
+
+    /*
+     binds the socket and accepts commands on a worker thread, the handler runs on that thread and should hand the
+     command over to the UI thread. A socket file is only replaced when nobody accepts connections on it any more,
+     i.e. it was left behind by an instance that crashed. IsListening turns false when accepting fails for good,
+     Listen can then be called again.
+     */
+    bool Listen(CommandHandler handler);
+    void Close();
+    bool IsListening() const;
+
+    const std::string& GetSocketPath() const;
+
+    /* true once the running instance acknowledged the command, false straight away when nothing is listening */
+    static bool Forward(InstanceCommands command);
+    static bool Forward(const std::string& socketPath, InstanceCommands command);
+
+    static std::string GetDefaultSocketPath();
+
+    static const int ReplyTimeoutMilliseconds;
+
+private:
+    /* true when the path is free, false when another instance listens on it or it is not a socket of ours */
+    bool RemoveStaleSocket();
+    void AcceptCommands();
+    void HandleClient(std::intptr_t clientSocket);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::string mSocketPath;
+    CommandHandler mHandler;
+    /* native socket handle, SOCKET on Windows and a file descriptor elsewhere */
+    std::intptr_t mListenSocket;
+    std::atomic<bool> bListening;
+    std::thread mAcceptThread;
+};
+} // namespace app::common
@@ -0,0 +1,206 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "jsonlinewriter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace app::common
+{
+namespace
+{
+const char* ReplacementCharacter = "\xEF\xBF\xBD";
+
+/*
+ length of the UTF-8 sequence starting at index. When it is invalid, returns 0 and sets invalidLength to the bytes
+ to replace with a single U+FFFD: the lead byte and the continuation bytes that were still valid.
+ */
+std::size_t GetUtf8SequenceLength(std::string_view value, std::size_t index, std::size_t& invalidLength)
+{
+    invalidLength = 1;
+
+    auto lead = static_cast<unsigned char>(value[index]);
+    std::size_t length = 0;
+    unsigned char lowest = 0x80;
+    unsigned char highest = 0xBF;
+
+    if (lead < 0x80) {
+        return 1;
+    } else if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        /* no overlong encodings and no surrogates */
+        lowest = lead == 0xE0 ? 0xA0 : 0x80;
+        highest = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        /* nothing overlong and nothing above U+10FFFF */
+        lowest = lead == 0xF0 ? 0x90 : 0x80;
+        highest = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 0;
+    }
+
+    for (std::size_t i = 1; i < length; i++) {
+        if (index + i >= value.size()) {
+            return 0;
+        }
+
+        auto continuation = static_cast<unsigned char>(value[index + i]);
+        if (continuation < lowest || continuation > highest) {
+            return 0;
+        }
+        lowest = 0x80;
+        highest = 0xBF;
+        invalidLength++;
+    }
+    return length;
+}
+} // namespace
+
+JsonLineWriter::JsonLineWriter()
+    : mLine()
+    , bFirstField(true)
+{
+}
+
+void JsonLineWriter::Begin()
+{
+    mLine.clear();
+    mLine += '{';
+    bFirstField = true;
+}
+
+void JsonLineWriter::WriteString(const char* name, std::string_view value)
+{
+    AppendName(name);
+    AppendString(value);
+}
+
+void JsonLineWriter::WriteNumber(const char* name, double value)
+{
+    AppendName(name);
+
+    /* JSON has no NaN or infinity */
+    if (!std::isfinite(value)) {
+        mLine += "null";
+        return;
+    }
+
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    mLine.append(buffer, result.ptr);
+
+    if (std::find_if(buffer, result.ptr, [](char c) { return c == '.' || c == 'e'; }) == result.ptr) {
+        mLine += ".0";
+    }
+}
+
+void JsonLineWriter::WriteInteger(const char* name, std::int64_t value)
+{
+    AppendName(name);
+
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    mLine.append(buffer, result.ptr);
+}
+
+void JsonLineWriter::WriteBool(const char* name, bool value)
+{
+    AppendName(name);
+    mLine += value ? "true" : "false";
+}
+
+void JsonLineWriter::WriteNull(const char* name)
+{
+    AppendName(name);
+    mLine += "null";
+}
+
+const std::string& JsonLineWriter::End()
+{
+    mLine += '}';
+    return mLine;
+}
+
+void JsonLineWriter::AppendName(const char* name)
+{
+    if (!bFirstField) {
+        mLine += ',';
+    }
+    bFirstField = false;
+    AppendString(name);
+    mLine += ':';
+}
+
+/* quotes and escapes a string, invalid UTF-8 is replaced rather than failing half way through the file */
+void JsonLineWriter::AppendString(std::string_view value)
+{
+    static const char* HexDigits = "0123456789abcdef";
+
+    mLine += '"';
+    std::size_t index = 0;
+    while (index < value.size()) {
+        auto character = static_cast<unsigned char>(value[index]);
+        if (character == '"' || character == '\\') {
+            mLine += '\\';
+            mLine += static_cast<char>(character);
+            index++;
+        } else if (character < 0x20) {
+            switch (character) {
+            case '\b':
+                mLine += "\\b";
+                break;
+            case '\f':
+                mLine += "\\f";
+                break;
+            case '\n':
+                mLine += "\\n";
+                break;
+            case '\r':
+                mLine += "\\r";
+                break;
+            case '\t':
+                mLine += "\\t";
+                break;
+            default:
+                mLine += "\\u00";
+                mLine += HexDigits[character >> 4];
+                mLine += HexDigits[character & 0x0F];
+                break;
+            }
+            index++;
+        } else {
+            std::size_t invalidLength = 0;
+            std::size_t length = GetUtf8SequenceLength(value, index, invalidLength);
+            if (length == 0) {
+                mLine += ReplacementCharacter;
+                index += invalidLength;
+            } else {
+                mLine.append(value, index, length);
+                index += length;
+            }
+        }
+    }
+    mLine += '"';
+}
+} // namespace app::common
@@ -0,0 +1,56 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace app::common
+{
+/*
+ Builds one JSON object at a time into a reused buffer. Names and values are escaped as they are appended, invalid
+ UTF-8 is replaced with U+FFFD and NaN or infinity is written as null, so no JSON document is built and nothing
+ throws half way through a line. Used for the JSON Lines export and the performance log.
+ */
+class JsonLineWriter final
+{
+public:
+    JsonLineWriter();
+    ~JsonLineWriter() = default;
+
+    void Begin();
+    void WriteString(const char* name, std::string_view value);
+    /* decimals keep their point, 75 is written as 75.0 */
+    void WriteNumber(const char* name, double value);
+    void WriteInteger(const char* name, std::int64_t value);
+    void WriteBool(const char* name, bool value);
+    void WriteNull(const char* name);
+    /* closes the object, the line has no trailing newline */
+    const std::string& End();
+
+private:
+    void AppendName(const char* name);
+    void AppendString(std::string_view value);
+
+    std::string mLine;
+    bool bFirstField;
+};
+} // namespace app::common
@@ -0,0 +1,359 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif // defined(_MSC_VER)
+
+#include <nlohmann/json.hpp>
+
+namespace app::common
+{
+using json = nlohmann::ordered_json;
+
+namespace
+{
+/* index of the highest set bit, value must not be zero */
+unsigned int HighestBit(std::uint64_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return static_cast<unsigned int>(index);
+#else
+    return 63 - static_cast<unsigned int>(__builtin_clzll(value));
+#endif // defined(_MSC_VER)
+}
+} // namespace
+
+Counter::Counter()
+    : mValue(0)
+{
+}
+
+void Counter::Increment(std::uint64_t value)
+{
+    mValue.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t Counter::GetValue() const
+{
+    return mValue.load(std::memory_order_relaxed);
+}
+
+Gauge::Gauge()
+    : mValue(0)
+{
+}
+
+void Gauge::Set(std::int64_t value)
+{
+    mValue.store(value, std::memory_order_relaxed);
+}
+
+void Gauge::Add(std::int64_t value)
+{
+    mValue.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::int64_t Gauge::GetValue() const
+{
+    return mValue.load(std::memory_order_relaxed);
+}
+
+Histogram::Histogram()
+    : mBuckets()
+    , mCount(0)
+    , mSum(0)
+    , mMax(0)
+{
+    for (auto& bucket : mBuckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::Record(std::uint64_t microseconds)
+{
+    mBuckets[GetBucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(microseconds, std::memory_order_relaxed);
+
+    auto max = mMax.load(std::memory_order_relaxed);
+    while (microseconds > max && !mMax.compare_exchange_weak(max, microseconds, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t Histogram::GetCount() const
+{
+    return mCount.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::GetMax() const
+{
+    return mMax.load(std::memory_order_relaxed);
+}
+
+double Histogram::GetMean() const
+{
+    auto count = GetCount();
+    return count == 0 ? 0.0 : static_cast<double>(mSum.load(std::memory_order_relaxed)) / count;
+}
+
+std::uint64_t Histogram::GetPercentile(double percentile) const
+{
+    /* the buckets are read one by one while other threads record, sum them rather than trusting mCount */
+    std::array<std::uint64_t, BucketCount> counts;
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < BucketCount; i++) {
+        counts[i] = mBuckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    auto rank = static_cast<std::uint64_t>(percentile / 100.0 * total + 0.5);
+    rank = std::clamp<std::uint64_t>(rank, 1, total);
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BucketCount; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(GetBucketHighestValue(i), GetMax());
+        }
+    }
+
+    return GetMax();
+}
+
+std::size_t Histogram::GetBucketIndex(std::uint64_t value)
+{
+    if (value < SubBucketCount) {
+        return static_cast<std::size_t>(value);
+    }
+
+    /* the four bits below the highest set bit pick the sub-bucket */
+    auto exponent = HighestBit(value);
+    auto subBucket = static_cast<std::size_t>((value >> (exponent - 4)) & (SubBucketCount - 1));
+    auto index = SubBucketCount + (exponent - 4) * SubBucketCount + subBucket;
+
+    return std::min<std::size_t>(index, BucketCount - 1);
+}
+
+std::uint64_t Histogram::GetBucketHighestValue(std::size_t index)
+{
+    if (index < SubBucketCount) {
+        return index;
+    }
+
+    auto exponent = (index - SubBucketCount) / SubBucketCount + 4;
+    auto subBucket = (index - SubBucketCount) % SubBucketCount;
+    std::uint64_t width = std::uint64_t(1) << (exponent - 4);
+
+    return ((SubBucketCount + subBucket) << (exponent - 4)) + width - 1;
+}
+
+std::uint64_t MetricsSnapshot::GetCounter(const std::string& name) const
+{
+    for (const auto& counter : Counters) {
+        if (counter.Name == name) {
+            return counter.Value;
+        }
+    }
+
+    return 0;
+}
+
+std::int64_t MetricsSnapshot::GetGauge(const std::string& name) const
+{
+    for (const auto& gauge : Gauges) {
+        if (gauge.Name == name) {
+            return gauge.Value;
+        }
+    }
+
+    return 0;
+}
+
+std::string MetricsSnapshot::ToJson() const
+{
+    json counters = json::object();
+    for (const auto& counter : Counters) {
+        counters[counter.Name] = counter.Value;
+    }
+
+    json gauges = json::object();
+    for (const auto& gauge : Gauges) {
+        gauges[gauge.Name] = gauge.Value;
+    }
+
+    json histograms = json::object();
+    for (const auto& histogram : Histograms) {
+        histograms[histogram.Name] = json{ { "count", histogram.Count },
+            { "meanUs", histogram.MeanMicroseconds },
+            { "p50Us", histogram.P50Microseconds },
+            { "p95Us", histogram.P95Microseconds },
+            { "p99Us", histogram.P99Microseconds },
+            { "maxUs", histogram.MaxMicroseconds } };
+    }
+
+    json snapshot{ { "timestamp", TimestampMilliseconds },
+        { "counters", counters },
+        { "gauges", gauges },
+        { "histograms", histograms } };
+
+    return snapshot.dump(2, ' ', false, json::error_handler_t::replace);
+}
+
+const std::size_t MetricsRegistry::MaxQueryHistograms = 512;
+
+MetricsRegistry& MetricsRegistry::Get()
+{
+    static MetricsRegistry instance;
+    return instance;
+}
+
+MetricsRegistry::MetricsRegistry()
+    : mMutex()
+    , mCounters()
+    , mGauges()
+    , mHistograms()
+    , mQueryHistogramCount(0)
+{
+}
+
+Counter& MetricsRegistry::GetCounter(const std::string& name)
+{
+    return GetOrCreate(mCounters, name);
+}
+
+Gauge& MetricsRegistry::GetGauge(const std::string& name)
+{
+    return GetOrCreate(mGauges, name);
+}
+
+Histogram& MetricsRegistry::GetHistogram(const std::string& name)
+{
+    return GetOrCreate(mHistograms, name);
+}
+
+Histogram& MetricsRegistry::GetQueryHistogram(std::string_view statementText)
+{
+    auto name = MetricNames::QueryPrefix + std::string(statementText);
+    {
+        std::shared_lock<std::shared_mutex> lock(mMutex);
+        auto metric = mHistograms.find(name);
+        if (metric != mHistograms.end()) {
+            return *metric->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mMutex);
+    if (mHistograms.find(name) == mHistograms.end() && mQueryHistogramCount >= MaxQueryHistograms) {
+        name = MetricNames::QueryOther;
+    }
+
+    auto& metric = mHistograms[name];
+    if (metric == nullptr) {
+        metric = std::make_unique<Histogram>();
+        if (name != MetricNames::QueryOther) {
+            mQueryHistogramCount++;
+        }
+    }
+
+    return *metric;
+}
+
+Histogram& MetricsRegistry::GetQueryOtherHistogram()
+{
+    return GetOrCreate(mHistograms, MetricNames::QueryOther);
+}
+
+MetricsSnapshot MetricsRegistry::Snapshot()
+{
+    MetricsSnapshot snapshot;
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    snapshot.TimestampMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    for (const auto& [name, counter] : mCounters) {
+        snapshot.Counters.push_back({ name, counter->GetValue() });
+    }
+    for (const auto& [name, gauge] : mGauges) {
+        snapshot.Gauges.push_back({ name, gauge->GetValue() });
+    }
+    for (const auto& [name, histogram] : mHistograms) {
+        snapshot.Histograms.push_back({ name,
+            histogram->GetCount(),
+            histogram->GetMean(),
+            histogram->GetPercentile(50.0),
+            histogram->GetPercentile(95.0),
+            histogram->GetPercentile(99.0),
+            histogram->GetMax() });
+    }
+
+    return snapshot;
+}
+
+template<class T>
+T& MetricsRegistry::GetOrCreate(std::map<std::string, std::unique_ptr<T>>& metrics, const std::string& name)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(mMutex);
+        auto metric = metrics.find(name);
+        if (metric != metrics.end()) {
+            return *metric->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mMutex);
+    auto& metric = metrics[name];
+    if (metric == nullptr) {
+        metric = std::make_unique<T>();
+    }
+
+    return *metric;
+}
+
+const std::string MetricNames::PoolAcquired = "db.pool.acquired";
+const std::string MetricNames::PoolCreated = "db.pool.created";
+const std::string MetricNames::PoolInUse = "db.pool.in_use";
+const std::string MetricNames::PoolSize = "db.pool.size";
+const std::string MetricNames::PageCacheHits = "db.page_cache.hits";
+const std::string MetricNames::PageCacheMisses = "db.page_cache.misses";
+const std::string MetricNames::QueryPrefix = "db.query: ";
+const std::string MetricNames::QueryOther = "db.query: <other>";
+const std::string MetricNames::ExportPrefix = "export.";
+const std::string MetricNames::ExportBytes = "export.bytes";
+const std::string MetricNames::BackupPrefix = "backup.";
+const std::string MetricNames::BackupFailed = "backup.failed";
+const std::string MetricNames::BackupChunksWritten = "backup.chunks.written";
+const std::string MetricNames::BackupChunksReused = "backup.chunks.reused";
+const std::string MetricNames::StopwatchStarted = "stopwatch.started";
+const std::string MetricNames::StopwatchPaused = "stopwatch.paused";
+const std::string MetricNames::StopwatchStopped = "stopwatch.stopped";
+} // namespace app::common
@@ -0,0 +1,186 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace app::common
+{
+class Counter final
+{
+public:
+    Counter();
+
+    void Increment(std::uint64_t value = 1);
+    std::uint64_t GetValue() const;
+
+private:
+    std::atomic<std::uint64_t> mValue;
+};
+
+class Gauge final
+{
+public:
+    Gauge();
+
+    void Set(std::int64_t value);
+    void Add(std::int64_t value);
+    std::int64_t GetValue() const;
+
+private:
+    std::atomic<std::int64_t> mValue;
+};
+
+/*
+ Latency histogram in the spirit of HdrHistogram: every power of two is split into 16 linear sub-buckets, so a
+ recorded value is off by at most 1/16 (~6%) of itself, from one microsecond up to several days, in a fixed array of
+ atomic counters. Recording is a couple of relaxed atomic increments and never takes a lock.
+ */
+class Histogram final
+{
+public:
+    Histogram();
+
+    void Record(std::uint64_t microseconds);
+
+    std::uint64_t GetCount() const;
+    std::uint64_t GetMax() const;
+    double GetMean() const;
+    /* highest value equivalent to the given percentile (0 - 100), clamped to the largest recorded value */
+    std::uint64_t GetPercentile(double percentile) const;
+
+private:
+    /* values below 16 get a bucket each, then 16 buckets for each power of two from 2^4 up to 2^39 */
+    enum : std::size_t { SubBucketCount = 16, BucketCount = SubBucketCount + 36 * SubBucketCount };
+
+    static std::size_t GetBucketIndex(std::uint64_t value);
+    static std::uint64_t GetBucketHighestValue(std::size_t index);
+
+    std::array<std::atomic<std::uint64_t>, BucketCount> mBuckets;
+    std::atomic<std::uint64_t> mCount;
+    std::atomic<std::uint64_t> mSum;
+    std::atomic<std::uint64_t> mMax;
+};
+
+struct CounterSnapshot {
+    std::string Name;
+    std::uint64_t Value;
+};
+
+struct GaugeSnapshot {
+    std::string Name;
+    std::int64_t Value;
+};
+
+struct HistogramSnapshot {
+    std::string Name;
+    std::uint64_t Count;
+    double MeanMicroseconds;
+    std::uint64_t P50Microseconds;
+    std::uint64_t P95Microseconds;
+    std::uint64_t P99Microseconds;
+    std::uint64_t MaxMicroseconds;
+};
+
+struct MetricsSnapshot {
+    std::int64_t TimestampMilliseconds;
+    std::vector<CounterSnapshot> Counters;
+    std::vector<GaugeSnapshot> Gauges;
+    std::vector<HistogramSnapshot> Histograms;
+
+    std::uint64_t GetCounter(const std::string& name) const;
+    std::int64_t GetGauge(const std::string& name) const;
+    std::string ToJson() const;
+};
+
+/*
+ Process wide metrics by name. Metrics are created on first use and live until the process exits, so the returned
+ references can be kept. Looking a metric up takes a shared lock, code on a hot path should keep the reference.
+ */
+class MetricsRegistry final
+{
+public:
+    static MetricsRegistry& Get();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    Counter& GetCounter(const std::string& name);
+    Gauge& GetGauge(const std::string& name);
+    Histogram& GetHistogram(const std::string& name);
+    /*
+     Histogram of the given statement. Statements built with literal values would add a histogram each, past
+     MaxQueryHistograms further statements share the MetricNames::QueryOther histogram.
+     */
+    Histogram& GetQueryHistogram(std::string_view statementText);
+    /* the histogram further statements share once the registry holds MaxQueryHistograms of them */
+    Histogram& GetQueryOtherHistogram();
+
+    MetricsSnapshot Snapshot();
+
+    static const std::size_t MaxQueryHistograms;
+
+private:
+    MetricsRegistry();
+
+    template<class T>
+    T& GetOrCreate(std::map<std::string, std::unique_ptr<T>>& metrics, const std::string& name);
+
+    std::shared_mutex mMutex;
+    std::map<std::string, std::unique_ptr<Counter>> mCounters;
+    std::map<std::string, std::unique_ptr<Gauge>> mGauges;
+    std::map<std::string, std::unique_ptr<Histogram>> mHistograms;
+    std::size_t mQueryHistogramCount;
+};
+
+/* Names of the metrics fed by the application, the diagnostics dialog reads these */
+struct MetricNames {
+    static const std::string PoolAcquired;
+    static const std::string PoolCreated;
+    static const std::string PoolInUse;
+    static const std::string PoolSize;
+    static const std::string PageCacheHits;
+    static const std::string PageCacheMisses;
+    /* followed by the statement text */
+    static const std::string QueryPrefix;
+    /* shared by the statements seen after the query histograms are capped */
+    static const std::string QueryOther;
+    /* followed by the export format */
+    static const std::string ExportPrefix;
+    static const std::string ExportBytes;
+    /* followed by the backup mode */
+    static const std::string BackupPrefix;
+    static const std::string BackupFailed;
+    static const std::string BackupChunksWritten;
+    static const std::string BackupChunksReused;
+    static const std::string StopwatchStarted;
+    static const std::string StopwatchPaused;
+    static const std::string StopwatchStopped;
+};
+} // namespace app::common
@@ -0,0 +1,113 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "perflog.h"
+
+#include <chrono>
+
+#include "jsonlinewriter.h"
+
+namespace app::common
+{
+namespace
+{
+/* events are recorded from any thread, each one reuses its own line buffer */
+JsonLineWriter& BeginEvent(const char* name)
+{
+    thread_local JsonLineWriter writer;
+
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    writer.Begin();
+    writer.WriteInteger("ts", std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+    writer.WriteString("event", name);
+    return writer;
+}
+} // namespace
+
+const char* const PerfLog::LoggerName = "perf";
+const double PerfLog::SlowQueryMilliseconds = 1.0;
+
+PerfLog& PerfLog::Get()
+{
+    static PerfLog instance;
+    return instance;
+}
+
+PerfLog::PerfLog()
+    : bEnabled(false)
+    , pLogger(nullptr)
+    , pThreadPool(nullptr)
+{
+}
+
+void PerfLog::Initialize(std::shared_ptr<spdlog::logger> logger,
+    std::shared_ptr<spdlog::details::thread_pool> threadPool)
+{
+    /* called once during startup, before any thread that records events is started */
+    pThreadPool = threadPool;
+    pLogger = logger;
+    bEnabled.store(pLogger != nullptr, std::memory_order_release);
+}
+
+bool PerfLog::IsEnabled() const
+{
+    return bEnabled.load(std::memory_order_acquire);
+}
+
+void PerfLog::RecordQuery(const char* sql, double durationMilliseconds)
+{
+    if (durationMilliseconds < SlowQueryMilliseconds || !IsEnabled()) {
+        return;
+    }
+
+    auto& event = BeginEvent("query");
+    /* the statement text may contain anything, the writer replaces invalid UTF-8 instead of throwing */
+    event.WriteString("sql", sql != nullptr ? sql : "");
+    event.WriteNumber("durationMs", durationMilliseconds);
+    pLogger->info(event.End());
+}
+
+void PerfLog::RecordExport(const std::string& format, std::uintmax_t bytes, double durationMilliseconds, bool success)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+
+    auto& event = BeginEvent("export");
+    event.WriteString("format", format);
+    event.WriteInteger("bytes", static_cast<std::int64_t>(bytes));
+    event.WriteNumber("durationMs", durationMilliseconds);
+    event.WriteNumber("bytesPerSecond", durationMilliseconds > 0.0 ? bytes * 1000.0 / durationMilliseconds : 0.0);
+    event.WriteBool("success", success);
+    pLogger->info(event.End());
+}
+
+void PerfLog::RecordBackup(const std::string& mode, double durationMilliseconds, bool success)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+
+    auto& event = BeginEvent("backup");
+    event.WriteString("mode", mode);
+    event.WriteNumber("durationMs", durationMilliseconds);
+    event.WriteBool("success", success);
+    pLogger->info(event.End());
+}
+} // namespace app::common
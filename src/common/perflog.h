@@ -0,0 +1,67 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <spdlog/spdlog.h>
+#include <spdlog/async.h>
+
+namespace app::common
+{
+/*
+ Writes performance events as one JSON object per line to a dedicated logger so they can be analysed offline,
+ e.g. with jq or pandas. Every event carries the wall clock time in milliseconds and its name, the remaining
+ fields depend on the event. Nothing is recorded until Initialize hands over the logger.
+
+ The logger gets a thread pool of its own, a burst of events (a migration, seeding, the benchmarks) can only
+ overrun older events and never the application log's messages. Only queries taking at least
+ SlowQueryMilliseconds are recorded, the per statement histograms cover the rest.
+ */
+class PerfLog final
+{
+public:
+    static PerfLog& Get();
+
+    PerfLog(const PerfLog&) = delete;
+    PerfLog& operator=(const PerfLog&) = delete;
+
+    /* the thread pool is kept alive here, the async logger only holds a weak reference to it */
+    void Initialize(std::shared_ptr<spdlog::logger> logger, std::shared_ptr<spdlog::details::thread_pool> threadPool);
+    bool IsEnabled() const;
+
+    void RecordQuery(const char* sql, double durationMilliseconds);
+    void RecordExport(const std::string& format, std::uintmax_t bytes, double durationMilliseconds, bool success);
+    void RecordBackup(const std::string& mode, double durationMilliseconds, bool success);
+
+    static const char* const LoggerName;
+    static const double SlowQueryMilliseconds;
+
+private:
+    PerfLog();
+
+    std::atomic<bool> bEnabled;
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::shared_ptr<spdlog::details::thread_pool> pThreadPool;
+};
+} // namespace app::common
@@ -0,0 +1,189 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "sha256.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace app::common
+{
+namespace
+{
+const std::uint32_t RoundConstants[64] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7,
+    0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85,
+    0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c,
+    0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+inline std::uint32_t RotateRight(std::uint32_t value, int count)
+{
+    return (value >> count) | (value << (32 - count));
+}
+} // namespace
+
+Sha256::Sha256()
+    : mState{ 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 }
+    , mBuffer()
+    , mBufferLength(0)
+    , mTotalLength(0)
+{
+}
+
+void Sha256::Update(const void* data, std::size_t length)
+{
+    auto bytes = static_cast<const std::uint8_t*>(data);
+    mTotalLength += length;
+
+    if (mBufferLength > 0) {
+        std::size_t toCopy = std::min(length, mBuffer.size() - mBufferLength);
+        std::memcpy(mBuffer.data() + mBufferLength, bytes, toCopy);
+        mBufferLength += toCopy;
+        bytes += toCopy;
+        length -= toCopy;
+
+        if (mBufferLength < mBuffer.size()) {
+            return;
+        }
+        Transform(mBuffer.data());
+        mBufferLength = 0;
+    }
+
+    while (length >= mBuffer.size()) {
+        Transform(bytes);
+        bytes += mBuffer.size();
+        length -= mBuffer.size();
+    }
+
+    std::memcpy(mBuffer.data(), bytes, length);
+    mBufferLength = length;
+}
+
+std::string Sha256::HexDigest()
+{
+    std::uint64_t totalBits = mTotalLength * 8;
+
+    /* pad with 0x80, zeros and the message length in bits so the input is a multiple of 64 bytes */
+    const std::uint8_t padding = 0x80;
+    Update(&padding, 1);
+    const std::uint8_t zero = 0;
+    while (mBufferLength != 56) {
+        Update(&zero, 1);
+    }
+
+    std::uint8_t lengthBytes[8];
+    for (int i = 0; i < 8; i++) {
+        lengthBytes[i] = static_cast<std::uint8_t>(totalBits >> (56 - i * 8));
+    }
+    Update(lengthBytes, sizeof(lengthBytes));
+
+    static const char HexDigits[] = "0123456789abcdef";
+    std::string digest;
+    digest.reserve(64);
+    for (auto word : mState) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            digest += HexDigits[(word >> shift) & 0x0f];
+        }
+    }
+    return digest;
+}
+
+std::string Sha256::Hash(const void* data, std::size_t length)
+{
+    Sha256 sha256;
+    sha256.Update(data, length);
+    return sha256.HexDigest();
+}
+
+std::string Sha256::HashFile(const std::string& filePath)
+{
+    auto file = std::unique_ptr<std::FILE, decltype(&std::fclose)>(std::fopen(filePath.c_str(), "rb"), std::fclose);
+    if (!file) {
+        return "";
+    }
+
+    Sha256 sha256;
+    std::vector<char> buffer(256 * 1024);
+    std::size_t read = 0;
+    while ((read = std::fread(buffer.data(), 1, buffer.size(), file.get())) > 0) {
+        sha256.Update(buffer.data(), read);
+    }
+    return std::ferror(file.get()) ? "" : sha256.HexDigest();
+}
+
+void Sha256::Transform(const std::uint8_t* block)
+{
+    std::uint32_t schedule[64];
+    for (int i = 0; i < 16; i++) {
+        schedule[i] = (static_cast<std::uint32_t>(block[i * 4]) << 24) |
+                      (static_cast<std::uint32_t>(block[i * 4 + 1]) << 16) |
+                      (static_cast<std::uint32_t>(block[i * 4 + 2]) << 8) |
+                      static_cast<std::uint32_t>(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 64; i++) {
+        std::uint32_t s0 =
+            RotateRight(schedule[i - 15], 7) ^ RotateRight(schedule[i - 15], 18) ^ (schedule[i - 15] >> 3);
+        std::uint32_t s1 =
+            RotateRight(schedule[i - 2], 17) ^ RotateRight(schedule[i - 2], 19) ^ (schedule[i - 2] >> 10);
+        schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+    }
+
+    std::uint32_t a = mState[0];
+    std::uint32_t b = mState[1];
+    std::uint32_t c = mState[2];
+    std::uint32_t d = mState[3];
+    std::uint32_t e = mState[4];
+    std::uint32_t f = mState[5];
+    std::uint32_t g = mState[6];
+    std::uint32_t h = mState[7];
+
+    for (int i = 0; i < 64; i++) {
+        std::uint32_t s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+        std::uint32_t choice = (e & f) ^ (~e & g);
+        std::uint32_t temp1 = h + s1 + choice + RoundConstants[i] + schedule[i];
+        std::uint32_t s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+        std::uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        std::uint32_t temp2 = s0 + majority;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+
+    mState[0] += a;
+    mState[1] += b;
+    mState[2] += c;
+    mState[3] += d;
+    mState[4] += e;
+    mState[5] += f;
+    mState[6] += g;
+    mState[7] += h;
+}
+} // namespace app::common
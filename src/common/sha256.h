@@ -0,0 +1,51 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace app::common
+{
+/* FIPS 180-4 SHA-256, used to address and verify backup contents */
+class Sha256 final
+{
+public:
+    Sha256();
+    ~Sha256() = default;
+
+    void Update(const void* data, std::size_t length);
+    std::string HexDigest();
+
+    static std::string Hash(const void* data, std::size_t length);
+    /* empty when the file cannot be read */
+    static std::string HashFile(const std::string& filePath);
+
+private:
+    void Transform(const std::uint8_t* block);
+
+    std::array<std::uint32_t, 8> mState;
+    std::array<std::uint8_t, 64> mBuffer;
+    std::size_t mBufferLength;
+    std::uint64_t mTotalLength;
+};
+} // namespace app::common
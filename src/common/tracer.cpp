@@ -0,0 +1,188 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "tracer.h"
+
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+namespace app::common
+{
+const std::size_t Tracer::Capacity = 8192;
+
+Tracer& Tracer::Get()
+{
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::Tracer()
+    : bEnabled(false)
+    , mEpoch(std::chrono::steady_clock::now())
+    , mTraceFilePath()
+    , mMutex()
+    , mEvents()
+    , mNextEvent(0)
+    , mDroppedEvents(0)
+{
+}
+
+void Tracer::Enable(const std::string& traceFilePath)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTraceFilePath = traceFilePath;
+    mEvents.reserve(Capacity);
+    bEnabled.store(true, std::memory_order_release);
+}
+
+bool Tracer::IsEnabled() const
+{
+    return bEnabled.load(std::memory_order_relaxed);
+}
+
+std::int64_t Tracer::Now() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mEpoch)
+        .count();
+}
+
+void Tracer::Record(const char* name, std::int64_t startMicroseconds, std::int64_t durationMicroseconds)
+{
+    Append({ name, startMicroseconds, durationMicroseconds, GetThreadId(), false });
+}
+
+std::int64_t Tracer::Mark(const char* name)
+{
+    auto now = Now();
+    if (IsEnabled()) {
+        Append({ name, now, 0, GetThreadId(), true });
+    }
+
+    return now;
+}
+
+std::vector<TraceEvent> Tracer::GetEvents()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::vector<TraceEvent> events;
+    events.reserve(mEvents.size());
+    events.insert(events.end(), mEvents.begin() + mNextEvent, mEvents.end());
+    events.insert(events.end(), mEvents.begin(), mEvents.begin() + mNextEvent);
+    return events;
+}
+
+bool Tracer::Write()
+{
+    if (!IsEnabled() || mTraceFilePath.empty()) {
+        return false;
+    }
+
+    auto events = GetEvents();
+    std::size_t droppedEvents = 0;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        droppedEvents = mDroppedEvents;
+    }
+
+    nlohmann::json traceEvents = nlohmann::json::array();
+    traceEvents.push_back({ { "name", "process_name" },
+        { "ph", "M" },
+        { "pid", 1 },
+        { "args", { { "name", "Taskable" } } } });
+    for (const auto& event : events) {
+        if (event.Instant) {
+            traceEvents.push_back({ { "name", event.Name },
+                { "cat", "taskable" },
+                { "ph", "i" },
+                { "s", "g" },
+                { "ts", event.StartMicroseconds },
+                { "pid", 1 },
+                { "tid", event.ThreadId } });
+            continue;
+        }
+
+        traceEvents.push_back({ { "name", event.Name },
+            { "cat", "taskable" },
+            { "ph", "X" },
+            { "ts", event.StartMicroseconds },
+            { "dur", event.DurationMicroseconds },
+            { "pid", 1 },
+            { "tid", event.ThreadId } });
+    }
+
+    nlohmann::json trace = { { "traceEvents", traceEvents },
+        { "displayTimeUnit", "ms" },
+        { "otherData", { { "dropped_events", droppedEvents } } } };
+
+    std::ofstream traceFile(mTraceFilePath, std::ios::out | std::ios::trunc);
+    if (!traceFile) {
+        return false;
+    }
+
+    traceFile << trace.dump();
+    return static_cast<bool>(traceFile);
+}
+
+const std::string& Tracer::GetTraceFilePath() const
+{
+    return mTraceFilePath;
+}
+
+void Tracer::Append(const TraceEvent& event)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mEvents.size() < Capacity) {
+        mEvents.push_back(event);
+        return;
+    }
+
+    mEvents[mNextEvent] = event;
+    mNextEvent = (mNextEvent + 1) % Capacity;
+    mDroppedEvents++;
+}
+
+std::uint32_t Tracer::GetThreadId()
+{
+    /* small sequential ids read better in the trace viewer than hashed std::thread::id values */
+    static std::atomic<std::uint32_t> NextThreadId(1);
+    thread_local std::uint32_t threadId = NextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return threadId;
+}
+
+TraceSpan::TraceSpan(const char* name)
+    : pName(name)
+    , mStartMicroseconds(-1)
+{
+    auto& tracer = Tracer::Get();
+    if (tracer.IsEnabled()) {
+        mStartMicroseconds = tracer.Now();
+    }
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (mStartMicroseconds < 0) {
+        return;
+    }
+
+    auto& tracer = Tracer::Get();
+    tracer.Record(pName, mStartMicroseconds, tracer.Now() - mStartMicroseconds);
+}
+} // namespace app::common
@@ -0,0 +1,102 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace app::common
+{
+struct TraceEvent {
+    /* string literals, the tracer does not copy names */
+    const char* Name;
+    std::int64_t StartMicroseconds;
+    std::int64_t DurationMicroseconds;
+    std::uint32_t ThreadId;
+    /* a point in time such as the first paint rather than a span */
+    bool Instant;
+};
+
+/*
+ Collects timed spans into a fixed size ring buffer and writes them as Chrome trace event JSON, which
+ chrome://tracing and https://ui.perfetto.dev can open. Tracing is off unless Enable is called, while off
+ a TraceSpan costs one relaxed atomic load and nothing is allocated.
+ */
+class Tracer final
+{
+public:
+    static Tracer& Get();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    void Enable(const std::string& traceFilePath);
+    bool IsEnabled() const;
+
+    std::int64_t Now() const;
+    void Record(const char* name, std::int64_t startMicroseconds, std::int64_t durationMicroseconds);
+    /* records an instant event when enabled, returns the time either way */
+    std::int64_t Mark(const char* name);
+
+    /* oldest event first, once the buffer is full the oldest events are overwritten */
+    std::vector<TraceEvent> GetEvents();
+    bool Write();
+
+    const std::string& GetTraceFilePath() const;
+
+    static const std::size_t Capacity;
+
+private:
+    Tracer();
+
+    void Append(const TraceEvent& event);
+
+    static std::uint32_t GetThreadId();
+
+    std::atomic<bool> bEnabled;
+    std::chrono::steady_clock::time_point mEpoch;
+    std::string mTraceFilePath;
+
+    std::mutex mMutex;
+    std::vector<TraceEvent> mEvents;
+    std::size_t mNextEvent;
+    std::size_t mDroppedEvents;
+};
+
+/* Records the time between construction and destruction under the given name */
+class TraceSpan final
+{
+public:
+    explicit TraceSpan(const char* name);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* pName;
+    std::int64_t mStartMicroseconds;
+};
+} // namespace app::common
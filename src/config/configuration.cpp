@@ -19,11 +19,11 @@
 
 #include "configuration.h"
 
-#include <fstream>
+#include <exception>
+#include <tuple>
 
-#include <wx/stdpaths.h>
-
-#include "../common/common.h"
+#include "../common/paths.h"
+#include "../common/sha256.h"
 #include "../common/util.h"
 
 namespace app::cfg
@@ -35,350 +35,645 @@ const std::string Configuration::Sections::TaskItemSection = "task_item";
 const std::string Configuration::Sections::PersistenceSection = "persistence";
 const std::string Configuration::Sections::ExportSection = "export";
 
-Configuration::Configuration()
-    : mSettings()
+bool ConfigurationChanges::Any() const
 {
-    LoadConfigFile();
+    return General || DatabasePath || ConnectionPoolSize || Backup || BackupSchedule || Stopwatch || TaskItem ||
+           Persistence || Export;
+}
+
+Configuration::Configuration(std::shared_ptr<spdlog::logger> logger)
+    : Configuration(logger, common::GetConfigFilePath().ToStdString())
+{
+}
+
+Configuration::Configuration(std::shared_ptr<spdlog::logger> logger, const std::string& configFilePath)
+    : Configuration(logger, configFilePath, ConfigurationWriter::DefaultDebounceWindow)
+{
+}
+
+Configuration::Configuration(std::shared_ptr<spdlog::logger> logger,
+    const std::string& configFilePath,
+    std::chrono::milliseconds debounceWindow)
+    : mConfigFilePath(configFilePath)
+    , mMutex()
+    , mSettings()
+    , pWriter(std::make_unique<ConfigurationWriter>(logger, configFilePath, debounceWindow))
+{
+    LoadConfigFile(mSettings);
+    mContentHash = common::Sha256::HashFile(mConfigFilePath);
 }
 
-// clang-format off
 void Configuration::Save()
+{
+    /* snapshot the settings, the worker serializes the copy while the caller keeps changing the original */
+    pWriter->Schedule([settings = mSettings]() { return Serialize(settings); });
+}
+
+bool Configuration::Flush()
+{
+    return pWriter->Flush();
+}
+
+int Configuration::GetWriteCount()
+{
+    return pWriter->GetWriteCount();
+}
+
+bool Configuration::Reload(ConfigurationChanges& changes)
+{
+    changes = ConfigurationChanges();
+
+    /* a pending write is about to replace the file with the settings in memory, let it win */
+    if (pWriter->IsWritePending()) {
+        return true;
+    }
+
+    /* our own writes are not edits, take the content they produced as the loaded content */
+    const std::string writtenHash = pWriter->GetLastWrittenHash();
+    if (writtenHash != mWrittenHash) {
+        mWrittenHash = writtenHash;
+        mContentHash = writtenHash;
+    }
+
+    /* watchers report several events per save, only a different content is worth parsing */
+    const std::string contentHash = common::Sha256::HashFile(mConfigFilePath);
+    if (contentHash.empty() || contentHash == mContentHash) {
+        return true;
+    }
+
+    /* parsed into a copy, background threads never see a partly loaded configuration */
+    Settings loaded = mSettings;
+    try {
+        LoadConfigFile(loaded);
+    } catch (const std::exception&) {
+        /* e.g. an editor that truncates the file before writing it, the next change event retries */
+        return false;
+    }
+
+    const Settings previous = mSettings;
+    {
+        std::lock_guard<std::shared_mutex> lock(mMutex);
+        mSettings = loaded;
+    }
+
+    mContentHash = contentHash;
+    changes = Compare(previous, loaded);
+    return true;
+}
+
+// clang-format off
+std::string Configuration::Serialize(const Settings& settings)
 {
     // TODO, refactor this to be more maintainable
     const toml::value data{
         {
             Sections::GeneralSection,
             {
-                { "confirmOnExit", mSettings.ConfirmOnExit },
-                { "startOnBoot", mSettings.StartOnBoot },
-                { "showInTray", mSettings.ShowInTray },
-                { "minimizeToTray", mSettings.MinimizeToTray },
-                { "closeToTray", mSettings.CloseToTray },
+                { "confirmOnExit", settings.ConfirmOnExit },
+                { "startOnBoot", settings.StartOnBoot },
+                { "showInTray", settings.ShowInTray },
+                { "minimizeToTray", settings.MinimizeToTray },
+                { "closeToTray", settings.CloseToTray },
             }
         },
         {
             Sections::DatabaseSection,
             {
-                { "databasePath", mSettings.DatabasePath },
-                { "backupEnabled", mSettings.BackupEnabled },
-                { "backupPath", mSettings.BackupPath },
-                { "deleteBackupsAfter", mSettings.DeleteBackupsAfter }
+                { "databasePath", settings.DatabasePath },
+                { "connectionPoolSize", settings.ConnectionPoolSize },
+                { "backupEnabled", settings.BackupEnabled },
+                { "backupPath", settings.BackupPath },
+                { "deleteBackupsAfter", settings.DeleteBackupsAfter },
+                { "compressBackups", settings.CompressBackups },
+                { "incrementalBackups", settings.IncrementalBackups },
+                { "backupInterval", settings.BackupInterval },
+                { "backupIdleDelay", settings.BackupIdleDelay },
+                { "keepDailyBackups", settings.KeepDailyBackups },
+                { "keepWeeklyBackups", settings.KeepWeeklyBackups },
+                { "keepMonthlyBackups", settings.KeepMonthlyBackups },
+                { "keepYearlyBackups", settings.KeepYearlyBackups }
             }
         },
         {
             Sections::StopwatchSection,
             {
-                { "minimizeStopwatchWindow", mSettings.MinimizeStopwatchWindow },
-                { "hideWindowTimer", mSettings.HideWindowTimerInterval },
-                { "notificationTimer", mSettings.NotificationTimerInterval },
-                { "pausedTaskReminder", mSettings.PausedTaskReminderInterval },
-                { "startStopwatchOnLaunch", mSettings.StartStopwatchOnLaunch },
-                { "startStopwatchOnResume", mSettings.StartStopwatchOnResume },
+                { "minimizeStopwatchWindow", settings.MinimizeStopwatchWindow },
+                { "hideWindowTimer", settings.HideWindowTimerInterval },
+                { "notificationTimer", settings.NotificationTimerInterval },
+                { "pausedTaskReminder", settings.PausedTaskReminderInterval },
+                { "startStopwatchOnLaunch", settings.StartStopwatchOnLaunch },
+                { "startStopwatchOnResume", settings.StartStopwatchOnResume },
             }
         },
         {
             Sections::TaskItemSection,
             {
-                { "timeRounding", mSettings.TimeRounding },
-                { "timeToRoundTo", mSettings.TimeToRoundTo }
+                { "timeRounding", settings.TimeRounding },
+                { "timeToRoundTo", settings.TimeToRoundTo }
             }
         },
         {
             Sections::PersistenceSection,
             {
-                { "dimensions", mSettings.Dimension }
+                { "dimensions", settings.Dimension }
             }
         },
         {
             Sections::ExportSection,
             {
-                { "delimiter", mSettings.Delimiter },
-                { "exportPath", mSettings.ExportPath }
+                { "delimiter", settings.Delimiter },
+                { "exportPath", settings.ExportPath }
             }
         }
     };
 
-    const std::string configString = toml::format(data);
-
-    const std::string configFilePath = common::GetConfigFilePath().ToStdString();
-    std::ofstream configFile;
-    configFile.open(configFilePath, std::ios_base::out);
-    if (!configFile)
-    {
-         // log error
-        return;
-    }
-
-    configFile << configString;
-
-    configFile.close();
+    return toml::format(data);
 }
 // clang-format on
 
+ConfigurationChanges Configuration::Compare(const Settings& previous, const Settings& current)
+{
+    ConfigurationChanges changes;
+
+    changes.General = std::tie(previous.ConfirmOnExit,
+                          previous.StartOnBoot,
+                          previous.ShowInTray,
+                          previous.MinimizeToTray,
+                          previous.CloseToTray) !=
+                      std::tie(current.ConfirmOnExit,
+                          current.StartOnBoot,
+                          current.ShowInTray,
+                          current.MinimizeToTray,
+                          current.CloseToTray);
+
+    changes.DatabasePath = previous.DatabasePath != current.DatabasePath;
+    changes.ConnectionPoolSize = previous.ConnectionPoolSize != current.ConnectionPoolSize;
+
+    changes.Backup = std::tie(previous.BackupPath,
+                         previous.DeleteBackupsAfter,
+                         previous.CompressBackups,
+                         previous.IncrementalBackups,
+                         previous.KeepDailyBackups,
+                         previous.KeepWeeklyBackups,
+                         previous.KeepMonthlyBackups,
+                         previous.KeepYearlyBackups) !=
+                     std::tie(current.BackupPath,
+                         current.DeleteBackupsAfter,
+                         current.CompressBackups,
+                         current.IncrementalBackups,
+                         current.KeepDailyBackups,
+                         current.KeepWeeklyBackups,
+                         current.KeepMonthlyBackups,
+                         current.KeepYearlyBackups);
+    changes.BackupSchedule =
+        std::tie(previous.BackupEnabled, previous.BackupInterval, previous.BackupIdleDelay) !=
+        std::tie(current.BackupEnabled, current.BackupInterval, current.BackupIdleDelay);
+
+    changes.Stopwatch = std::tie(previous.MinimizeStopwatchWindow,
+                            previous.HideWindowTimerInterval,
+                            previous.NotificationTimerInterval,
+                            previous.PausedTaskReminderInterval,
+                            previous.StartStopwatchOnLaunch,
+                            previous.StartStopwatchOnResume) !=
+                        std::tie(current.MinimizeStopwatchWindow,
+                            current.HideWindowTimerInterval,
+                            current.NotificationTimerInterval,
+                            current.PausedTaskReminderInterval,
+                            current.StartStopwatchOnLaunch,
+                            current.StartStopwatchOnResume);
+
+    changes.TaskItem = std::tie(previous.TimeRounding, previous.TimeToRoundTo) !=
+                       std::tie(current.TimeRounding, current.TimeToRoundTo);
+    changes.Persistence = previous.Dimension != current.Dimension;
+    changes.Export =
+        std::tie(previous.Delimiter, previous.ExportPath) != std::tie(current.Delimiter, current.ExportPath);
+
+    return changes;
+}
+
 bool Configuration::IsConfirmOnExit() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.ConfirmOnExit;
 }
 
 bool Configuration::IsStartOnBoot() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.StartOnBoot;
 }
 
 bool Configuration::IsShowInTray() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.ShowInTray;
 }
 
 bool Configuration::IsMinimizeToTray() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.MinimizeToTray;
 }
 
 bool Configuration::IsCloseToTray() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.CloseToTray;
 }
 
 std::string Configuration::GetDatabasePath() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.DatabasePath;
 }
 
+int Configuration::GetConnectionPoolSize() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mSettings.ConnectionPoolSize;
+}
+
 bool Configuration::IsBackupEnabled() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.BackupEnabled;
 }
 
 std::string Configuration::GetBackupPath() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.BackupPath;
 }
 
 int Configuration::GetDeleteBackupsAfter() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.DeleteBackupsAfter;
 }
 
+bool Configuration::IsCompressBackups() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mSettings.CompressBackups;
+}
+
+bool Configuration::IsIncrementalBackups() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mSettings.IncrementalBackups;
+}
+
+int Configuration::GetBackupInterval() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mSettings.BackupInterval;
+}
+
+int Configuration::GetBackupIdleDelay() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mSettings.BackupIdleDelay;
+}
+
+int Configuration::GetKeepDailyBackups() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mSettings.KeepDailyBackups;
+}
+
+int Configuration::GetKeepWeeklyBackups() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mSettings.KeepWeeklyBackups;
+}
+
+int Configuration::GetKeepMonthlyBackups() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mSettings.KeepMonthlyBackups;
+}
+
+int Configuration::GetKeepYearlyBackups() const
+{
+    std::shared_lock<std::shared_mutex> lock(mMutex);
+    return mSettings.KeepYearlyBackups;
+}
+
 bool Configuration::IsMinimizeStopwatchWindow() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.MinimizeStopwatchWindow;
 }
 
 int Configuration::GetHideWindowTimerInterval() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.HideWindowTimerInterval;
 }
 
 int Configuration::GetNotificationTimerInterval() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.NotificationTimerInterval;
 }
 
 int Configuration::GetPausedTaskReminderInterval() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.PausedTaskReminderInterval;
 }
 
 bool Configuration::IsStartStopwatchOnLaunch() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.StartStopwatchOnLaunch;
 }
 
 bool Configuration::IsStartStopwatchOnResume() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.StartStopwatchOnResume;
 }
 
 bool Configuration::IsTimeRoundingEnabled() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.TimeRounding;
 }
 
 int Configuration::GetTimeToRoundTo() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.TimeToRoundTo;
 }
 
 std::string Configuration::GetFrameSize() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.Dimension;
 }
 
 std::string Configuration::GetDelimiter() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.Delimiter;
 }
 
 std::string Configuration::GetExportPath() const
 {
+    std::shared_lock<std::shared_mutex> lock(mMutex);
     return mSettings.ExportPath;
 }
 
 void Configuration::SetConfirmOnExit(bool value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.ConfirmOnExit = value;
 }
 
 void Configuration::SetStartOnBoot(bool value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.StartOnBoot = value;
 }
 
 void Configuration::SetShowInTray(bool value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.ShowInTray = value;
 }
 
 void Configuration::SetMinimizeToTray(bool value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.MinimizeToTray = value;
 }
 
 void Configuration::SetCloseToTray(bool value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.CloseToTray = value;
 }
 
 void Configuration::SetDatabasePath(const std::string& value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.DatabasePath = value;
 }
 
+void Configuration::SetConnectionPoolSize(int value)
+{
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.ConnectionPoolSize = value;
+}
+
 void Configuration::SetBackupEnabled(bool value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.BackupEnabled = value;
 }
 
 void Configuration::SetBackupPath(const std::string& value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.BackupPath = value;
 }
 
 void Configuration::SetDeleteBackupsAfter(int value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.DeleteBackupsAfter = value;
 }
 
+void Configuration::SetCompressBackups(bool value)
+{
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.CompressBackups = value;
+}
+
+void Configuration::SetIncrementalBackups(bool value)
+{
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.IncrementalBackups = value;
+}
+
+void Configuration::SetBackupInterval(int value)
+{
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.BackupInterval = value;
+}
+
+void Configuration::SetBackupIdleDelay(int value)
+{
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.BackupIdleDelay = value;
+}
+
+void Configuration::SetKeepDailyBackups(int value)
+{
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.KeepDailyBackups = value;
+}
+
+void Configuration::SetKeepWeeklyBackups(int value)
+{
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.KeepWeeklyBackups = value;
+}
+
+void Configuration::SetKeepMonthlyBackups(int value)
+{
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.KeepMonthlyBackups = value;
+}
+
+void Configuration::SetKeepYearlyBackups(int value)
+{
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.KeepYearlyBackups = value;
+}
+
 void Configuration::SetMinimizeStopwatchWindow(bool value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.MinimizeStopwatchWindow = value;
 }
 
 void Configuration::SetHideWindowTimerInterval(int value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.HideWindowTimerInterval = value;
 }
 
 void Configuration::SetNotificationTimerInterval(int value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.NotificationTimerInterval = value;
 }
 
 void Configuration::SetPausedTaskReminderInterval(int value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.PausedTaskReminderInterval = value;
 }
 
 void Configuration::SetStartStopwatchOnLaunch(bool value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.StartStopwatchOnLaunch = value;
 }
 
 void Configuration::SetStartStopwatchOnResume(bool value)
 {
-    mSettings.StartStopwatchOnResume;
+    std::lock_guard<std::shared_mutex> lock(mMutex);
+    mSettings.StartStopwatchOnResume = value;
 }
 
 void Configuration::SetTimeRounding(bool value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.TimeRounding = value;
 }
 
 void Configuration::SetTimeToRoundTo(int value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.TimeToRoundTo = value;
 }
 
 void Configuration::SetFrameSize(const std::string& value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.Dimension = value;
 }
 
 void Configuration::SetDelimiter(const std::string& value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.Delimiter = value;
 }
 
 void Configuration::SetExportPath(const std::string& value)
 {
+    std::lock_guard<std::shared_mutex> lock(mMutex);
     mSettings.ExportPath = value;
 }
 
-void Configuration::LoadConfigFile()
+void Configuration::LoadConfigFile(Settings& settings)
 {
-    auto data = toml::parse(common::GetConfigFilePath());
+    auto data = toml::parse(mConfigFilePath);
 
-    GetGeneralConfig(data);
-    GetDatabaseConfig(data);
-    GetStopwatchConfig(data);
-    GetTaskItemConfig(data);
-    GetPersistenceConfig(data);
-    GetExportConfig(data);
+    GetGeneralConfig(data, settings);
+    GetDatabaseConfig(data, settings);
+    GetStopwatchConfig(data, settings);
+    GetTaskItemConfig(data, settings);
+    GetPersistenceConfig(data, settings);
+    GetExportConfig(data, settings);
 }
 
-void Configuration::GetGeneralConfig(const toml::value& config)
+void Configuration::GetGeneralConfig(const toml::value& config, Settings& settings)
 {
     const auto& generalSection = toml::find(config, Sections::GeneralSection);
 
-    mSettings.ConfirmOnExit = toml::find<bool>(generalSection, "confirmOnExit");
-    mSettings.StartOnBoot = toml::find<bool>(generalSection, "startOnBoot");
-    mSettings.ShowInTray = toml::find<bool>(generalSection, "showInTray");
-    mSettings.MinimizeToTray = toml::find<bool>(generalSection, "minimizeToTray");
-    mSettings.CloseToTray = toml::find<bool>(generalSection, "closeToTray");
+    settings.ConfirmOnExit = toml::find<bool>(generalSection, "confirmOnExit");
+    settings.StartOnBoot = toml::find<bool>(generalSection, "startOnBoot");
+    settings.ShowInTray = toml::find<bool>(generalSection, "showInTray");
+    settings.MinimizeToTray = toml::find<bool>(generalSection, "minimizeToTray");
+    settings.CloseToTray = toml::find<bool>(generalSection, "closeToTray");
 }
 
-void Configuration::GetDatabaseConfig(const toml::value& config)
+void Configuration::GetDatabaseConfig(const toml::value& config, Settings& settings)
 {
     const auto& databaseSection = toml::find(config, Sections::DatabaseSection);
 
-    mSettings.DatabasePath = toml::find<std::string>(databaseSection, "databasePath");
-    mSettings.BackupEnabled = toml::find<bool>(databaseSection, "backupEnabled");
-    mSettings.BackupPath = toml::find<std::string>(databaseSection, "backupPath");
-    mSettings.DeleteBackupsAfter = toml::find<int>(databaseSection, "deleteBackupsAfter");
-}
-
-void Configuration::GetStopwatchConfig(const toml::value& config)
+    settings.DatabasePath = toml::find<std::string>(databaseSection, "databasePath");
+    /* added with configuration reloading, existing configuration files do not have it */
+    settings.ConnectionPoolSize = toml::find_or<int>(databaseSection, "connectionPoolSize", 14);
+    settings.BackupEnabled = toml::find<bool>(databaseSection, "backupEnabled");
+    settings.BackupPath = toml::find<std::string>(databaseSection, "backupPath");
+    settings.DeleteBackupsAfter = toml::find<int>(databaseSection, "deleteBackupsAfter");
+    /* added after 1.5.0, existing configuration files do not have it */
+    settings.CompressBackups = toml::find_or<bool>(databaseSection, "compressBackups", false);
+    settings.IncrementalBackups = toml::find_or<bool>(databaseSection, "incrementalBackups", false);
+    settings.BackupInterval = toml::find_or<int>(databaseSection, "backupInterval", 60);
+    settings.BackupIdleDelay = toml::find_or<int>(databaseSection, "backupIdleDelay", 10);
+    settings.KeepDailyBackups = toml::find_or<int>(databaseSection, "keepDailyBackups", 0);
+    settings.KeepWeeklyBackups = toml::find_or<int>(databaseSection, "keepWeeklyBackups", 0);
+    settings.KeepMonthlyBackups = toml::find_or<int>(databaseSection, "keepMonthlyBackups", 0);
+    settings.KeepYearlyBackups = toml::find_or<int>(databaseSection, "keepYearlyBackups", 0);
+}
+
+void Configuration::GetStopwatchConfig(const toml::value& config, Settings& settings)
 {
     const auto& stopwatchSection = toml::find(config, Sections::StopwatchSection);
 
-    mSettings.MinimizeStopwatchWindow = toml::find<bool>(stopwatchSection, "minimizeStopwatchWindow");
-    mSettings.HideWindowTimerInterval = toml::find<int>(stopwatchSection, "hideWindowTimer");
-    mSettings.NotificationTimerInterval = toml::find<int>(stopwatchSection, "notificationTimer");
-    mSettings.PausedTaskReminderInterval = toml::find<int>(stopwatchSection, "pausedTaskReminder");
-    mSettings.StartStopwatchOnLaunch = toml::find<bool>(stopwatchSection, "startStopwatchOnLaunch");
-    mSettings.StartStopwatchOnResume = toml::find<bool>(stopwatchSection, "startStopwatchOnResume");
+    settings.MinimizeStopwatchWindow = toml::find<bool>(stopwatchSection, "minimizeStopwatchWindow");
+    settings.HideWindowTimerInterval = toml::find<int>(stopwatchSection, "hideWindowTimer");
+    settings.NotificationTimerInterval = toml::find<int>(stopwatchSection, "notificationTimer");
+    settings.PausedTaskReminderInterval = toml::find<int>(stopwatchSection, "pausedTaskReminder");
+    settings.StartStopwatchOnLaunch = toml::find<bool>(stopwatchSection, "startStopwatchOnLaunch");
+    settings.StartStopwatchOnResume = toml::find<bool>(stopwatchSection, "startStopwatchOnResume");
 }
 
-void Configuration::GetTaskItemConfig(const toml::value& config)
+void Configuration::GetTaskItemConfig(const toml::value& config, Settings& settings)
 {
     const auto& taskItemSection = toml::find(config, Sections::TaskItemSection);
 
-    mSettings.TimeRounding = toml::find<bool>(taskItemSection, "timeRounding");
-    mSettings.TimeToRoundTo = toml::find<int>(taskItemSection, "timeToRoundTo");
+    settings.TimeRounding = toml::find<bool>(taskItemSection, "timeRounding");
+    settings.TimeToRoundTo = toml::find<int>(taskItemSection, "timeToRoundTo");
 }
 
-void Configuration::GetPersistenceConfig(const toml::value& config)
+void Configuration::GetPersistenceConfig(const toml::value& config, Settings& settings)
 {
     const auto& persistenceSection = toml::find(config, Sections::PersistenceSection);
 
-    mSettings.Dimension = toml::find<std::string>(persistenceSection, "dimensions");
+    settings.Dimension = toml::find<std::string>(persistenceSection, "dimensions");
 }
-void Configuration::GetExportConfig(const toml::value& config)
+void Configuration::GetExportConfig(const toml::value& config, Settings& settings)
 {
     const auto exportSection = toml::find(config, Sections::ExportSection);
 
-    mSettings.Delimiter = toml::find<std::string>(exportSection, "delimiter");
-    mSettings.ExportPath = toml::find<std::string>(exportSection, "exportPath");
+    settings.Delimiter = toml::find<std::string>(exportSection, "delimiter");
+    settings.ExportPath = toml::find<std::string>(exportSection, "exportPath");
 }
 } // namespace app::cfg
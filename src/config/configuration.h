@@ -19,21 +19,56 @@
 
 #pragma once
 
+#include <chrono>
+#include <memory>
+#include <shared_mutex>
 #include <string>
 
+#include <spdlog/spdlog.h>
 #include <toml.hpp>
 
-#include <wx/gdicmn.h>
+#include "configurationwriter.h"
 
 namespace app::cfg
 {
+/* Groups of settings that differ after a reload, listeners reconfigure only what they own */
+struct ConfigurationChanges {
+    bool General = false;
+    bool DatabasePath = false;
+    bool ConnectionPoolSize = false;
+    /* backup location, compression and retention */
+    bool Backup = false;
+    /* whether backups run and the interval and idle delay that schedule them */
+    bool BackupSchedule = false;
+    bool Stopwatch = false;
+    bool TaskItem = false;
+    bool Persistence = false;
+    bool Export = false;
+
+    bool Any() const;
+};
+
 class Configuration
 {
 public:
-    Configuration();
+    explicit Configuration(std::shared_ptr<spdlog::logger> logger);
+    Configuration(std::shared_ptr<spdlog::logger> logger, const std::string& configFilePath);
+    Configuration(std::shared_ptr<spdlog::logger> logger,
+        const std::string& configFilePath,
+        std::chrono::milliseconds debounceWindow);
     ~Configuration() = default;
 
+    /* schedules a debounced write on the writer thread, call Flush to wait for it */
     void Save();
+    bool Flush();
+    /* number of times the file was written since this configuration was loaded */
+    int GetWriteCount();
+
+    /*
+     re-reads the file when its content hash differs from the last one loaded or written, returns false and
+     keeps the current settings when it cannot be parsed
+     */
+    bool Reload(ConfigurationChanges& changes);
 
     /* Getters */
     bool IsConfirmOnExit() const;
@@ -43,9 +78,18 @@ class Configuration
     bool IsCloseToTray() const;
 
     std::string GetDatabasePath() const;
+    int GetConnectionPoolSize() const;
     bool IsBackupEnabled() const;
     std::string GetBackupPath() const;
     int GetDeleteBackupsAfter() const;
+    bool IsCompressBackups() const;
+    bool IsIncrementalBackups() const;
+    int GetBackupInterval() const;
+    int GetBackupIdleDelay() const;
+    int GetKeepDailyBackups() const;
+    int GetKeepWeeklyBackups() const;
+    int GetKeepMonthlyBackups() const;
+    int GetKeepYearlyBackups() const;
 
     bool IsMinimizeStopwatchWindow() const;
     int GetHideWindowTimerInterval() const;
@@ -70,9 +114,18 @@ class Configuration
     void SetCloseToTray(bool value);
 
     void SetDatabasePath(const std::string& value);
+    void SetConnectionPoolSize(int value);
     void SetBackupEnabled(bool value);
     void SetBackupPath(const std::string& value);
     void SetDeleteBackupsAfter(int value);
+    void SetCompressBackups(bool value);
+    void SetIncrementalBackups(bool value);
+    void SetBackupInterval(int value);
+    void SetBackupIdleDelay(int value);
+    void SetKeepDailyBackups(int value);
+    void SetKeepWeeklyBackups(int value);
+    void SetKeepMonthlyBackups(int value);
+    void SetKeepYearlyBackups(int value);
 
     void SetMinimizeStopwatchWindow(bool value);
     void SetHideWindowTimerInterval(int value);
@@ -90,15 +143,6 @@ class Configuration
     void SetExportPath(const std::string& value);
 
 private:
-    void LoadConfigFile();
-
-    void GetGeneralConfig(const toml::value& config);
-    void GetDatabaseConfig(const toml::value& config);
-    void GetStopwatchConfig(const toml::value& config);
-    void GetTaskItemConfig(const toml::value& config);
-    void GetPersistenceConfig(const toml::value& config);
-    void GetExportConfig(const toml::value& config);
-
     struct Sections {
         static const std::string GeneralSection;
         static const std::string DatabaseSection;
@@ -116,9 +160,18 @@ class Configuration
         bool CloseToTray;
 
         std::string DatabasePath;
+        int ConnectionPoolSize;
         bool BackupEnabled;
         std::string BackupPath;
         int DeleteBackupsAfter;
+        bool CompressBackups;
+        bool IncrementalBackups;
+        int BackupInterval;
+        int BackupIdleDelay;
+        int KeepDailyBackups;
+        int KeepWeeklyBackups;
+        int KeepMonthlyBackups;
+        int KeepYearlyBackups;
 
         bool MinimizeStopwatchWindow;
         int HideWindowTimerInterval;
@@ -139,6 +192,24 @@ class Configuration
         ~Settings() = default;
     };
 
+    void LoadConfigFile(Settings& settings);
+
+    void GetGeneralConfig(const toml::value& config, Settings& settings);
+    void GetDatabaseConfig(const toml::value& config, Settings& settings);
+    void GetStopwatchConfig(const toml::value& config, Settings& settings);
+    void GetTaskItemConfig(const toml::value& config, Settings& settings);
+    void GetPersistenceConfig(const toml::value& config, Settings& settings);
+    void GetExportConfig(const toml::value& config, Settings& settings);
+
+    static std::string Serialize(const Settings& settings);
+    static ConfigurationChanges Compare(const Settings& previous, const Settings& current);
+
+    std::string mConfigFilePath;
+    /* written on the UI thread only, under an exclusive lock, the getters are called from background threads too */
+    mutable std::shared_mutex mMutex;
     Settings mSettings;
+    std::string mContentHash;
+    std::string mWrittenHash;
+    std::unique_ptr<ConfigurationWriter> pWriter;
 };
 } // namespace app::cfg
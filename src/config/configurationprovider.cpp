@@ -28,8 +28,54 @@ ConfigurationProvider& ConfigurationProvider::Get()
     return instance;
 }
 
-void ConfigurationProvider::Initialize()
+ConfigurationProvider::ConfigurationProvider()
+    : Configuration()
+    , mListeners()
+    , mNextSubscriptionId(1)
 {
-    Configuration = std::make_unique<cfg::Configuration>();
+}
+
+void ConfigurationProvider::Initialize(std::shared_ptr<spdlog::logger> logger)
+{
+    Configuration = std::make_unique<cfg::Configuration>(logger);
+}
+
+void ConfigurationProvider::Initialize(std::shared_ptr<spdlog::logger> logger, const std::string& configFilePath)
+{
+    Configuration = std::make_unique<cfg::Configuration>(logger, configFilePath);
+}
+
+int ConfigurationProvider::Subscribe(ChangeListener listener)
+{
+    int subscriptionId = mNextSubscriptionId++;
+    mListeners[subscriptionId] = std::move(listener);
+    return subscriptionId;
+}
+
+void ConfigurationProvider::Unsubscribe(int subscriptionId)
+{
+    mListeners.erase(subscriptionId);
+}
+
+bool ConfigurationProvider::Reload()
+{
+    if (Configuration == nullptr) {
+        return false;
+    }
+
+    ConfigurationChanges changes;
+    if (!Configuration->Reload(changes)) {
+        return false;
+    }
+
+    if (changes.Any()) {
+        /* copied so a listener can unsubscribe while being notified */
+        auto listeners = mListeners;
+        for (const auto& [subscriptionId, listener] : listeners) {
+            listener(changes);
+        }
+    }
+
+    return true;
 }
 } // namespace app::cfg
@@ -19,7 +19,12 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
 #include <memory>
+#include <string>
+
+#include <spdlog/spdlog.h>
 
 #include "configuration.h"
 
@@ -35,11 +40,24 @@ class ConfigurationProvider final
 
     ~ConfigurationProvider() = default;
 
-    void Initialize();
+    void Initialize(std::shared_ptr<spdlog::logger> logger);
+    void Initialize(std::shared_ptr<spdlog::logger> logger, const std::string& configFilePath);
+
+    using ChangeListener = std::function<void(const ConfigurationChanges&)>;
+
+    /* listeners are called on the thread that calls Reload, which is the UI thread in the application */
+    int Subscribe(ChangeListener listener);
+    void Unsubscribe(int subscriptionId);
+
+    /* reloads the configuration file and notifies the listeners when any setting changed */
+    bool Reload();
 
     std::unique_ptr<cfg::Configuration> Configuration;
 
 private:
-    ConfigurationProvider() = default;
+    ConfigurationProvider();
+
+    std::map<int, ChangeListener> mListeners;
+    int mNextSubscriptionId;
 };
 } // namespace app::cfg
@@ -0,0 +1,181 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "configurationwriter.h"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "../common/sha256.h"
+
+namespace app::cfg
+{
+const std::chrono::milliseconds ConfigurationWriter::DefaultDebounceWindow = std::chrono::milliseconds(500);
+
+ConfigurationWriter::ConfigurationWriter(std::shared_ptr<spdlog::logger> logger,
+    const std::string& configFilePath,
+    std::chrono::milliseconds debounceWindow)
+    : pLogger(logger)
+    , mConfigFilePath(configFilePath)
+    , mDebounceWindow(debounceWindow)
+    , mMutex()
+    , mCondition()
+    , mPendingSerializer()
+    , mDeadline()
+    , mFlushRequests(0)
+    , bWriting(false)
+    , bStopping(false)
+    , bLastWriteSucceeded(true)
+    , mWriteCount(0)
+    , mLastWrittenHash()
+    , mWorker(&ConfigurationWriter::Run, this)
+{
+}
+
+ConfigurationWriter::~ConfigurationWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        bStopping = true;
+    }
+    mCondition.notify_all();
+
+    if (mWorker.joinable()) {
+        mWorker.join();
+    }
+}
+
+void ConfigurationWriter::Schedule(std::function<std::string()> serializer)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        /* the window is anchored to the first pending change so a steady stream of changes still gets written */
+        if (!mPendingSerializer) {
+            mDeadline = std::chrono::steady_clock::now() + mDebounceWindow;
+        }
+        mPendingSerializer = std::move(serializer);
+    }
+    mCondition.notify_all();
+}
+
+bool ConfigurationWriter::Flush()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFlushRequests++;
+    mCondition.notify_all();
+    mCondition.wait(lock, [this]() { return !mPendingSerializer && !bWriting; });
+    mFlushRequests--;
+
+    return bLastWriteSucceeded;
+}
+
+bool ConfigurationWriter::IsWritePending()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mPendingSerializer != nullptr || bWriting;
+}
+
+int ConfigurationWriter::GetWriteCount()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mWriteCount;
+}
+
+std::string ConfigurationWriter::GetLastWrittenHash()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLastWrittenHash;
+}
+
+void ConfigurationWriter::Run()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        if (!mPendingSerializer) {
+            if (bStopping) {
+                break;
+            }
+            mCondition.wait(lock);
+            continue;
+        }
+
+        if (mFlushRequests == 0 && !bStopping && std::chrono::steady_clock::now() < mDeadline) {
+            mCondition.wait_until(lock, mDeadline);
+            continue;
+        }
+
+        auto serializer = std::move(mPendingSerializer);
+        mPendingSerializer = nullptr;
+        bWriting = true;
+
+        lock.unlock();
+        std::string contentHash;
+        bool success = Write(serializer(), contentHash);
+        lock.lock();
+
+        bWriting = false;
+        bLastWriteSucceeded = success;
+        if (success) {
+            mLastWrittenHash = contentHash;
+        }
+        mWriteCount++;
+        mCondition.notify_all();
+    }
+}
+
+bool ConfigurationWriter::Write(const std::string& contents, std::string& contentHash)
+{
+    const std::string temporaryFilePath = mConfigFilePath + ".tmp";
+
+    std::ofstream configFile;
+    configFile.open(temporaryFilePath, std::ios_base::out | std::ios_base::trunc);
+    if (!configFile) {
+        pLogger->error("Error occured when opening configuration file \"{0}\" for writing", temporaryFilePath);
+        return false;
+    }
+
+    configFile << contents;
+    configFile.close();
+    if (!configFile) {
+        pLogger->error("Error occured when writing configuration file \"{0}\"", temporaryFilePath);
+        std::error_code ignored;
+        std::filesystem::remove(temporaryFilePath, ignored);
+        return false;
+    }
+
+    /* hash what actually reached the disk, text mode translates line endings on Windows */
+    contentHash = common::Sha256::HashFile(temporaryFilePath);
+
+    /* replaces the existing file in one step, MoveFileEx with MOVEFILE_REPLACE_EXISTING on Windows */
+    std::error_code ec;
+    std::filesystem::rename(temporaryFilePath, mConfigFilePath, ec);
+    if (ec) {
+        pLogger->error("Error occured when replacing configuration file \"{0}\" - {1:d} : {2}",
+            mConfigFilePath,
+            ec.value(),
+            ec.message());
+        std::error_code ignored;
+        std::filesystem::remove(temporaryFilePath, ignored);
+        return false;
+    }
+
+    return true;
+}
+} // namespace app::cfg
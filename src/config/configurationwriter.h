@@ -0,0 +1,87 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+namespace app::cfg
+{
+/*
+ Writes the configuration file behind the caller's back. Changes scheduled within the debounce window of the
+ first pending change are coalesced into a single write, the serialization and file I/O happen on a worker
+ thread and the file is replaced atomically by writing a temporary file and renaming it over the original,
+ so a crash mid write never leaves a truncated configuration behind. A failed write is logged from the worker
+ thread as nobody is waiting for it unless Flush was called.
+ */
+class ConfigurationWriter final
+{
+public:
+    ConfigurationWriter(std::shared_ptr<spdlog::logger> logger,
+        const std::string& configFilePath,
+        std::chrono::milliseconds debounceWindow);
+    /* writes whatever is still pending before the worker stops */
+    ~ConfigurationWriter();
+
+    ConfigurationWriter(const ConfigurationWriter&) = delete;
+    ConfigurationWriter& operator=(const ConfigurationWriter&) = delete;
+
+    /* replaces any pending change, the serializer runs on the worker thread */
+    void Schedule(std::function<std::string()> serializer);
+    /* writes the pending change now and waits for it, returns whether the last write succeeded */
+    bool Flush();
+
+    bool IsWritePending();
+    int GetWriteCount();
+    /* content hash of the file the last successful write produced, lets a file watcher skip our own writes */
+    std::string GetLastWrittenHash();
+
+    static const std::chrono::milliseconds DefaultDebounceWindow;
+
+private:
+    void Run();
+    bool Write(const std::string& contents, std::string& contentHash);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::string mConfigFilePath;
+    std::chrono::milliseconds mDebounceWindow;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::function<std::string()> mPendingSerializer;
+    std::chrono::steady_clock::time_point mDeadline;
+    int mFlushRequests;
+    bool bWriting;
+    bool bStopping;
+    bool bLastWriteSucceeded;
+    int mWriteCount;
+    std::string mLastWrittenHash;
+
+    /* declared last so every other member is initialized before the worker starts */
+    std::thread mWorker;
+};
+} // namespace app::cfg
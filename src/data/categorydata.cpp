@@ -38,7 +38,7 @@ CategoryData::~CategoryData()
 
 int64_t CategoryData::Create(std::unique_ptr<model::CategoryModel> category)
 {
-    unsigned int color = static_cast<unsigned int>(category->GetColor().GetRGB());
+    unsigned int color = category->GetColor();
 
     *pConnection->DatabaseExecutableHandle()
         << CategoryData::createCategory << category->GetName().ToStdString() << color << category->GetProjectId();
@@ -112,7 +112,7 @@ std::unique_ptr<model::CategoryModel> CategoryData::GetById(const int id)
 
 void CategoryData::Update(std::unique_ptr<model::CategoryModel> category)
 {
-    unsigned int color = static_cast<unsigned int>(category->GetColor().GetRGB());
+    unsigned int color = category->GetColor();
 
     *pConnection->DatabaseExecutableHandle()
         << CategoryData::updateCategory << category->GetName().ToStdString() << color << category->GetProjectId()
@@ -25,7 +25,7 @@
 
 #include "../database/connectionprovider.h"
 #include "../database/sqliteconnection.h"
-#include "../models/TaskItemModel.h"
+#include "../models/taskitemmodel.h"
 
 namespace app::data
 {
@@ -19,12 +19,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <sqlite_modern_cpp.h>
+#include "../common/metrics.h"
 #include "connection.h"
 #include "connectionfactory.h"
 
@@ -42,24 +45,47 @@ class ConnectionPool final
     void Release(std::shared_ptr<T> connection);
 
     const std::size_t ConnectionsInUse() const;
+    /*
+     grows or trims the idle connections, never below the connections currently handed out. When more
+     are handed out than poolSize, the pool shrinks to poolSize as they are released.
+     */
+    void Resize(std::size_t poolSize);
 
 private:
     std::size_t mPoolSize;
+    /* mPoolSize is only above this while more connections are handed out than were asked for */
+    std::size_t mRequestedPoolSize;
     std::size_t mConnectionsInUse;
     std::shared_ptr<IConnectionFactory> pFactory;
     std::deque<std::shared_ptr<IConnection>> mPool;
+    /* connections are acquired from background threads too (e.g. database backups) */
+    mutable std::mutex mMutex;
+
+    common::Counter& mAcquiredCounter;
+    /* acquisitions the idle connections could not serve */
+    common::Counter& mCreatedCounter;
+    common::Gauge& mInUseGauge;
+    common::Gauge& mSizeGauge;
 };
 
 template<class T>
 inline ConnectionPool<T>::ConnectionPool(std::shared_ptr<IConnectionFactory> factory, std::size_t poolSize)
     : pFactory(factory)
     , mPoolSize(poolSize)
+    , mRequestedPoolSize(poolSize)
     , mPool()
     , mConnectionsInUse(0)
+    , mAcquiredCounter(common::MetricsRegistry::Get().GetCounter(common::MetricNames::PoolAcquired))
+    , mCreatedCounter(common::MetricsRegistry::Get().GetCounter(common::MetricNames::PoolCreated))
+    , mInUseGauge(common::MetricsRegistry::Get().GetGauge(common::MetricNames::PoolInUse))
+    , mSizeGauge(common::MetricsRegistry::Get().GetGauge(common::MetricNames::PoolSize))
 {
     while (mPool.size() < mPoolSize) {
         mPool.push_back(pFactory->Create());
     }
+
+    mInUseGauge.Set(0);
+    mSizeGauge.Set(static_cast<std::int64_t>(mPoolSize));
 }
 
 template<class T>
@@ -71,10 +97,15 @@ inline ConnectionPool<T>::~ConnectionPool()
 template<class T>
 inline std::shared_ptr<T> ConnectionPool<T>::Acquire()
 {
+    std::lock_guard<std::mutex> lock(mMutex);
     mConnectionsInUse++;
     assert(mConnectionsInUse <= mPoolSize);
 
+    mAcquiredCounter.Increment();
+    mInUseGauge.Set(static_cast<std::int64_t>(mConnectionsInUse));
+
     if (mPool.size() == 0) {
+        mCreatedCounter.Increment();
         auto connection = pFactory->Create();
         return std::dynamic_pointer_cast<T>(connection);
     }
@@ -89,13 +120,39 @@ inline std::shared_ptr<T> ConnectionPool<T>::Acquire()
 template<class T>
 inline void ConnectionPool<T>::Release(std::shared_ptr<T> connection)
 {
-    mPool.push_back(std::dynamic_pointer_cast<IConnection>(connection));
+    std::lock_guard<std::mutex> lock(mMutex);
     mConnectionsInUse--;
+    mInUseGauge.Set(static_cast<std::int64_t>(mConnectionsInUse));
+    /* the pool may have been resized down while the connection was out, then the connection is dropped */
+    if (mPoolSize > mRequestedPoolSize) {
+        mPoolSize = std::max(mRequestedPoolSize, mPool.size() + mConnectionsInUse);
+        mSizeGauge.Set(static_cast<std::int64_t>(mPoolSize));
+    }
+    if (mPool.size() + mConnectionsInUse < mPoolSize) {
+        mPool.push_back(std::dynamic_pointer_cast<IConnection>(connection));
+    }
 }
 
 template<class T>
 inline const std::size_t ConnectionPool<T>::ConnectionsInUse() const
 {
+    std::lock_guard<std::mutex> lock(mMutex);
     return mConnectionsInUse;
 }
+
+template<class T>
+inline void ConnectionPool<T>::Resize(std::size_t poolSize)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRequestedPoolSize = poolSize;
+    mPoolSize = std::max(poolSize, mConnectionsInUse);
+    mSizeGauge.Set(static_cast<std::int64_t>(mPoolSize));
+
+    while (mPool.size() + mConnectionsInUse > mPoolSize) {
+        mPool.pop_back();
+    }
+    while (mPool.size() + mConnectionsInUse < mPoolSize) {
+        mPool.push_back(pFactory->Create());
+    }
+}
 } // namespace app::db
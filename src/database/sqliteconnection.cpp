@@ -19,11 +19,22 @@
 
 #include "sqliteconnection.h"
 
+#include <string_view>
+
+#include "../common/perflog.h"
+#include "../common/tracer.h"
+
 namespace app::db
 {
+const std::size_t SqliteConnection::MaxCachedQueryHistograms = 256;
+
 SqliteConnection::SqliteConnection(std::string connectionString)
     : mConnectionString(connectionString)
     , pDatabase(nullptr)
+    , mQueryHistograms()
+    , mQueryOtherHistogram(common::MetricsRegistry::Get().GetQueryOtherHistogram())
+    , mPageCacheHitsCounter(common::MetricsRegistry::Get().GetCounter(common::MetricNames::PageCacheHits))
+    , mPageCacheMissesCounter(common::MetricsRegistry::Get().GetCounter(common::MetricNames::PageCacheMisses))
 {
 }
 
@@ -34,12 +45,68 @@ SqliteConnection::~SqliteConnection()
 
 void SqliteConnection::Connect()
 {
+    common::TraceSpan traceSpan("SqliteConnection::Connect");
+
     auto config = sqlite::sqlite_config{ sqlite::OpenFlags::READWRITE, nullptr, sqlite::Encoding::UTF8 };
     pDatabase = new sqlite::database(mConnectionString, config);
+
+    /* sqlite times every statement itself and reports it to the metrics and the perf log */
+    auto database = pDatabase->connection().get();
+    sqlite3_trace_v2(database, SQLITE_TRACE_PROFILE, &SqliteConnection::OnStatementProfiled, this);
 }
 
 sqlite::database* SqliteConnection::DatabaseExecutableHandle()
 {
     return pDatabase;
 }
+
+int SqliteConnection::OnStatementProfiled(unsigned int type, void* context, void* statement, void* nanoseconds)
+{
+    if (type != SQLITE_TRACE_PROFILE) {
+        return 0;
+    }
+
+    auto self = static_cast<SqliteConnection*>(context);
+    const char* sql = sqlite3_sql(static_cast<sqlite3_stmt*>(statement));
+    auto durationNanoseconds = *static_cast<sqlite3_int64*>(nanoseconds);
+
+    self->GetQueryHistogram(sql).Record(static_cast<std::uint64_t>(durationNanoseconds / 1000));
+
+    /* the counters are reset on every read, so each statement adds only its own page cache hits and misses */
+    int current = 0;
+    int highwater = 0;
+    auto database = self->pDatabase->connection().get();
+    if (sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_HIT, &current, &highwater, 1) == SQLITE_OK) {
+        self->mPageCacheHitsCounter.Increment(current);
+    }
+    if (sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_MISS, &current, &highwater, 1) == SQLITE_OK) {
+        self->mPageCacheMissesCounter.Increment(current);
+    }
+
+    common::PerfLog::Get().RecordQuery(sql, durationNanoseconds / 1000000.0);
+
+    return 0;
+}
+
+/*
+ The unexpanded statement text names the histogram, bound values never end up in a metric name. A statement
+ seen before costs one lookup in this connection's cache without allocating or taking the registry lock.
+ */
+common::Histogram& SqliteConnection::GetQueryHistogram(const char* sql)
+{
+    std::string_view statementText(sql != nullptr ? sql : "");
+    auto cached = mQueryHistograms.find(statementText);
+    if (cached != mQueryHistograms.end()) {
+        return *cached->second;
+    }
+
+    /* statements built with literal values would otherwise grow the cache and the registry without bound */
+    if (mQueryHistograms.size() >= MaxCachedQueryHistograms) {
+        return mQueryOtherHistogram;
+    }
+
+    auto& histogram = common::MetricsRegistry::Get().GetQueryHistogram(statementText);
+    mQueryHistograms.emplace(statementText, &histogram);
+    return histogram;
+}
 } // namespace app::db
@@ -19,10 +19,14 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <map>
 #include <string>
 
 #include <sqlite_modern_cpp.h>
 
+#include "../common/metrics.h"
 #include "connection.h"
 
 namespace app::db
@@ -37,9 +41,21 @@ class SqliteConnection final : public IConnection
 
     sqlite::database* DatabaseExecutableHandle();
 
+    /* statements with their own cached histogram per connection, any further ones share the <other> histogram */
+    static const std::size_t MaxCachedQueryHistograms;
+
 private:
+    static int OnStatementProfiled(unsigned int type, void* context, void* statement, void* nanoseconds);
+    common::Histogram& GetQueryHistogram(const char* sql);
+
     std::string mConnectionString;
 
     sqlite::database* pDatabase;
+
+    /* a connection is used by one thread at a time, so the cache needs no lock */
+    std::map<std::string, common::Histogram*, std::less<>> mQueryHistograms;
+    common::Histogram& mQueryOtherHistogram;
+    common::Counter& mPageCacheHitsCounter;
+    common::Counter& mPageCacheMissesCounter;
 };
 } // namespace app::db
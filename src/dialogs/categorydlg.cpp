@@ -219,7 +219,7 @@ void CategoryDialog::DataToControls()
 
     pNameTextCtrl->SetValue(category->GetName());
 
-    pColorPickerCtrl->SetColour(category->GetColor());
+    pColorPickerCtrl->SetColour(wxColour(category->GetColor()));
 
     pDateTextCtrl->SetLabel(wxString::Format(constants::DateLabel,
         util::ToFriendlyDateTimeString(category->GetDateCreated()),
@@ -250,7 +250,7 @@ bool CategoryDialog::TransferDataAndValidate()
     pCategory->SetProjectId(projectId);
 
     wxColor color = pColorPickerCtrl->GetColour();
-    pCategory->SetColor(color);
+    pCategory->SetColor(color.GetRGB());
 
     return true;
 }
@@ -0,0 +1,305 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "databasebackupdlg.h"
+
+#include <wx/statline.h>
+
+#include "../common/common.h"
+#include "../common/resources.h"
+#include "../services/databasebackup.h"
+
+wxDEFINE_EVENT(DATABASE_BACKUP_THREAD_PROGRESS, wxThreadEvent);
+wxDEFINE_EVENT(DATABASE_BACKUP_THREAD_COMPLETED, wxThreadEvent);
+wxDEFINE_EVENT(DATABASE_BACKUP_THREAD_ERROR, wxThreadEvent);
+
+namespace app::dlg
+{
+DatabaseBackupThread::DatabaseBackupThread(DatabaseBackupDialog* handler, std::shared_ptr<spdlog::logger> logger)
+    : wxThread(wxTHREAD_DETACHED)
+    , pHandler(handler)
+    , pLogger(logger)
+{
+}
+
+DatabaseBackupThread::~DatabaseBackupThread()
+{
+    wxCriticalSectionLocker enter(pHandler->mCriticalSection);
+    pHandler->pThread = nullptr;
+}
+
+wxThread::ExitCode DatabaseBackupThread::Entry()
+{
+    int lastPercentage = -1;
+    auto progressCallback = [&](int remaining, int pageCount) {
+        if (TestDestroy()) {
+            return false;
+        }
+
+        /* only post when the gauge would actually move */
+        int percentage = pageCount > 0 ? ((pageCount - remaining) * 100) / pageCount : 0;
+        if (percentage != lastPercentage) {
+            lastPercentage = percentage;
+
+            auto event = new wxThreadEvent(DATABASE_BACKUP_THREAD_PROGRESS);
+            event->SetInt(pageCount - remaining);
+            event->SetExtraLong(pageCount);
+            wxQueueEvent(pHandler, event);
+        }
+        return true;
+    };
+
+    svc::DatabaseBackup databaseBackup(pLogger);
+    bool success = databaseBackup.Execute(svc::DatabaseBackup::DefaultPagesPerStep,
+        svc::DatabaseBackup::DefaultStepSleepMilliseconds,
+        progressCallback);
+
+    if (databaseBackup.IsCancelled()) {
+        return (wxThread::ExitCode) 1;
+    }
+
+    if (!success) {
+        auto event = new wxThreadEvent(DATABASE_BACKUP_THREAD_ERROR);
+        event->SetString(wxT("Backup database operation encountered error(s)!"));
+        wxQueueEvent(pHandler, event);
+        return (wxThread::ExitCode) 1;
+    }
+
+    auto event = new wxThreadEvent(DATABASE_BACKUP_THREAD_COMPLETED);
+    wxQueueEvent(pHandler, event);
+
+    return (wxThread::ExitCode) 0;
+}
+
+DatabaseBackupDialog::DatabaseBackupDialog(wxWindow* parent,
+    std::shared_ptr<spdlog::logger> logger,
+    const wxString& name)
+    : pThread(nullptr)
+    , mCriticalSection()
+    , pLogger(logger)
+    , pStatusText(nullptr)
+    , pGaugeCtrl(nullptr)
+    , pOkButton(nullptr)
+    , pCancelButton(nullptr)
+{
+    Create(parent,
+        wxID_ANY,
+        wxT("Backup Database"),
+        wxDefaultPosition,
+        wxSize(360, 160),
+        wxCAPTION | wxCLOSE_BOX | wxSYSTEM_MENU,
+        name);
+}
+
+void DatabaseBackupDialog::LaunchModeless()
+{
+    StartThread();
+    wxDialog::Show(true);
+}
+
+bool DatabaseBackupDialog::Create(wxWindow* parent,
+    wxWindowID windowId,
+    const wxString& title,
+    const wxPoint& position,
+    const wxSize& size,
+    long style,
+    const wxString& name)
+{
+    bool created = wxDialog::Create(parent, windowId, title, position, size, style, name);
+    if (created) {
+        CreateControls();
+        ConfigureEventBindings();
+
+        GetSizer()->Fit(this);
+        SetIcon(rc::GetProgramIcon());
+        Center();
+    }
+
+    return created;
+}
+
+void DatabaseBackupDialog::CreateControls()
+{
+    auto mainSizer = new wxBoxSizer(wxVERTICAL);
+
+    auto sizer = new wxBoxSizer(wxVERTICAL);
+    auto mainPanel = new wxPanel(this, wxID_STATIC);
+    mainPanel->SetSizer(sizer);
+    mainSizer->Add(mainPanel, common::sizers::ControlExpand);
+
+    /* Status Text Control */
+    pStatusText = new wxStaticText(mainPanel, IDC_STATUS, wxT("Starting database backup..."));
+    sizer->Add(pStatusText, common::sizers::ControlDefault);
+
+    /* Gauge Control */
+    pGaugeCtrl = new wxGauge(mainPanel, IDC_GAUGE, 100, wxDefaultPosition, wxSize(320, -1));
+    sizer->Add(pGaugeCtrl, common::sizers::ControlExpand);
+
+    /* Horizontal Line*/
+    auto separationLine = new wxStaticLine(this, wxID_ANY, wxDefaultPosition, wxSize(150, -1), wxLI_HORIZONTAL);
+    mainSizer->Add(separationLine, 0, wxEXPAND | wxALL, 1);
+
+    /* Button Panel */
+    auto buttonPanel = new wxPanel(this, wxID_STATIC);
+    auto buttonPanelSizer = new wxBoxSizer(wxHORIZONTAL);
+    buttonPanel->SetSizer(buttonPanelSizer);
+    mainSizer->Add(buttonPanel, common::sizers::ControlCenter);
+
+    pOkButton = new wxButton(buttonPanel, wxID_OK, wxT("&OK"));
+    pOkButton->Disable();
+
+    pCancelButton = new wxButton(buttonPanel, wxID_CANCEL, wxT("&Cancel"));
+    pCancelButton->SetFocus();
+
+    buttonPanelSizer->Add(pOkButton, common::sizers::ControlDefault);
+    buttonPanelSizer->Add(pCancelButton, common::sizers::ControlDefault);
+
+    SetSizer(mainSizer);
+}
+
+// clang-format off
+void DatabaseBackupDialog::ConfigureEventBindings()
+{
+    Bind(
+        wxEVT_CLOSE_WINDOW,
+        &DatabaseBackupDialog::OnClose,
+        this
+    );
+
+    Bind(
+        wxEVT_BUTTON,
+        &DatabaseBackupDialog::OnOk,
+        this,
+        wxID_OK
+    );
+
+    Bind(
+        wxEVT_BUTTON,
+        &DatabaseBackupDialog::OnCancel,
+        this,
+        wxID_CANCEL
+    );
+
+    Bind(
+        DATABASE_BACKUP_THREAD_PROGRESS,
+        &DatabaseBackupDialog::OnThreadProgress,
+        this
+    );
+
+    Bind(
+        DATABASE_BACKUP_THREAD_COMPLETED,
+        &DatabaseBackupDialog::OnThreadCompletion,
+        this
+    );
+
+    Bind(
+        DATABASE_BACKUP_THREAD_ERROR,
+        &DatabaseBackupDialog::OnThreadError,
+        this
+    );
+}
+// clang-format on
+
+void DatabaseBackupDialog::StartThread()
+{
+    pThread = new DatabaseBackupThread(this, pLogger);
+    auto ret = pThread->Run();
+    if (ret != wxTHREAD_NO_ERROR) {
+        delete pThread;
+        pThread = nullptr;
+
+        pStatusText->SetLabel(wxT("Error! Could not start the database backup."));
+        pOkButton->Enable();
+        pCancelButton->Disable();
+    }
+}
+
+void DatabaseBackupDialog::ThreadCleanupProcedure()
+{
+    {
+        wxCriticalSectionLocker enter(mCriticalSection);
+        if (pThread) {
+            /* the backup checks TestDestroy() after every step and removes the partial file */
+            auto ret = pThread->Delete();
+            if (ret != wxTHREAD_NO_ERROR) {
+                wxLogError("Cannot delete thread!");
+            }
+        }
+    }
+
+    while (1) {
+        {
+            wxCriticalSectionLocker enter(mCriticalSection);
+            if (!pThread) {
+                break;
+            }
+        }
+        wxThread::This()->Sleep(1);
+    }
+
+    Destroy();
+}
+
+void DatabaseBackupDialog::OnOk(wxCommandEvent& WXUNUSED(event))
+{
+    ThreadCleanupProcedure();
+}
+
+void DatabaseBackupDialog::OnCancel(wxCommandEvent& WXUNUSED(event))
+{
+    ThreadCleanupProcedure();
+}
+
+void DatabaseBackupDialog::OnClose(wxCloseEvent& WXUNUSED(event))
+{
+    ThreadCleanupProcedure();
+}
+
+void DatabaseBackupDialog::OnThreadProgress(wxThreadEvent& event)
+{
+    int copied = event.GetInt();
+    int pageCount = static_cast<int>(event.GetExtraLong());
+    if (pageCount > 0) {
+        pGaugeCtrl->SetValue((copied * 100) / pageCount);
+    }
+
+    pStatusText->SetLabel(wxString::Format(wxT("Copied %d of %d pages..."), copied, pageCount));
+}
+
+void DatabaseBackupDialog::OnThreadCompletion(wxThreadEvent& event)
+{
+    /* the main frame verifies the new backup */
+    wxQueueEvent(GetParent(), event.Clone());
+
+    pGaugeCtrl->SetValue(100);
+    pStatusText->SetLabel(wxT("Backup completed successfully!"));
+    pOkButton->Enable();
+    pOkButton->SetFocus();
+    pCancelButton->Disable();
+}
+
+void DatabaseBackupDialog::OnThreadError(wxThreadEvent& event)
+{
+    pGaugeCtrl->SetValue(0);
+    pStatusText->SetLabel(event.GetString());
+    pOkButton->Enable();
+    pOkButton->SetFocus();
+    pCancelButton->Disable();
+}
+} // namespace app::dlg
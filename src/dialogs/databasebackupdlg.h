@@ -0,0 +1,100 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <memory>
+
+#include <spdlog/spdlog.h>
+#include <wx/wx.h>
+#include <wx/thread.h>
+
+wxDECLARE_EVENT(DATABASE_BACKUP_THREAD_PROGRESS, wxThreadEvent);
+wxDECLARE_EVENT(DATABASE_BACKUP_THREAD_COMPLETED, wxThreadEvent);
+wxDECLARE_EVENT(DATABASE_BACKUP_THREAD_ERROR, wxThreadEvent);
+
+namespace app::dlg
+{
+class DatabaseBackupDialog;
+
+class DatabaseBackupThread : public wxThread
+{
+public:
+    DatabaseBackupThread() = delete;
+    DatabaseBackupThread(DatabaseBackupDialog* handler, std::shared_ptr<spdlog::logger> logger);
+    virtual ~DatabaseBackupThread();
+
+protected:
+    ExitCode Entry() override;
+
+private:
+    DatabaseBackupDialog* pHandler;
+    std::shared_ptr<spdlog::logger> pLogger;
+};
+
+class DatabaseBackupDialog : public wxDialog
+{
+public:
+    DatabaseBackupDialog() = delete;
+    DatabaseBackupDialog(wxWindow* parent,
+        std::shared_ptr<spdlog::logger> logger,
+        const wxString& name = wxT("databasebackupdlg"));
+    virtual ~DatabaseBackupDialog() = default;
+
+    void LaunchModeless();
+
+protected:
+    DatabaseBackupThread* pThread;
+    wxCriticalSection mCriticalSection;
+
+private:
+    bool Create(wxWindow* parent,
+        wxWindowID windowId,
+        const wxString& title,
+        const wxPoint& position,
+        const wxSize& size,
+        long style,
+        const wxString& name);
+
+    void CreateControls();
+    void ConfigureEventBindings();
+
+    void StartThread();
+
+    void ThreadCleanupProcedure();
+
+    void OnOk(wxCommandEvent& event);
+    void OnCancel(wxCommandEvent& event);
+    void OnClose(wxCloseEvent& event);
+    void OnThreadProgress(wxThreadEvent& event);
+    void OnThreadCompletion(wxThreadEvent& event);
+    void OnThreadError(wxThreadEvent& event);
+
+    friend class DatabaseBackupThread;
+
+    std::shared_ptr<spdlog::logger> pLogger;
+
+    wxStaticText* pStatusText;
+    wxGauge* pGaugeCtrl;
+    wxButton* pOkButton;
+    wxButton* pCancelButton;
+
+    enum { IDC_STATUS = wxID_HIGHEST + 1, IDC_GAUGE };
+};
+} // namespace app::dlg
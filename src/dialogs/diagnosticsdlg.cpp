@@ -0,0 +1,308 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "diagnosticsdlg.h"
+
+#include <fstream>
+
+#include <wx/statline.h>
+
+#include "../common/common.h"
+#include "../common/resources.h"
+#include "../config/configurationprovider.h"
+
+namespace app::dlg
+{
+namespace
+{
+wxString FormatMilliseconds(double microseconds)
+{
+    return wxString::Format(wxT("%.2f"), microseconds / 1000.0);
+}
+
+wxString FormatRate(std::uint64_t part, std::uint64_t total)
+{
+    if (total == 0) {
+        return wxT("n/a");
+    }
+    return wxString::Format(wxT("%.1f%%"), 100.0 * static_cast<double>(part) / static_cast<double>(total));
+}
+} // namespace
+
+const int DiagnosticsDialog::RefreshIntervalMilliseconds = 1000;
+
+LatencyListCtrl::LatencyListCtrl(wxWindow* parent, wxWindowID windowId, const common::MetricsSnapshot& snapshot)
+    : wxListCtrl(parent,
+          windowId,
+          wxDefaultPosition,
+          wxSize(-1, 280),
+          wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL | wxLC_HRULES | wxLC_VRULES)
+    , mSnapshot(snapshot)
+{
+    InsertColumn(0, wxT("Metric"), wxLIST_FORMAT_LEFT, 320);
+    InsertColumn(1, wxT("Count"), wxLIST_FORMAT_RIGHT, 70);
+    InsertColumn(2, wxT("p50 (ms)"), wxLIST_FORMAT_RIGHT, 80);
+    InsertColumn(3, wxT("p95 (ms)"), wxLIST_FORMAT_RIGHT, 80);
+    InsertColumn(4, wxT("p99 (ms)"), wxLIST_FORMAT_RIGHT, 80);
+    InsertColumn(5, wxT("Max (ms)"), wxLIST_FORMAT_RIGHT, 80);
+}
+
+void LatencyListCtrl::RefreshLatencies()
+{
+    SetItemCount(static_cast<long>(mSnapshot.Histograms.size()));
+    Refresh();
+}
+
+wxString LatencyListCtrl::OnGetItemText(long item, long column) const
+{
+    if (item < 0 || item >= static_cast<long>(mSnapshot.Histograms.size())) {
+        return wxGetEmptyString();
+    }
+
+    const auto& histogram = mSnapshot.Histograms[item];
+    switch (column) {
+    case 0:
+        return wxString::FromUTF8(histogram.Name.c_str());
+    case 1:
+        return wxString::Format(wxT("%llu"), static_cast<unsigned long long>(histogram.Count));
+    case 2:
+        return FormatMilliseconds(static_cast<double>(histogram.P50Microseconds));
+    case 3:
+        return FormatMilliseconds(static_cast<double>(histogram.P95Microseconds));
+    case 4:
+        return FormatMilliseconds(static_cast<double>(histogram.P99Microseconds));
+    case 5:
+        return FormatMilliseconds(static_cast<double>(histogram.MaxMicroseconds));
+    default:
+        return wxGetEmptyString();
+    }
+}
+
+DiagnosticsDialog::DiagnosticsDialog(wxWindow* parent, std::shared_ptr<spdlog::logger> logger, const wxString& name)
+    : pLogger(logger)
+    , mSnapshot()
+    , pRefreshTimer(std::make_unique<wxTimer>(this, IDC_REFRESH_TIMER))
+    , pPoolUtilizationLabel(nullptr)
+    , pPoolAcquisitionsLabel(nullptr)
+    , pPageCacheLabel(nullptr)
+    , pChunkReuseLabel(nullptr)
+    , pStopwatchLabel(nullptr)
+    , pListCtrl(nullptr)
+    , pFeedbackLabel(nullptr)
+    , pSaveButton(nullptr)
+    , pOkButton(nullptr)
+{
+    Create(parent,
+        wxID_ANY,
+        wxT("Diagnostics"),
+        wxDefaultPosition,
+        wxDefaultSize,
+        wxCAPTION | wxCLOSE_BOX | wxRESIZE_BORDER,
+        name);
+}
+
+bool DiagnosticsDialog::Create(wxWindow* parent,
+    wxWindowID windowId,
+    const wxString& title,
+    const wxPoint& position,
+    const wxSize& size,
+    long style,
+    const wxString& name)
+{
+    bool created = wxDialog::Create(parent, windowId, title, position, size, style, name);
+    if (created) {
+        CreateControls();
+        ConfigureEventBindings();
+        FillControls();
+
+        GetSizer()->Fit(this);
+        SetIcon(rc::GetProgramIcon());
+        Centre();
+
+        pRefreshTimer->Start(RefreshIntervalMilliseconds);
+    }
+    return created;
+}
+
+void DiagnosticsDialog::CreateControls()
+{
+    /* Window Sizing */
+    auto mainSizer = new wxBoxSizer(wxVERTICAL);
+    SetSizer(mainSizer);
+
+    /* Sizer for top controls */
+    auto topSizer = new wxBoxSizer(wxHORIZONTAL);
+    mainSizer->Add(topSizer, common::sizers::ControlExpand);
+
+    /* Connection Pool static box */
+    auto poolStaticBox = new wxStaticBox(this, wxID_ANY, wxT("Connection Pool"));
+    auto poolStaticBoxSizer = new wxStaticBoxSizer(poolStaticBox, wxVERTICAL);
+    topSizer->Add(poolStaticBoxSizer, wxSizerFlags(1).Border(wxALL, 5).Expand());
+
+    pPoolUtilizationLabel = new wxStaticText(poolStaticBox, IDC_POOL_UTILIZATION, wxGetEmptyString());
+    poolStaticBoxSizer->Add(pPoolUtilizationLabel, common::sizers::ControlDefault);
+
+    pPoolAcquisitionsLabel = new wxStaticText(poolStaticBox, IDC_POOL_ACQUISITIONS, wxGetEmptyString());
+    poolStaticBoxSizer->Add(pPoolAcquisitionsLabel, common::sizers::ControlDefault);
+
+    /* Caches static box */
+    auto cachesStaticBox = new wxStaticBox(this, wxID_ANY, wxT("Caches"));
+    auto cachesStaticBoxSizer = new wxStaticBoxSizer(cachesStaticBox, wxVERTICAL);
+    topSizer->Add(cachesStaticBoxSizer, wxSizerFlags(1).Border(wxALL, 5).Expand());
+
+    pPageCacheLabel = new wxStaticText(cachesStaticBox, IDC_PAGE_CACHE, wxGetEmptyString());
+    cachesStaticBoxSizer->Add(pPageCacheLabel, common::sizers::ControlDefault);
+
+    pChunkReuseLabel = new wxStaticText(cachesStaticBox, IDC_CHUNK_REUSE, wxGetEmptyString());
+    cachesStaticBoxSizer->Add(pChunkReuseLabel, common::sizers::ControlDefault);
+
+    /* Stopwatch static box */
+    auto stopwatchStaticBox = new wxStaticBox(this, wxID_ANY, wxT("Stopwatch"));
+    auto stopwatchStaticBoxSizer = new wxStaticBoxSizer(stopwatchStaticBox, wxVERTICAL);
+    topSizer->Add(stopwatchStaticBoxSizer, wxSizerFlags(1).Border(wxALL, 5).Expand());
+
+    pStopwatchLabel = new wxStaticText(stopwatchStaticBox, IDC_STOPWATCH, wxGetEmptyString());
+    stopwatchStaticBoxSizer->Add(pStopwatchLabel, common::sizers::ControlDefault);
+
+    /* Latency list control */
+    pListCtrl = new LatencyListCtrl(this, IDC_LIST, mSnapshot);
+    mainSizer->Add(pListCtrl, wxSizerFlags(1).Border(wxALL, 5).Expand());
+
+    /* Feedback label */
+    pFeedbackLabel = new wxStaticText(this, IDC_FEEDBACK, wxGetEmptyString());
+    mainSizer->Add(pFeedbackLabel, common::sizers::ControlDefault);
+
+    /* Horizontal Line*/
+    auto bottomSeparationLine = new wxStaticLine(this, wxID_ANY, wxDefaultPosition, wxSize(3, 3), wxLI_HORIZONTAL);
+    mainSizer->Add(bottomSeparationLine, wxSizerFlags().Border(wxLEFT | wxRIGHT, 5).Expand());
+
+    /* Button panel */
+    auto buttonPanelSizer = new wxBoxSizer(wxHORIZONTAL);
+
+    auto buttonPanel = new wxPanel(this, wxID_STATIC);
+    buttonPanel->SetSizer(buttonPanelSizer);
+
+    mainSizer->Add(buttonPanel, common::sizers::ControlRight);
+
+    pSaveButton = new wxButton(buttonPanel, IDC_SAVEBUTTON, wxT("Save Snapshot..."));
+    pSaveButton->SetToolTip(wxT("Save the current metrics to a JSON file"));
+    buttonPanelSizer->Add(pSaveButton, common::sizers::ControlDefault);
+
+    pOkButton = new wxButton(buttonPanel, wxID_OK, wxT("OK"));
+    buttonPanelSizer->Add(pOkButton, wxSizerFlags().Border(wxALL, 5));
+}
+
+// clang-format off
+void DiagnosticsDialog::ConfigureEventBindings()
+{
+    Bind(
+        wxEVT_TIMER,
+        &DiagnosticsDialog::OnRefreshTimer,
+        this,
+        IDC_REFRESH_TIMER
+    );
+
+    pSaveButton->Bind(
+        wxEVT_BUTTON,
+        &DiagnosticsDialog::OnSaveSnapshot,
+        this,
+        IDC_SAVEBUTTON
+    );
+}
+// clang-format on
+
+void DiagnosticsDialog::FillControls()
+{
+    using common::MetricNames;
+
+    mSnapshot = common::MetricsRegistry::Get().Snapshot();
+
+    auto inUse = mSnapshot.GetGauge(MetricNames::PoolInUse);
+    auto size = mSnapshot.GetGauge(MetricNames::PoolSize);
+    pPoolUtilizationLabel->SetLabel(wxString::Format(wxT("In use: %lld of %lld (%s)"),
+        static_cast<long long>(inUse),
+        static_cast<long long>(size),
+        FormatRate(static_cast<std::uint64_t>(inUse), static_cast<std::uint64_t>(size))));
+
+    auto acquired = mSnapshot.GetCounter(MetricNames::PoolAcquired);
+    auto created = mSnapshot.GetCounter(MetricNames::PoolCreated);
+    /* every acquisition that did not have to open a new connection reused a pooled one */
+    pPoolAcquisitionsLabel->SetLabel(wxString::Format(wxT("Acquired: %llu, opened on demand: %llu (reuse %s)"),
+        static_cast<unsigned long long>(acquired),
+        static_cast<unsigned long long>(created),
+        FormatRate(acquired > created ? acquired - created : 0, acquired)));
+
+    auto hits = mSnapshot.GetCounter(MetricNames::PageCacheHits);
+    auto misses = mSnapshot.GetCounter(MetricNames::PageCacheMisses);
+    pPageCacheLabel->SetLabel(wxString::Format(wxT("Page cache hit rate: %s (%llu of %llu)"),
+        FormatRate(hits, hits + misses),
+        static_cast<unsigned long long>(hits),
+        static_cast<unsigned long long>(hits + misses)));
+
+    auto chunksWritten = mSnapshot.GetCounter(MetricNames::BackupChunksWritten);
+    auto chunksReused = mSnapshot.GetCounter(MetricNames::BackupChunksReused);
+    pChunkReuseLabel->SetLabel(wxString::Format(wxT("Backup chunk reuse: %s (%llu of %llu)"),
+        FormatRate(chunksReused, chunksWritten + chunksReused),
+        static_cast<unsigned long long>(chunksReused),
+        static_cast<unsigned long long>(chunksWritten + chunksReused)));
+
+    pStopwatchLabel->SetLabel(wxString::Format(wxT("Started: %llu, paused: %llu, stopped: %llu"),
+        static_cast<unsigned long long>(mSnapshot.GetCounter(MetricNames::StopwatchStarted)),
+        static_cast<unsigned long long>(mSnapshot.GetCounter(MetricNames::StopwatchPaused)),
+        static_cast<unsigned long long>(mSnapshot.GetCounter(MetricNames::StopwatchStopped))));
+
+    pListCtrl->Freeze();
+    pListCtrl->RefreshLatencies();
+    pListCtrl->Thaw();
+}
+
+void DiagnosticsDialog::OnRefreshTimer(wxTimerEvent& WXUNUSED(event))
+{
+    FillControls();
+    Layout();
+}
+
+void DiagnosticsDialog::OnSaveSnapshot(wxCommandEvent& WXUNUSED(event))
+{
+    /* save exactly what is on screen */
+    pRefreshTimer->Stop();
+
+    wxFileDialog saveFileDialog(this,
+        wxT("Save Snapshot"),
+        cfg::ConfigurationProvider::Get().Configuration->GetExportPath(),
+        wxString::Format(wxT("Taskable_Metrics_%lld.json"), static_cast<long long>(mSnapshot.TimestampMilliseconds)),
+        wxT("JSON files (*.json)|*.json"),
+        wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+    if (saveFileDialog.ShowModal() == wxID_OK) {
+        std::ofstream snapshotFile(saveFileDialog.GetPath().ToStdString(), std::ios_base::out | std::ios_base::binary);
+        snapshotFile << mSnapshot.ToJson();
+        if (snapshotFile) {
+            pFeedbackLabel->SetLabel(wxT("Snapshot saved successfully"));
+        } else {
+            pLogger->error("Error when trying to write the metrics snapshot to {0}",
+                saveFileDialog.GetPath().ToStdString());
+            pFeedbackLabel->SetLabel(wxT("Saving the snapshot encountered an error!"));
+        }
+        Layout();
+    }
+
+    pRefreshTimer->Start(RefreshIntervalMilliseconds);
+}
+} // namespace app::dlg
@@ -0,0 +1,103 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <memory>
+
+#include <spdlog/spdlog.h>
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <wx/timer.h>
+
+#include "../common/metrics.h"
+
+namespace app::dlg
+{
+/* Virtual list of the latency histograms, one row per query, export format or backup mode */
+class LatencyListCtrl final : public wxListCtrl
+{
+public:
+    LatencyListCtrl(wxWindow* parent, wxWindowID windowId, const common::MetricsSnapshot& snapshot);
+    virtual ~LatencyListCtrl() = default;
+
+    void RefreshLatencies();
+
+private:
+    wxString OnGetItemText(long item, long column) const override;
+
+    const common::MetricsSnapshot& mSnapshot;
+};
+
+/* Read-only view of the in-process metrics, refreshed every second while it is open */
+class DiagnosticsDialog final : public wxDialog
+{
+public:
+    DiagnosticsDialog() = delete;
+    DiagnosticsDialog(wxWindow* parent,
+        std::shared_ptr<spdlog::logger> logger,
+        const wxString& name = wxT("diagnosticsdlg"));
+    virtual ~DiagnosticsDialog() = default;
+
+private:
+    bool Create(wxWindow* parent,
+        wxWindowID windowId,
+        const wxString& title,
+        const wxPoint& position,
+        const wxSize& size,
+        long style,
+        const wxString& name);
+
+    void CreateControls();
+    void ConfigureEventBindings();
+    void FillControls();
+
+    void OnRefreshTimer(wxTimerEvent& event);
+    void OnSaveSnapshot(wxCommandEvent& event);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+
+    common::MetricsSnapshot mSnapshot;
+    std::unique_ptr<wxTimer> pRefreshTimer;
+
+    wxStaticText* pPoolUtilizationLabel;
+    wxStaticText* pPoolAcquisitionsLabel;
+    wxStaticText* pPageCacheLabel;
+    wxStaticText* pChunkReuseLabel;
+    wxStaticText* pStopwatchLabel;
+    LatencyListCtrl* pListCtrl;
+    wxStaticText* pFeedbackLabel;
+    wxButton* pSaveButton;
+    wxButton* pOkButton;
+
+    static const int RefreshIntervalMilliseconds;
+
+    enum {
+        IDC_POOL_UTILIZATION = wxID_HIGHEST + 1,
+        IDC_POOL_ACQUISITIONS,
+        IDC_PAGE_CACHE,
+        IDC_CHUNK_REUSE,
+        IDC_STOPWATCH,
+        IDC_LIST,
+        IDC_FEEDBACK,
+        IDC_SAVEBUTTON,
+        IDC_REFRESH_TIMER
+    };
+};
+} // namespace app::dlg
@@ -24,9 +24,11 @@
 #include <wx/utils.h>
 
 #include "../common/common.h"
+#include "../common/constants.h"
 #include "../common/resources.h"
+#include "../common/util.h"
 #include "../config/configurationprovider.h"
-#include "../services/csvexporter.h"
+#include "../services/exporter.h"
 
 namespace app::dlg
 {
@@ -35,6 +37,7 @@ ExportToCsvDialog::ExportToCsvDialog(wxWindow* parent, std::shared_ptr<spdlog::l
     , pStartDateCtrl(nullptr)
     , pEndDateCtrl(nullptr)
     , pDelimiterTextCtrl(nullptr)
+    , pFormatChoiceCtrl(nullptr)
     , pExportFilePathCtrl(nullptr)
     , pBrowseExportPathButton(nullptr)
     , pExportFileNameCtrl(nullptr)
@@ -144,6 +147,14 @@ void ExportToCsvDialog::CreateControls()
     pDelimiterTextCtrl->SetToolTip("Set the delimiter to use in the exported file");
     optionsFlexGridSizer->Add(pDelimiterTextCtrl, common::sizers::ControlDefault);
 
+    /* Format choice control */
+    auto formatLabel = new wxStaticText(optionsPanel, wxID_ANY, "Format");
+    optionsFlexGridSizer->Add(formatLabel, common::sizers::ControlCenter);
+
+    pFormatChoiceCtrl = new wxChoice(optionsPanel, IDC_FORMAT, wxDefaultPosition, wxSize(150, -1));
+    pFormatChoiceCtrl->SetToolTip("Set the file format of the exported data");
+    optionsFlexGridSizer->Add(pFormatChoiceCtrl, common::sizers::ControlDefault);
+
     /* Right Sizer */
     /* File Options static box*/
     auto fileOptionsStaticBox = new wxStaticBox(this, wxID_ANY, "File Options");
@@ -229,6 +240,12 @@ void ExportToCsvDialog::ConfigureEventBindings()
         this
     );
 
+    pFormatChoiceCtrl->Bind(
+        wxEVT_CHOICE,
+        &ExportToCsvDialog::OnFormatChange,
+        this
+    );
+
     pBrowseExportPathButton->Bind(
         wxEVT_BUTTON,
         &ExportToCsvDialog::OnOpenDirectoryForExportLocation,
@@ -255,6 +272,13 @@ void ExportToCsvDialog::FillControls()
         pDelimiterTextCtrl->ChangeValue(configDelimiter);
     }
 
+    pFormatChoiceCtrl->Append("CSV", util::IntToVoidPointer(static_cast<int>(constants::ExportFormats::Csv)));
+    pFormatChoiceCtrl->Append(
+        "JSON Lines", util::IntToVoidPointer(static_cast<int>(constants::ExportFormats::JsonLines)));
+    pFormatChoiceCtrl->Append(
+        "Columnar (binary)", util::IntToVoidPointer(static_cast<int>(constants::ExportFormats::Columnar)));
+    pFormatChoiceCtrl->SetSelection(0);
+
     auto exportPath = cfg::ConfigurationProvider::Get().Configuration->GetExportPath();
     if (exportPath.length() > 0 && wxDirExists(exportPath)) {
         pExportFilePathCtrl->ChangeValue(exportPath);
@@ -326,21 +350,27 @@ void ExportToCsvDialog::OnExport(wxCommandEvent& event)
         return;
     }
 
+    /* get the selected format */
+    auto format = static_cast<constants::ExportFormats>(
+        util::VoidPointerToInt(pFormatChoiceCtrl->GetClientData(pFormatChoiceCtrl->GetSelection())));
+    wxString extension = svc::GetExportFileExtension(format);
+
     /* get the filename and validate or generate it */
     auto fileName = pExportFileNameCtrl->GetValue();
     if (fileName.empty()) {
-        fileName = "Taskable_Export_" + startDate + "_" + endDate + ".csv";
+        fileName = "Taskable_Export_" + startDate + "_" + endDate + extension;
     } else {
-        if (!fileName.Contains(".csv")) {
-            fileName += ".csv";
+        if (!fileName.Contains(extension)) {
+            fileName += extension;
         }
     }
 
     wxBeginBusyCursor();
 
     /* do the export and display the operation output */
-    svc::CsvExporter csvExporter(pLogger, startDate.ToStdString(), endDate.ToStdString(), fileName.ToStdString());
-    if (csvExporter.ExportData()) {
+    auto exporter =
+        svc::CreateExporter(format, pLogger, startDate.ToStdString(), endDate.ToStdString(), fileName.ToStdString());
+    if (exporter && exporter->ExportData()) {
         pFeedbackLabel->SetLabel("Success! Click 'OK' to close the dialog.");
     } else {
         wxString errorMessage = "Data export encountered an error!";
@@ -367,6 +397,15 @@ void ExportToCsvDialog::OnDelimiterChange(wxCommandEvent& event)
     }
 }
 
+void ExportToCsvDialog::OnFormatChange(wxCommandEvent& event)
+{
+    auto format = static_cast<constants::ExportFormats>(util::VoidPointerToInt(event.GetClientData()));
+
+    /* the delimiter only applies to CSV */
+    pDelimiterTextCtrl->Enable(format == constants::ExportFormats::Csv);
+    pExportFileNameCtrl->SetHint("Exported Data" + svc::GetExportFileExtension(format));
+}
+
 void ExportToCsvDialog::DateValidationProcedure()
 {
     auto startDate = pStartDateCtrl->GetValue();
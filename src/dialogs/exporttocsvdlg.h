@@ -50,6 +50,7 @@ class ExportToCsvDialog final : public wxDialog
     void OnOpenDirectoryForExportLocation(wxCommandEvent& event);
     void OnExport(wxCommandEvent& event);
     void OnDelimiterChange(wxCommandEvent& event);
+    void OnFormatChange(wxCommandEvent& event);
 
     void DateValidationProcedure();
 
@@ -58,6 +59,7 @@ class ExportToCsvDialog final : public wxDialog
     wxDatePickerCtrl* pStartDateCtrl;
     wxDatePickerCtrl* pEndDateCtrl;
     wxTextCtrl* pDelimiterTextCtrl;
+    wxChoice* pFormatChoiceCtrl;
     wxTextCtrl* pExportFilePathCtrl;
     wxButton* pBrowseExportPathButton;
     wxTextCtrl* pExportFileNameCtrl;
@@ -69,6 +71,7 @@ class ExportToCsvDialog final : public wxDialog
         IDC_STARTDATE = wxID_HIGHEST + 1,
         IDC_ENDDATE,
         IDC_DELIMITER,
+        IDC_FORMAT,
         IDC_EXPORTPATH,
         IDC_EXPORTPATHBUTTON,
         IDC_EXPORTFILE,
@@ -37,6 +37,14 @@ DatabasePage::DatabasePage(wxWindow* parent, cfg::Configuration* config)
     , pBackupPathTextCtrl(nullptr)
     , pBrowseBackupPathButton(nullptr)
     , pDeleteBackupsAfterCtrl(nullptr)
+    , pKeepDailyBackupsCtrl(nullptr)
+    , pKeepWeeklyBackupsCtrl(nullptr)
+    , pKeepMonthlyBackupsCtrl(nullptr)
+    , pKeepYearlyBackupsCtrl(nullptr)
+    , pBackupIntervalCtrl(nullptr)
+    , pBackupIdleDelayCtrl(nullptr)
+    , pCompressBackupsCtrl(nullptr)
+    , pIncrementalBackupsCtrl(nullptr)
 {
     CreateControls();
     ConfigureEventBindings();
@@ -49,6 +57,14 @@ void DatabasePage::Apply()
     pConfig->SetBackupEnabled(pBackupDatabaseCtrl->GetValue());
     pConfig->SetBackupPath(pBackupPathTextCtrl->GetValue());
     pConfig->SetDeleteBackupsAfter(std::stoi(pDeleteBackupsAfterCtrl->GetValue().ToStdString()));
+    pConfig->SetKeepDailyBackups(std::stoi(pKeepDailyBackupsCtrl->GetValue().ToStdString()));
+    pConfig->SetKeepWeeklyBackups(std::stoi(pKeepWeeklyBackupsCtrl->GetValue().ToStdString()));
+    pConfig->SetKeepMonthlyBackups(std::stoi(pKeepMonthlyBackupsCtrl->GetValue().ToStdString()));
+    pConfig->SetKeepYearlyBackups(std::stoi(pKeepYearlyBackupsCtrl->GetValue().ToStdString()));
+    pConfig->SetBackupInterval(std::stoi(pBackupIntervalCtrl->GetValue().ToStdString()));
+    pConfig->SetBackupIdleDelay(std::stoi(pBackupIdleDelayCtrl->GetValue().ToStdString()));
+    pConfig->SetCompressBackups(pCompressBackupsCtrl->GetValue());
+    pConfig->SetIncrementalBackups(pIncrementalBackupsCtrl->GetValue());
 }
 
 void DatabasePage::CreateControls()
@@ -108,11 +124,14 @@ void DatabasePage::CreateControls()
     auto databaseBackupsBox = new wxStaticBox(this, wxID_ANY, wxT("Backup Options"));
     auto databaseBackupsSizer = new wxStaticBoxSizer(databaseBackupsBox, wxHORIZONTAL);
 
-    auto backupOptionsSizer = new wxBoxSizer(wxHORIZONTAL);
+    auto backupOptionsSizer = new wxBoxSizer(wxVERTICAL);
     databaseBackupsSizer->Add(backupOptionsSizer, 1, wxALL | wxEXPAND, 5);
 
+    auto deleteBackupsAfterSizer = new wxBoxSizer(wxHORIZONTAL);
+    backupOptionsSizer->Add(deleteBackupsAfterSizer, common::sizers::ControlDefault);
+
     auto deleteBackupsAfterLabel = new wxStaticText(databaseBackupsBox, wxID_ANY, wxT("Delete Backups After (days)"));
-    backupOptionsSizer->Add(deleteBackupsAfterLabel, common::sizers::ControlCenter);
+    deleteBackupsAfterSizer->Add(deleteBackupsAfterLabel, common::sizers::ControlCenter);
 
     wxIntegerValidator<int> integerValidator;
     integerValidator.SetMin(1);
@@ -126,7 +145,113 @@ void DatabasePage::CreateControls()
         wxTE_CENTRE,
         integerValidator);
     pDeleteBackupsAfterCtrl->SetToolTip(wxT("Number of days to keep a database backup"));
-    backupOptionsSizer->Add(pDeleteBackupsAfterCtrl, common::sizers::ControlDefault);
+    deleteBackupsAfterSizer->Add(pDeleteBackupsAfterCtrl, common::sizers::ControlDefault);
+
+    /* grandfather-father-son retention, any count above zero replaces the days above */
+    auto keepBackupsSizer = new wxBoxSizer(wxHORIZONTAL);
+    backupOptionsSizer->Add(keepBackupsSizer, common::sizers::ControlDefault);
+
+    auto keepBackupsLabel = new wxStaticText(databaseBackupsBox, wxID_ANY, wxT("Keep Backups"));
+    keepBackupsSizer->Add(keepBackupsLabel, common::sizers::ControlCenter);
+
+    wxIntegerValidator<int> keepBackupsValidator;
+    keepBackupsValidator.SetMin(0);
+    keepBackupsValidator.SetMax(999);
+
+    pKeepDailyBackupsCtrl = new wxTextCtrl(databaseBackupsBox,
+        IDC_KEEP_DAILY_BACKUPS,
+        wxT("0"),
+        wxDefaultPosition,
+        wxSize(42, -1),
+        wxTE_CENTRE,
+        keepBackupsValidator);
+    pKeepDailyBackupsCtrl->SetToolTip(wxT("Number of days to keep the newest backup of, 0 for none"));
+    keepBackupsSizer->Add(pKeepDailyBackupsCtrl, common::sizers::ControlDefault);
+
+    auto keepDailyBackupsLabel = new wxStaticText(databaseBackupsBox, wxID_ANY, wxT("Daily"));
+    keepBackupsSizer->Add(keepDailyBackupsLabel, common::sizers::ControlCenter);
+
+    pKeepWeeklyBackupsCtrl = new wxTextCtrl(databaseBackupsBox,
+        IDC_KEEP_WEEKLY_BACKUPS,
+        wxT("0"),
+        wxDefaultPosition,
+        wxSize(42, -1),
+        wxTE_CENTRE,
+        keepBackupsValidator);
+    pKeepWeeklyBackupsCtrl->SetToolTip(wxT("Number of weeks to keep the newest backup of, 0 for none"));
+    keepBackupsSizer->Add(pKeepWeeklyBackupsCtrl, common::sizers::ControlDefault);
+
+    auto keepWeeklyBackupsLabel = new wxStaticText(databaseBackupsBox, wxID_ANY, wxT("Weekly"));
+    keepBackupsSizer->Add(keepWeeklyBackupsLabel, common::sizers::ControlCenter);
+
+    pKeepMonthlyBackupsCtrl = new wxTextCtrl(databaseBackupsBox,
+        IDC_KEEP_MONTHLY_BACKUPS,
+        wxT("0"),
+        wxDefaultPosition,
+        wxSize(42, -1),
+        wxTE_CENTRE,
+        keepBackupsValidator);
+    pKeepMonthlyBackupsCtrl->SetToolTip(wxT("Number of months to keep the newest backup of, 0 for none"));
+    keepBackupsSizer->Add(pKeepMonthlyBackupsCtrl, common::sizers::ControlDefault);
+
+    auto keepMonthlyBackupsLabel = new wxStaticText(databaseBackupsBox, wxID_ANY, wxT("Monthly"));
+    keepBackupsSizer->Add(keepMonthlyBackupsLabel, common::sizers::ControlCenter);
+
+    pKeepYearlyBackupsCtrl = new wxTextCtrl(databaseBackupsBox,
+        IDC_KEEP_YEARLY_BACKUPS,
+        wxT("0"),
+        wxDefaultPosition,
+        wxSize(42, -1),
+        wxTE_CENTRE,
+        keepBackupsValidator);
+    pKeepYearlyBackupsCtrl->SetToolTip(wxT("Number of years to keep the newest backup of, 0 for none"));
+    keepBackupsSizer->Add(pKeepYearlyBackupsCtrl, common::sizers::ControlDefault);
+
+    auto keepYearlyBackupsLabel = new wxStaticText(databaseBackupsBox, wxID_ANY, wxT("Yearly"));
+    keepBackupsSizer->Add(keepYearlyBackupsLabel, common::sizers::ControlCenter);
+
+    /* backups taken while the application runs, on top of the one taken on exit */
+    auto scheduledBackupsSizer = new wxBoxSizer(wxHORIZONTAL);
+    backupOptionsSizer->Add(scheduledBackupsSizer, common::sizers::ControlDefault);
+
+    auto backupIntervalLabel = new wxStaticText(databaseBackupsBox, wxID_ANY, wxT("Backup Every (minutes)"));
+    scheduledBackupsSizer->Add(backupIntervalLabel, common::sizers::ControlCenter);
+
+    wxIntegerValidator<int> scheduledBackupsValidator;
+    scheduledBackupsValidator.SetMin(0);
+    scheduledBackupsValidator.SetMax(1440);
+
+    pBackupIntervalCtrl = new wxTextCtrl(databaseBackupsBox,
+        IDC_BACKUP_INTERVAL,
+        wxT("60"),
+        wxDefaultPosition,
+        wxSize(42, -1),
+        wxTE_CENTRE,
+        scheduledBackupsValidator);
+    pBackupIntervalCtrl->SetToolTip(wxT("Back up changes made during the session this often, 0 to disable"));
+    scheduledBackupsSizer->Add(pBackupIntervalCtrl, common::sizers::ControlDefault);
+
+    auto backupIdleDelayLabel = new wxStaticText(databaseBackupsBox, wxID_ANY, wxT("When Idle For (minutes)"));
+    scheduledBackupsSizer->Add(backupIdleDelayLabel, common::sizers::ControlCenter);
+
+    pBackupIdleDelayCtrl = new wxTextCtrl(databaseBackupsBox,
+        IDC_BACKUP_IDLE_DELAY,
+        wxT("10"),
+        wxDefaultPosition,
+        wxSize(42, -1),
+        wxTE_CENTRE,
+        scheduledBackupsValidator);
+    pBackupIdleDelayCtrl->SetToolTip(wxT("Back up changes once nothing else was saved for this long, 0 to disable"));
+    scheduledBackupsSizer->Add(pBackupIdleDelayCtrl, common::sizers::ControlDefault);
+
+    pCompressBackupsCtrl = new wxCheckBox(databaseBackupsBox, IDC_COMPRESS_BACKUPS, wxT("Compress Backups"));
+    pCompressBackupsCtrl->SetToolTip(wxT("Store backups as gzip compressed files to save disk space"));
+    backupOptionsSizer->Add(pCompressBackupsCtrl, common::sizers::ControlDefault);
+
+    pIncrementalBackupsCtrl = new wxCheckBox(databaseBackupsBox, IDC_INCREMENTAL_BACKUPS, wxT("Incremental Backups"));
+    pIncrementalBackupsCtrl->SetToolTip(wxT("Only store the parts of the database that changed since the last backup, "
+                                            "takes precedence over compression"));
+    backupOptionsSizer->Add(pIncrementalBackupsCtrl, common::sizers::ControlDefault);
 
     sizer->Add(databaseBackupsSizer, 0, wxLEFT | wxRIGHT | wxEXPAND, 5);
 
@@ -150,11 +275,27 @@ void DatabasePage::FillControls()
     pBackupDatabaseCtrl->SetValue(pConfig->IsBackupEnabled());
     pBackupPathTextCtrl->SetValue(pConfig->GetBackupPath());
     pDeleteBackupsAfterCtrl->SetValue(wxString(std::to_string(pConfig->GetDeleteBackupsAfter())));
+    pKeepDailyBackupsCtrl->SetValue(wxString(std::to_string(pConfig->GetKeepDailyBackups())));
+    pKeepWeeklyBackupsCtrl->SetValue(wxString(std::to_string(pConfig->GetKeepWeeklyBackups())));
+    pKeepMonthlyBackupsCtrl->SetValue(wxString(std::to_string(pConfig->GetKeepMonthlyBackups())));
+    pKeepYearlyBackupsCtrl->SetValue(wxString(std::to_string(pConfig->GetKeepYearlyBackups())));
+    pBackupIntervalCtrl->SetValue(wxString(std::to_string(pConfig->GetBackupInterval())));
+    pBackupIdleDelayCtrl->SetValue(wxString(std::to_string(pConfig->GetBackupIdleDelay())));
+    pCompressBackupsCtrl->SetValue(pConfig->IsCompressBackups());
+    pIncrementalBackupsCtrl->SetValue(pConfig->IsIncrementalBackups());
 
     if (!pBackupDatabaseCtrl->GetValue()) {
         pBackupPathTextCtrl->Disable();
         pBrowseBackupPathButton->Disable();
         pDeleteBackupsAfterCtrl->Disable();
+        pKeepDailyBackupsCtrl->Disable();
+        pKeepWeeklyBackupsCtrl->Disable();
+        pKeepMonthlyBackupsCtrl->Disable();
+        pKeepYearlyBackupsCtrl->Disable();
+        pBackupIntervalCtrl->Disable();
+        pBackupIdleDelayCtrl->Disable();
+        pCompressBackupsCtrl->Disable();
+        pIncrementalBackupsCtrl->Disable();
     }
 }
 
@@ -186,10 +327,26 @@ void DatabasePage::OnBackupDatabaseCheck(wxCommandEvent& event)
         pBackupPathTextCtrl->Enable();
         pBrowseBackupPathButton->Enable();
         pDeleteBackupsAfterCtrl->Enable();
+        pKeepDailyBackupsCtrl->Enable();
+        pKeepWeeklyBackupsCtrl->Enable();
+        pKeepMonthlyBackupsCtrl->Enable();
+        pKeepYearlyBackupsCtrl->Enable();
+        pBackupIntervalCtrl->Enable();
+        pBackupIdleDelayCtrl->Enable();
+        pCompressBackupsCtrl->Enable();
+        pIncrementalBackupsCtrl->Enable();
     } else {
         pBackupPathTextCtrl->Disable();
         pBrowseBackupPathButton->Disable();
         pDeleteBackupsAfterCtrl->Disable();
+        pKeepDailyBackupsCtrl->Disable();
+        pKeepWeeklyBackupsCtrl->Disable();
+        pKeepMonthlyBackupsCtrl->Disable();
+        pKeepYearlyBackupsCtrl->Disable();
+        pBackupIntervalCtrl->Disable();
+        pBackupIdleDelayCtrl->Disable();
+        pCompressBackupsCtrl->Disable();
+        pIncrementalBackupsCtrl->Disable();
     }
 }
 
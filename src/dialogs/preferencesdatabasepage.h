@@ -58,6 +58,14 @@ class DatabasePage final : public wxPanel
     wxTextCtrl* pBackupPathTextCtrl;
     wxButton* pBrowseBackupPathButton;
     wxTextCtrl* pDeleteBackupsAfterCtrl;
+    wxTextCtrl* pKeepDailyBackupsCtrl;
+    wxTextCtrl* pKeepWeeklyBackupsCtrl;
+    wxTextCtrl* pKeepMonthlyBackupsCtrl;
+    wxTextCtrl* pKeepYearlyBackupsCtrl;
+    wxTextCtrl* pBackupIntervalCtrl;
+    wxTextCtrl* pBackupIdleDelayCtrl;
+    wxCheckBox* pCompressBackupsCtrl;
+    wxCheckBox* pIncrementalBackupsCtrl;
 
     enum {
         IDC_DATABASE_PATH = wxID_HIGHEST + 1,
@@ -65,7 +73,15 @@ class DatabasePage final : public wxPanel
         IDC_BACKUP_DATABASE,
         IDC_BACKUP_PATH,
         IDC_BACKUP_PATH_BUTTON,
-        IDC_DELETE_BACKUPS_AFTER
+        IDC_DELETE_BACKUPS_AFTER,
+        IDC_KEEP_DAILY_BACKUPS,
+        IDC_KEEP_WEEKLY_BACKUPS,
+        IDC_KEEP_MONTHLY_BACKUPS,
+        IDC_KEEP_YEARLY_BACKUPS,
+        IDC_BACKUP_INTERVAL,
+        IDC_BACKUP_IDLE_DELAY,
+        IDC_COMPRESS_BACKUPS,
+        IDC_INCREMENTAL_BACKUPS
     };
 };
 } // namespace app::dlg
@@ -111,7 +111,11 @@ void PreferencesDialog::OnOk(wxCommandEvent& event)
         return;
     }
 
-    if (cfg::ConfigurationProvider::Get().Configuration->IsBackupEnabled() &&
+    bool tieredRetention = cfg::ConfigurationProvider::Get().Configuration->GetKeepDailyBackups() > 0 ||
+                           cfg::ConfigurationProvider::Get().Configuration->GetKeepWeeklyBackups() > 0 ||
+                           cfg::ConfigurationProvider::Get().Configuration->GetKeepMonthlyBackups() > 0 ||
+                           cfg::ConfigurationProvider::Get().Configuration->GetKeepYearlyBackups() > 0;
+    if (cfg::ConfigurationProvider::Get().Configuration->IsBackupEnabled() && !tieredRetention &&
         cfg::ConfigurationProvider::Get().Configuration->GetDeleteBackupsAfter() <= 0) {
         wxMessageBox("A positive non-zero value is required if backups are enabled",
             common::GetProgramName(),
@@ -0,0 +1,337 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "reportdlg.h"
+
+#include <fstream>
+
+#include <wx/richtooltip.h>
+#include <wx/statline.h>
+
+#include "../common/common.h"
+#include "../common/constants.h"
+#include "../common/resources.h"
+#include "../common/util.h"
+#include "../config/configurationprovider.h"
+
+namespace app::dlg
+{
+ReportListCtrl::ReportListCtrl(wxWindow* parent, wxWindowID windowId, const svc::ReportTable& table)
+    : wxListCtrl(parent,
+          windowId,
+          wxDefaultPosition,
+          wxSize(-1, 320),
+          wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL | wxLC_HRULES | wxLC_VRULES)
+    , mTable(table)
+{
+}
+
+void ReportListCtrl::RefreshReport()
+{
+    const bool hasBreakdown = mTable.Breakdown != constants::ReportGroupings::None;
+
+    ClearAll();
+
+    int column = 0;
+    InsertColumn(column++, svc::GetReportGroupingName(mTable.Grouping), wxLIST_FORMAT_LEFT, 180);
+    if (hasBreakdown) {
+        InsertColumn(column++, svc::GetReportGroupingName(mTable.Breakdown), wxLIST_FORMAT_LEFT, 120);
+    }
+    InsertColumn(column++, wxT("Entries"), wxLIST_FORMAT_RIGHT, 70);
+    InsertColumn(column++, wxT("Hours"), wxLIST_FORMAT_RIGHT, 80);
+    InsertColumn(column++, wxT("Billable Hours"), wxLIST_FORMAT_RIGHT, 100);
+    InsertColumn(column++, wxT("Billable Amount"), wxLIST_FORMAT_RIGHT, 110);
+
+    /* the last item is the totals row */
+    SetItemCount(static_cast<long>(mTable.Rows.size()) + 1);
+    Refresh();
+}
+
+wxString ReportListCtrl::OnGetItemText(long item, long column) const
+{
+    const bool isTotals = item == static_cast<long>(mTable.Rows.size());
+    const svc::ReportRow& row = isTotals ? mTable.Totals : mTable.Rows[item];
+
+    /* shift the value columns when there is no breakdown column */
+    if (mTable.Breakdown == constants::ReportGroupings::None && column > 0) {
+        column++;
+    }
+
+    switch (column) {
+    case 0:
+        return wxString::FromUTF8(row.Group.c_str());
+    case 1:
+        return wxString::FromUTF8(row.Breakdown.c_str());
+    case 2:
+        return wxString::Format(wxT("%d"), row.Entries);
+    case 3:
+        return svc::FormatReportHours(row.Seconds);
+    case 4:
+        return svc::FormatReportHours(row.BillableSeconds);
+    case 5:
+        return svc::FormatReportAmount(row.BillableAmount);
+    default:
+        return wxGetEmptyString();
+    }
+}
+
+ReportDialog::ReportDialog(wxWindow* parent, std::shared_ptr<spdlog::logger> logger, const wxString& name)
+    : pLogger(logger)
+    , mTable()
+    , pStartDateCtrl(nullptr)
+    , pEndDateCtrl(nullptr)
+    , pGroupingChoiceCtrl(nullptr)
+    , pBreakdownChoiceCtrl(nullptr)
+    , pRunButton(nullptr)
+    , pListCtrl(nullptr)
+    , pFeedbackLabel(nullptr)
+    , pExportButton(nullptr)
+    , pOkButton(nullptr)
+{
+    Create(parent,
+        wxID_ANY,
+        wxT("Summary Report"),
+        wxDefaultPosition,
+        wxDefaultSize,
+        wxCAPTION | wxCLOSE_BOX | wxRESIZE_BORDER,
+        name);
+}
+
+bool ReportDialog::Create(wxWindow* parent,
+    wxWindowID windowId,
+    const wxString& title,
+    const wxPoint& position,
+    const wxSize& size,
+    long style,
+    const wxString& name)
+{
+    bool created = wxDialog::Create(parent, windowId, title, position, size, style, name);
+    if (created) {
+        CreateControls();
+        ConfigureEventBindings();
+        FillControls();
+
+        GetSizer()->Fit(this);
+        SetIcon(rc::GetProgramIcon());
+        Centre();
+    }
+    return created;
+}
+
+void ReportDialog::CreateControls()
+{
+    /* Window Sizing */
+    auto mainSizer = new wxBoxSizer(wxVERTICAL);
+    SetSizer(mainSizer);
+
+    /* Sizer for top controls */
+    auto topSizer = new wxBoxSizer(wxHORIZONTAL);
+    mainSizer->Add(topSizer, common::sizers::ControlDefault);
+
+    /* Date Range static box */
+    auto dateRangeStaticBox = new wxStaticBox(this, wxID_ANY, wxT("Date Range"));
+    auto dateRangeStaticBoxSizer = new wxStaticBoxSizer(dateRangeStaticBox, wxHORIZONTAL);
+    topSizer->Add(dateRangeStaticBoxSizer, common::sizers::ControlExpand);
+
+    /* Start date picker */
+    auto startDateLabel = new wxStaticText(dateRangeStaticBox, wxID_ANY, wxT("Start"));
+    dateRangeStaticBoxSizer->Add(startDateLabel, common::sizers::ControlCenter);
+
+    pStartDateCtrl = new wxDatePickerCtrl(
+        dateRangeStaticBox, IDC_STARTDATE, wxDefaultDateTime, wxDefaultPosition, wxSize(150, -1), wxDP_DROPDOWN);
+    pStartDateCtrl->SetToolTip(wxT("Set the start date range for the report"));
+    dateRangeStaticBoxSizer->Add(pStartDateCtrl, common::sizers::ControlDefault);
+
+    /* End date picker */
+    auto endDateLabel = new wxStaticText(dateRangeStaticBox, wxID_ANY, wxT("End"));
+    dateRangeStaticBoxSizer->Add(endDateLabel, common::sizers::ControlCenter);
+
+    pEndDateCtrl = new wxDatePickerCtrl(
+        dateRangeStaticBox, IDC_ENDDATE, wxDefaultDateTime, wxDefaultPosition, wxSize(150, -1), wxDP_DROPDOWN);
+    pEndDateCtrl->SetToolTip(wxT("Set the end date range for the report"));
+    dateRangeStaticBoxSizer->Add(pEndDateCtrl, common::sizers::ControlDefault);
+
+    /* Options static box */
+    auto optionsStaticBox = new wxStaticBox(this, wxID_ANY, wxT("Options"));
+    auto optionsStaticBoxSizer = new wxStaticBoxSizer(optionsStaticBox, wxHORIZONTAL);
+    topSizer->Add(optionsStaticBoxSizer, common::sizers::ControlExpand);
+
+    /* Grouping choice control */
+    auto groupingLabel = new wxStaticText(optionsStaticBox, wxID_ANY, wxT("Group By"));
+    optionsStaticBoxSizer->Add(groupingLabel, common::sizers::ControlCenter);
+
+    pGroupingChoiceCtrl = new wxChoice(optionsStaticBox, IDC_GROUPING, wxDefaultPosition, wxSize(120, -1));
+    pGroupingChoiceCtrl->SetToolTip(wxT("Set what to total the time and billable amounts by"));
+    optionsStaticBoxSizer->Add(pGroupingChoiceCtrl, common::sizers::ControlDefault);
+
+    /* Breakdown choice control */
+    auto breakdownLabel = new wxStaticText(optionsStaticBox, wxID_ANY, wxT("Then By"));
+    optionsStaticBoxSizer->Add(breakdownLabel, common::sizers::ControlCenter);
+
+    pBreakdownChoiceCtrl = new wxChoice(optionsStaticBox, IDC_BREAKDOWN, wxDefaultPosition, wxSize(120, -1));
+    pBreakdownChoiceCtrl->SetToolTip(wxT("Optionally break each group down further"));
+    optionsStaticBoxSizer->Add(pBreakdownChoiceCtrl, common::sizers::ControlDefault);
+
+    /* Run button */
+    pRunButton = new wxButton(this, IDC_RUNBUTTON, wxT("Run"));
+    topSizer->Add(pRunButton, common::sizers::ControlCenter);
+
+    /* Report list control */
+    pListCtrl = new ReportListCtrl(this, IDC_LIST, mTable);
+    mainSizer->Add(pListCtrl, wxSizerFlags(1).Border(wxALL, 5).Expand());
+
+    /* Feedback label */
+    pFeedbackLabel = new wxStaticText(this, IDC_FEEDBACK, wxGetEmptyString());
+    mainSizer->Add(pFeedbackLabel, common::sizers::ControlDefault);
+
+    /* Horizontal Line*/
+    auto bottomSeparationLine = new wxStaticLine(this, wxID_ANY, wxDefaultPosition, wxSize(3, 3), wxLI_HORIZONTAL);
+    mainSizer->Add(bottomSeparationLine, wxSizerFlags().Border(wxLEFT | wxRIGHT, 5).Expand());
+
+    /* Button panel */
+    auto buttonPanelSizer = new wxBoxSizer(wxHORIZONTAL);
+
+    auto buttonPanel = new wxPanel(this, wxID_STATIC);
+    buttonPanel->SetSizer(buttonPanelSizer);
+
+    mainSizer->Add(buttonPanel, common::sizers::ControlRight);
+
+    pExportButton = new wxButton(buttonPanel, IDC_EXPORTBUTTON, wxT("Export..."));
+    pExportButton->Disable();
+    buttonPanelSizer->Add(pExportButton, common::sizers::ControlDefault);
+
+    pOkButton = new wxButton(buttonPanel, wxID_OK, wxT("OK"));
+    buttonPanelSizer->Add(pOkButton, wxSizerFlags().Border(wxALL, 5));
+}
+
+// clang-format off
+void ReportDialog::ConfigureEventBindings()
+{
+    pRunButton->Bind(
+        wxEVT_BUTTON,
+        &ReportDialog::OnRun,
+        this,
+        IDC_RUNBUTTON
+    );
+
+    pExportButton->Bind(
+        wxEVT_BUTTON,
+        &ReportDialog::OnExport,
+        this,
+        IDC_EXPORTBUTTON
+    );
+}
+// clang-format on
+
+void ReportDialog::FillControls()
+{
+    /* default to the current month */
+    auto today = wxDateTime::Today();
+    pStartDateCtrl->SetValue(wxDateTime(1, today.GetMonth(), today.GetYear()));
+    pEndDateCtrl->SetValue(today);
+
+    for (auto grouping : { constants::ReportGroupings::Project,
+             constants::ReportGroupings::Client,
+             constants::ReportGroupings::Employer,
+             constants::ReportGroupings::Category,
+             constants::ReportGroupings::TaskItemType,
+             constants::ReportGroupings::Day,
+             constants::ReportGroupings::Week,
+             constants::ReportGroupings::Month }) {
+        auto name = svc::GetReportGroupingName(grouping);
+        pGroupingChoiceCtrl->Append(name, util::IntToVoidPointer(static_cast<int>(grouping)));
+        pBreakdownChoiceCtrl->Append(name, util::IntToVoidPointer(static_cast<int>(grouping)));
+    }
+    pBreakdownChoiceCtrl->Insert(
+        wxT("(None)"), 0, util::IntToVoidPointer(static_cast<int>(constants::ReportGroupings::None)));
+
+    pGroupingChoiceCtrl->SetSelection(0);
+    pBreakdownChoiceCtrl->SetSelection(0);
+}
+
+void ReportDialog::OnRun(wxCommandEvent& WXUNUSED(event))
+{
+    auto start = pStartDateCtrl->GetValue();
+    auto end = pEndDateCtrl->GetValue();
+
+    if (start.IsLaterThan(end)) {
+        wxRichToolTip tooltip(wxT("Start Date"), wxT("End date cannot go before start date"));
+        tooltip.SetIcon(wxICON_WARNING);
+        tooltip.ShowFor(pStartDateCtrl);
+        return;
+    }
+
+    auto grouping = static_cast<constants::ReportGroupings>(
+        util::VoidPointerToInt(pGroupingChoiceCtrl->GetClientData(pGroupingChoiceCtrl->GetSelection())));
+    auto breakdown = static_cast<constants::ReportGroupings>(
+        util::VoidPointerToInt(pBreakdownChoiceCtrl->GetClientData(pBreakdownChoiceCtrl->GetSelection())));
+
+    wxBeginBusyCursor();
+
+    svc::ReportService reportService(pLogger);
+    bool success = reportService.Run(
+        grouping, breakdown, start.FormatISODate().ToStdString(), end.FormatISODate().ToStdString(), mTable);
+
+    wxEndBusyCursor();
+
+    if (success) {
+        pListCtrl->RefreshReport();
+        pFeedbackLabel->SetLabel(wxString::Format(wxT("%d row(s)"), static_cast<int>(mTable.Rows.size())));
+    } else {
+        mTable.Rows.clear();
+        pListCtrl->DeleteAllItems();
+        pFeedbackLabel->SetLabel(wxT("Report encountered an error!"));
+    }
+
+    pExportButton->Enable(success);
+    Layout();
+}
+
+void ReportDialog::OnExport(wxCommandEvent& WXUNUSED(event))
+{
+    auto defaultFileName = wxString::Format(wxT("Taskable_Report_%s_%s_%s.csv"),
+        svc::GetReportGroupingName(mTable.Grouping),
+        mTable.FromDate,
+        mTable.ToDate);
+
+    wxFileDialog saveFileDialog(this,
+        wxT("Export Report"),
+        cfg::ConfigurationProvider::Get().Configuration->GetExportPath(),
+        defaultFileName,
+        wxT("CSV files (*.csv)|*.csv"),
+        wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+    if (saveFileDialog.ShowModal() != wxID_OK) {
+        return;
+    }
+
+    std::string configDelimiter = cfg::ConfigurationProvider::Get().Configuration->GetDelimiter();
+    char delimiter = configDelimiter.empty() ? ',' : configDelimiter[0];
+
+    std::ofstream reportFile(saveFileDialog.GetPath().ToStdString(), std::ios_base::out | std::ios_base::binary);
+    if (reportFile && svc::WriteReportCsv(mTable, reportFile, delimiter)) {
+        pFeedbackLabel->SetLabel(wxT("Report exported successfully"));
+    } else {
+        pLogger->error("Error when trying to write the report to {0}", saveFileDialog.GetPath().ToStdString());
+        pFeedbackLabel->SetLabel(wxT("Report export encountered an error!"));
+    }
+
+    Layout();
+}
+} // namespace app::dlg
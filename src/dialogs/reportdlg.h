@@ -0,0 +1,96 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <memory>
+
+#include <spdlog/spdlog.h>
+#include <wx/wx.h>
+#include <wx/datectrl.h>
+#include <wx/listctrl.h>
+
+#include "../services/reportservice.h"
+
+namespace app::dlg
+{
+/* Virtual list so that large breakdowns (e.g. category by day) do not create a native item per row */
+class ReportListCtrl final : public wxListCtrl
+{
+public:
+    ReportListCtrl(wxWindow* parent, wxWindowID windowId, const svc::ReportTable& table);
+    virtual ~ReportListCtrl() = default;
+
+    void RefreshReport();
+
+private:
+    wxString OnGetItemText(long item, long column) const override;
+
+    const svc::ReportTable& mTable;
+};
+
+class ReportDialog final : public wxDialog
+{
+public:
+    ReportDialog() = delete;
+    ReportDialog(wxWindow* parent, std::shared_ptr<spdlog::logger> logger, const wxString& name = wxT("reportdlg"));
+    virtual ~ReportDialog() = default;
+
+private:
+    bool Create(wxWindow* parent,
+        wxWindowID windowId,
+        const wxString& title,
+        const wxPoint& position,
+        const wxSize& size,
+        long style,
+        const wxString& name);
+
+    void CreateControls();
+    void ConfigureEventBindings();
+    void FillControls();
+
+    void OnRun(wxCommandEvent& event);
+    void OnExport(wxCommandEvent& event);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+
+    svc::ReportTable mTable;
+
+    wxDatePickerCtrl* pStartDateCtrl;
+    wxDatePickerCtrl* pEndDateCtrl;
+    wxChoice* pGroupingChoiceCtrl;
+    wxChoice* pBreakdownChoiceCtrl;
+    wxButton* pRunButton;
+    ReportListCtrl* pListCtrl;
+    wxStaticText* pFeedbackLabel;
+    wxButton* pExportButton;
+    wxButton* pOkButton;
+
+    enum {
+        IDC_STARTDATE = wxID_HIGHEST + 1,
+        IDC_ENDDATE,
+        IDC_GROUPING,
+        IDC_BREAKDOWN,
+        IDC_RUNBUTTON,
+        IDC_LIST,
+        IDC_FEEDBACK,
+        IDC_EXPORTBUTTON
+    };
+};
+} // namespace app::dlg
@@ -23,6 +23,7 @@
 #include <wx/statline.h>
 
 #include "../common/common.h"
+#include "../common/metrics.h"
 #include "../common/resources.h"
 #include "../common/util.h"
 #include "../config/configurationprovider.h"
@@ -76,6 +77,7 @@ StopwatchTaskDialog::StopwatchTaskDialog(wxWindow* parent,
     , mEndTime(wxDefaultDateTime)
     , bWasTaskPaused(false)
     , bHasPendingPausedTask(false)
+    , mConfigurationSubscription(0)
 // clang-format on
 {
     Create(parent,
@@ -85,6 +87,9 @@ StopwatchTaskDialog::StopwatchTaskDialog(wxWindow* parent,
         wxSize(420, 380),
         wxCAPTION | wxCLOSE_BOX | wxSYSTEM_MENU,
         name);
+
+    mConfigurationSubscription = cfg::ConfigurationProvider::Get().Subscribe(
+        [this](const cfg::ConfigurationChanges& changes) { OnConfigurationChanged(changes); });
 }
 
 StopwatchTaskDialog::StopwatchTaskDialog(wxWindow* parent,
@@ -113,6 +118,7 @@ StopwatchTaskDialog::StopwatchTaskDialog(wxWindow* parent,
     , mEndTime(wxDefaultDateTime)
     , bWasTaskPaused(false)
     , bHasPendingPausedTask(hasPendingPausedTask)
+    , mConfigurationSubscription(0)
 {
     Create(parent,
         wxID_ANY,
@@ -121,6 +127,14 @@ StopwatchTaskDialog::StopwatchTaskDialog(wxWindow* parent,
         wxSize(420, 320),
         wxCAPTION | wxCLOSE_BOX | wxSYSTEM_MENU,
         name);
+
+    mConfigurationSubscription = cfg::ConfigurationProvider::Get().Subscribe(
+        [this](const cfg::ConfigurationChanges& changes) { OnConfigurationChanged(changes); });
+}
+
+StopwatchTaskDialog::~StopwatchTaskDialog()
+{
+    cfg::ConfigurationProvider::Get().Unsubscribe(mConfigurationSubscription);
 }
 
 void StopwatchTaskDialog::Launch()
@@ -272,6 +286,8 @@ void StopwatchTaskDialog::CreateControls()
 
 void StopwatchTaskDialog::ExecuteStartupProcedure()
 {
+    common::MetricsRegistry::Get().GetCounter(common::MetricNames::StopwatchStarted).Increment();
+
     /* get the current time */
     mStartTime = wxDateTime::Now();
 
@@ -305,6 +321,8 @@ void StopwatchTaskDialog::ExecuteStartupProcedure()
 
 void StopwatchTaskDialog::ExecutePauseProcedure()
 {
+    common::MetricsRegistry::Get().GetCounter(common::MetricNames::StopwatchPaused).Increment();
+
     /* set state */
     bIsPaused = true;
     bWasTaskPaused = true;
@@ -352,6 +370,8 @@ void StopwatchTaskDialog::ExecutePauseProcedure()
 
 void StopwatchTaskDialog::ExecuteStopProcedure()
 {
+    common::MetricsRegistry::Get().GetCounter(common::MetricNames::StopwatchStopped).Increment();
+
     /* did the user go from pause to stop state? */
     if (!bIsPaused) {
         /* get the current end time */
@@ -457,4 +477,22 @@ void StopwatchTaskDialog::OnClose(wxCloseEvent& event)
     EndModal(wxID_CLOSE);
 }
 
+void StopwatchTaskDialog::OnConfigurationChanged(const cfg::ConfigurationChanges& changes)
+{
+    if (!changes.Stopwatch) {
+        return;
+    }
+
+    /* restart the running timers so the new intervals apply to the current task */
+    if (pNotificationTimer->IsRunning()) {
+        pNotificationTimer->Start(util::MinutesToMilliseconds(
+            cfg::ConfigurationProvider::Get().Configuration->GetNotificationTimerInterval()));
+    }
+
+    if (pPausedTaskReminder->IsRunning()) {
+        pPausedTaskReminder->Start(util::MinutesToMilliseconds(
+            cfg::ConfigurationProvider::Get().Configuration->GetPausedTaskReminderInterval()));
+    }
+}
+
 } // namespace app::dlg
@@ -25,6 +25,7 @@
 
 #include <spdlog/spdlog.h>
 
+#include "../config/configuration.h"
 #include "../services/taskstateservice.h"
 #include "../frame/taskbaricon.h"
 
@@ -50,7 +51,7 @@ class StopwatchTaskDialog : public wxDialog
         bool hasPendingPausedTask,
         const wxString& name = wxT("stopwatchtaskdlg"));
 
-    virtual ~StopwatchTaskDialog() = default;
+    virtual ~StopwatchTaskDialog();
 
     void Launch();
     void Relaunch();
@@ -81,6 +82,7 @@ class StopwatchTaskDialog : public wxDialog
     void OnStop(wxCommandEvent& event);
     void OnCancel(wxCommandEvent& event);
     void OnClose(wxCloseEvent& event);
+    void OnConfigurationChanged(const cfg::ConfigurationChanges& changes);
 
     std::shared_ptr<spdlog::logger> pLogger;
     std::shared_ptr<services::TaskStateService> pTaskState;
@@ -105,6 +107,7 @@ class StopwatchTaskDialog : public wxDialog
     bool bIsPaused;
     bool bWasTaskPaused;
     bool bHasPendingPausedTask;
+    int mConfigurationSubscription;
 
     enum {
         IDC_ELAPSED = wxID_HIGHEST + 1,
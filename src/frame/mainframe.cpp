@@ -25,12 +25,14 @@
 
 #include <wx/aboutdlg.h>
 #include <wx/clipbrd.h>
+#include <wx/evtloop.h>
 #include <wx/taskbarbutton.h>
 
 #include "../common/constants.h"
 #include "../common/common.h"
 #include "../common/ids.h"
 #include "../common/resources.h"
+#include "../common/tracer.h"
 #include "../common/util.h"
 #include "../common/version.h"
 
@@ -49,6 +51,9 @@
 
 #include "../dialogs/weeklytaskviewdlg.h"
 #include "../dialogs/meetingsviewdlg.h"
+#include "../dialogs/databasebackupdlg.h"
+#include "../dialogs/reportdlg.h"
+#include "../dialogs/diagnosticsdlg.h"
 
 #include "../dialogs/preferencesdlg.h"
 
@@ -59,9 +64,139 @@
 
 #include "../services/databasebackup.h"
 #include "../services/databasebackupdeleter.h"
+#include "../services/databasemaintenance.h"
+#include "../services/backupverifier.h"
+
+wxDEFINE_EVENT(BACKUP_VERIFICATION_THREAD_FAILED, wxThreadEvent);
+wxDEFINE_EVENT(BACKUP_VERIFICATION_REQUESTED, wxThreadEvent);
+wxDEFINE_EVENT(SCHEDULED_BACKUP_THREAD_COMPLETED, wxThreadEvent);
+wxDEFINE_EVENT(STARTUP_DATA_THREAD_COMPLETED, wxThreadEvent);
 
 namespace app::frm
 {
+BackupVerificationThread::BackupVerificationThread(MainFrame* handler, std::shared_ptr<spdlog::logger> logger)
+    : wxThread(wxTHREAD_DETACHED)
+    , pHandler(handler)
+    , pLogger(logger)
+    , bCancelled(false)
+{
+}
+
+BackupVerificationThread::~BackupVerificationThread()
+{
+    wxCriticalSectionLocker enter(pHandler->mCriticalSection);
+    pHandler->pBackupVerificationThread = nullptr;
+
+    /* decided under the same lock StartBackupVerification checks, so no request is lost */
+    if (pHandler->bBackupVerificationRequested && !bCancelled) {
+        wxQueueEvent(pHandler, new wxThreadEvent(BACKUP_VERIFICATION_REQUESTED));
+    }
+    pHandler->bBackupVerificationRequested = false;
+}
+
+wxThread::ExitCode BackupVerificationThread::Entry()
+{
+    svc::BackupVerifier backupVerifier(pLogger,
+        cfg::ConfigurationProvider::Get().Configuration->GetBackupPath(),
+        common::GetDatabaseFilePath(cfg::ConfigurationProvider::Get().Configuration->GetDatabasePath()),
+        [&]() { return TestDestroy(); });
+    bool success = backupVerifier.Execute();
+
+    if (backupVerifier.IsCancelled()) {
+        bCancelled = true;
+        return (wxThread::ExitCode) 1;
+    }
+
+    if (!success) {
+        pLogger->error("Backup verification could not be run");
+        return (wxThread::ExitCode) 1;
+    }
+
+    const auto& failures = backupVerifier.GetFailures();
+    if (!failures.empty()) {
+        auto event = new wxThreadEvent(BACKUP_VERIFICATION_THREAD_FAILED);
+        auto message = wxString::Format(wxT("Verification failed for %s"), failures.front());
+        if (failures.size() > 1) {
+            message += wxString::Format(wxT(" and %d more"), static_cast<int>(failures.size() - 1));
+        }
+
+        event->SetString(message + wxT(", see the log for details"));
+        wxQueueEvent(pHandler, event);
+    }
+
+    return (wxThread::ExitCode) 0;
+}
+
+ScheduledBackupThread::ScheduledBackupThread(MainFrame* handler, std::shared_ptr<spdlog::logger> logger)
+    : wxThread(wxTHREAD_DETACHED)
+    , pHandler(handler)
+    , pLogger(logger)
+{
+}
+
+ScheduledBackupThread::~ScheduledBackupThread()
+{
+    wxCriticalSectionLocker enter(pHandler->mCriticalSection);
+    pHandler->pScheduledBackupThread = nullptr;
+}
+
+wxThread::ExitCode ScheduledBackupThread::Entry()
+{
+    svc::DatabaseBackup databaseBackup(pLogger);
+    bool success = databaseBackup.Execute(svc::DatabaseBackup::DefaultPagesPerStep,
+        svc::DatabaseBackup::DefaultStepSleepMilliseconds,
+        [&](int, int) { return !TestDestroy(); });
+
+    if (databaseBackup.IsCancelled()) {
+        return (wxThread::ExitCode) 1;
+    }
+
+    auto event = new wxThreadEvent(SCHEDULED_BACKUP_THREAD_COMPLETED);
+    event->SetInt(success ? 1 : 0);
+    wxQueueEvent(pHandler, event);
+
+    return (wxThread::ExitCode) 0;
+}
+
+StartupDataThread::StartupDataThread(MainFrame* handler, std::shared_ptr<spdlog::logger> logger, wxDateTime date)
+    : wxThread(wxTHREAD_DETACHED)
+    , pHandler(handler)
+    , pLogger(logger)
+    , mDate(date)
+{
+}
+
+StartupDataThread::~StartupDataThread()
+{
+    wxCriticalSectionLocker enter(pHandler->mCriticalSection);
+    pHandler->pStartupDataThread = nullptr;
+}
+
+wxThread::ExitCode StartupDataThread::Entry()
+{
+    common::TraceSpan traceSpan("StartupDataThread::Entry");
+
+    auto dateString = mDate.FormatISODate();
+    auto startupData = std::make_shared<StartupData>();
+    try {
+        data::TaskItemData taskItemData;
+        startupData->TaskDurations = taskItemData.GetHours(dateString);
+        startupData->TaskItems = taskItemData.GetByDate(dateString);
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured when loading startup data - {0:d} : {1}", e.get_code(), e.what());
+    }
+
+    if (TestDestroy()) {
+        return (wxThread::ExitCode) 1;
+    }
+
+    auto event = new wxThreadEvent(STARTUP_DATA_THREAD_COMPLETED);
+    event->SetPayload(startupData);
+    wxQueueEvent(pHandler, event);
+
+    return (wxThread::ExitCode) 0;
+}
+
 // clang-format off
 wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
 /* General Event Handlers */
@@ -69,6 +204,7 @@ EVT_CLOSE(MainFrame::OnClose)
 EVT_ICONIZE(MainFrame::OnIconize)
 EVT_SIZE(MainFrame::OnResize)
 EVT_TIMER(IDC_DISMISS_INFOBAR_TIMER, MainFrame::OnDismissInfoBar)
+EVT_TIMER(IDC_BACKUP_SCHEDULER_TIMER, MainFrame::OnBackupSchedulerTimer)
 /* Main Menu Event Handlers */
 EVT_MENU(wxID_ABOUT, MainFrame::OnAbout)
 EVT_MENU(wxID_EXIT, MainFrame::OnExit)
@@ -80,6 +216,7 @@ EVT_MENU(ids::ID_NEW_CLIENT, MainFrame::OnNewClient)
 EVT_MENU(ids::ID_NEW_CATEGORY, MainFrame::OnNewCategory)
 EVT_MENU(ids::ID_WEEKLY_VIEW, MainFrame::OnWeeklyView)
 EVT_MENU(ids::ID_MEETINGS_VIEW, MainFrame::OnMeetingsView)
+EVT_MENU(ids::ID_REPORT_VIEW, MainFrame::OnReportView)
 EVT_MENU(ids::ID_EDIT_EMPLOYER, MainFrame::OnEditEmployer)
 EVT_MENU(ids::ID_EDIT_CLIENT, MainFrame::OnEditClient)
 EVT_MENU(ids::ID_EDIT_PROJECT, MainFrame::OnEditProject)
@@ -87,6 +224,7 @@ EVT_MENU(ids::ID_EDIT_CATEGORY, MainFrame::OnEditCategory)
 EVT_MENU(ids::ID_PREFERENCES, MainFrame::OnPreferences)
 EVT_MENU(ids::ID_STOPWATCH_TASK, MainFrame::OnTaskStopwatch)
 EVT_MENU(ids::ID_CHECK_FOR_UPDATE, MainFrame::OnCheckForUpdate)
+EVT_MENU(ids::ID_DIAGNOSTICS, MainFrame::OnDiagnostics)
 EVT_MENU(ids::ID_RESTORE_DATABASE, MainFrame::OnRestoreDatabase)
 EVT_MENU(ids::ID_BACKUP_DATABASE, MainFrame::OnBackupDatabase)
 EVT_MENU(ids::ID_RETURN_TO_CURRENT_DATE, MainFrame::OnReturnToCurrentDate)
@@ -115,10 +253,17 @@ MainFrame::MainFrame(std::shared_ptr<spdlog::logger> logger,
     const wxString& name)
     :wxFrame(
         nullptr, wxID_ANY, common::GetProgramName(), wxDefaultPosition, wxSize(600, 500), wxDEFAULT_FRAME_STYLE, name)
+    , pBackupVerificationThread(nullptr)
+    , pScheduledBackupThread(nullptr)
+    , pStartupDataThread(nullptr)
+    , bBackupVerificationRequested(false)
+    , mCriticalSection()
     , pLogger(logger)
     , pTaskState(std::make_shared<services::TaskStateService>())
     , pTaskStorage(std::make_unique<services::TaskStorage>())
     , pDismissInfoBarTimer(std::make_unique<wxTimer>(this, IDC_DISMISS_INFOBAR_TIMER))
+    , pBackupSchedulerTimer(std::make_unique<wxTimer>(this, IDC_BACKUP_SCHEDULER_TIMER))
+    , pBackupScheduler(nullptr)
     , pPrevDayBtn(nullptr)
     , pDatePickerCtrl(nullptr)
     , pNextDayBtn(nullptr)
@@ -128,16 +273,23 @@ MainFrame::MainFrame(std::shared_ptr<spdlog::logger> logger,
     , pInfoBar(nullptr)
     , pTaskBarIcon(nullptr)
     , bHasPendingTaskToResume(false)
+    , bStartupDataPending(false)
+    , bStartupDataStale(false)
+    , bFirstPaintDone(false)
+    , mFirstPaintMicroseconds(0)
     , pFeedbackButton(nullptr)
     , pFeedbackPopupWindow(nullptr)
     , mItemIndex(-1)
     , mSelectedTaskItemId(-1)
+    , mConfigurationSubscription(0)
 // clang-format on
 {
 }
 
 MainFrame::~MainFrame()
 {
+    cfg::ConfigurationProvider::Get().Unsubscribe(mConfigurationSubscription);
+
     auto size = GetSize();
     int w = size.GetWidth();
     int h = size.GetHeight();
@@ -149,11 +301,20 @@ MainFrame::~MainFrame()
         delete pTaskBarIcon;
     }
 
-    RunDatabaseBackup();
+    /*
+     decided before maintenance: its ANALYZE and vacuum commits bump data_version without changing any data,
+     which would make every scheduled backup look out of date. Compacting first means the exit backup copies
+     fewer pages.
+     */
+    bool backupUpToDate = pBackupScheduler && pBackupScheduler->IsUpToDate();
+    RunDatabaseMaintenance();
+    RunDatabaseBackup(backupUpToDate);
 }
 
 bool MainFrame::CreateFrame()
 {
+    common::TraceSpan traceSpan("MainFrame::CreateFrame");
+
     auto configSize = cfg::ConfigurationProvider::Get().Configuration->GetFrameSize();
     auto dimensionsSplit = util::lib::split(configSize, ',');
     int w = std::stoi(dimensionsSplit[0]);
@@ -164,9 +325,33 @@ bool MainFrame::CreateFrame()
     SetMinSize(wxSize(850, 580));
     SetIcon(rc::GetProgramIcon());
 
+    // clang-format off
+    Bind(
+        BACKUP_VERIFICATION_THREAD_FAILED,
+        &MainFrame::OnBackupVerificationFailed,
+        this
+    );
+
+    Bind(
+        BACKUP_VERIFICATION_REQUESTED,
+        &MainFrame::OnBackupVerificationRequested,
+        this
+    );
+
+    /* forwarded by the backup dialog */
+    Bind(
+        DATABASE_BACKUP_THREAD_COMPLETED,
+        &MainFrame::OnDatabaseBackupCompleted,
+        this
+    );
+    // clang-format on
+
     if (cfg::ConfigurationProvider::Get().Configuration->IsBackupEnabled()) {
-        svc::DatabaseBackupDeleter dbBackupDeleter;
+        svc::DatabaseBackupDeleter dbBackupDeleter(pLogger);
         dbBackupDeleter.Execute();
+
+        StartBackupVerification();
+        StartBackupScheduler();
     }
 
     pTaskBarIcon = new TaskBarIcon(this, pLogger);
@@ -174,9 +359,48 @@ bool MainFrame::CreateFrame()
         pTaskBarIcon->SetTaskBarIcon();
     }
 
+    mConfigurationSubscription = cfg::ConfigurationProvider::Get().Subscribe(
+        [this](const cfg::ConfigurationChanges& changes) { OnConfigurationChanged(changes); });
+
     return success;
 }
 
+void MainFrame::ExecuteInstanceCommand(common::InstanceCommands command)
+{
+    /* same as restoring the frame from the tray icon */
+    MSWGetTaskBarButton()->Show();
+    Restore();
+    Raise();
+    Show();
+
+    if (command == common::InstanceCommands::StartStopwatch) {
+        auto runningStopwatchDialog = wxWindow::FindWindowByName(wxT("stopwatchtaskdlg"), this);
+        if (runningStopwatchDialog) {
+            runningStopwatchDialog->Show();
+            runningStopwatchDialog->Raise();
+            return;
+        }
+    }
+
+    /* a modal dialog is running its own event loop, do not open another one on top of it */
+    auto activeEventLoop = wxEventLoopBase::GetActive();
+    if (activeEventLoop != nullptr && !activeEventLoop->IsMain()) {
+        pLogger->info("A dialog is open, only bringing the window to the front");
+        return;
+    }
+
+    switch (command) {
+    case common::InstanceCommands::StartStopwatch:
+        wxQueueEvent(this, new wxCommandEvent(wxEVT_MENU, ids::ID_STOPWATCH_TASK));
+        break;
+    case common::InstanceCommands::NewEntry:
+        wxQueueEvent(this, new wxCommandEvent(wxEVT_MENU, ids::ID_NEW_ENTRY_TASK));
+        break;
+    default:
+        break;
+    }
+}
+
 bool MainFrame::Create()
 {
     CreateControls();
@@ -187,6 +411,8 @@ bool MainFrame::Create()
 
 void MainFrame::CreateControls()
 {
+    common::TraceSpan traceSpan("MainFrame::CreateControls");
+
     /* Status Bar Control */
     int statusBarWidths[] = { 156, -1, 36 };
 
@@ -232,6 +458,7 @@ void MainFrame::CreateControls()
     auto fileViewMenu = new wxMenu();
     fileViewMenu->Append(ids::ID_WEEKLY_VIEW, wxT("Week View"));
     fileViewMenu->Append(ids::ID_MEETINGS_VIEW, wxT("Meetings View"));
+    fileViewMenu->Append(ids::ID_REPORT_VIEW, wxT("Summary Report"));
     fileMenu->AppendSubMenu(fileViewMenu, wxT("View"));
     fileMenu->AppendSeparator();
     auto exitMenuItem = fileMenu->Append(wxID_EXIT, wxT("Exit"), wxT("Exit the application"));
@@ -268,6 +495,7 @@ void MainFrame::CreateControls()
     auto checkUpdateMenuItem = helpMenu->Append(
         ids::ID_CHECK_FOR_UPDATE, wxT("Check for Update"), wxT("Check if an update is available for application"));
     checkUpdateMenuItem->SetBitmap(rc::GetCheckForUpdateIcon());
+    helpMenu->Append(ids::ID_DIAGNOSTICS, wxT("Diagnostics"), wxT("View connection pool, cache and latency metrics"));
 
     /* Menu Bar */
     wxMenuBar* menuBar = new wxMenuBar();
@@ -393,6 +621,19 @@ void MainFrame::CreateControls()
 
 void MainFrame::DataToControls()
 {
+    // clang-format off
+    Bind(
+        wxEVT_IDLE,
+        &MainFrame::OnFirstIdle,
+        this
+    );
+    // clang-format on
+
+    /* the frame is shown with a placeholder straight away and filled in once the data arrives */
+    if (StartStartupDataLoad()) {
+        return;
+    }
+
     CalculateTotalTime();
     FillListControl();
 }
@@ -412,6 +653,9 @@ void MainFrame::OnClose(wxCloseEvent& event)
         MSWGetTaskBarButton()->Hide();
         return;
     }
+
+    pBackupSchedulerTimer->Stop();
+    StopBackgroundThreads();
     event.Skip();
 }
 
@@ -448,6 +692,31 @@ void MainFrame::OnDismissInfoBar(wxTimerEvent& event)
     pInfoBar->Dismiss();
 }
 
+void MainFrame::OnBackupSchedulerTimer(wxTimerEvent& WXUNUSED(event))
+{
+    {
+        wxCriticalSectionLocker enter(mCriticalSection);
+        if (pScheduledBackupThread) {
+            return;
+        }
+    }
+
+    if (!pBackupScheduler->IsBackupDue()) {
+        return;
+    }
+
+    pScheduledBackupThread = new ScheduledBackupThread(this, pLogger);
+    auto ret = pScheduledBackupThread->Run();
+    if (ret != wxTHREAD_NO_ERROR) {
+        pLogger->error("Could not start the scheduled backup thread");
+        delete pScheduledBackupThread;
+        pScheduledBackupThread = nullptr;
+        return;
+    }
+
+    pBackupScheduler->BackupStarted();
+}
+
 void MainFrame::OnAbout(wxCommandEvent& event)
 {
     wxAboutDialogInfo aboutInfo;
@@ -526,6 +795,12 @@ void MainFrame::OnMeetingsView(wxCommandEvent& event)
     meetingViewDialog->LaunchModeless();
 }
 
+void MainFrame::OnReportView(wxCommandEvent& WXUNUSED(event))
+{
+    dlg::ReportDialog reportDialog(this, pLogger);
+    reportDialog.ShowModal();
+}
+
 void MainFrame::OnEditEmployer(wxCommandEvent& event)
 {
     dlg::EditListDialog employerEdit(this, dlg::DialogType::Employer, pLogger);
@@ -574,6 +849,12 @@ void MainFrame::OnCheckForUpdate(wxCommandEvent& event)
     checkForUpdate.LaunchModal();
 }
 
+void MainFrame::OnDiagnostics(wxCommandEvent& WXUNUSED(event))
+{
+    dlg::DiagnosticsDialog diagnosticsDialog(this, pLogger);
+    diagnosticsDialog.ShowModal();
+}
+
 void MainFrame::OnRestoreDatabase(wxCommandEvent& event)
 {
     if (cfg::ConfigurationProvider::Get().Configuration->IsBackupEnabled()) {
@@ -591,16 +872,15 @@ void MainFrame::OnRestoreDatabase(wxCommandEvent& event)
 void MainFrame::OnBackupDatabase(wxCommandEvent& event)
 {
     if (cfg::ConfigurationProvider::Get().Configuration->IsBackupEnabled()) {
-        svc::DatabaseBackup databaseBackup(pLogger);
-        bool result = databaseBackup.Execute();
-        if (result) {
-            wxMessageBox(
-                wxT("Backup completed successfully!"), common::GetProgramName(), wxOK_DEFAULT | wxICON_INFORMATION);
-        } else {
-            wxMessageBox(wxT("Backup database operation encountered error(s)!"),
-                common::GetProgramName(),
-                wxOK_DEFAULT | wxICON_ERROR);
+        /* a backup is already running, both would write to the same file */
+        auto runningBackupDialog = wxWindow::FindWindowByName(wxT("databasebackupdlg"), this);
+        if (runningBackupDialog) {
+            runningBackupDialog->Raise();
+            return;
         }
+
+        dlg::DatabaseBackupDialog* databaseBackupDialog = new dlg::DatabaseBackupDialog(this, pLogger);
+        databaseBackupDialog->LaunchModeless();
     } else {
         wxMessageBox(
             wxT("Warning! Backup option is turned off"), common::GetProgramName(), wxOK_DEFAULT | wxICON_WARNING);
@@ -772,6 +1052,10 @@ void MainFrame::OnColumnBeginDrag(wxListEvent& event)
 
 void MainFrame::OnTaskInserted(wxCommandEvent& event)
 {
+    if (bStartupDataPending) {
+        bStartupDataStale = true;
+    }
+
     auto selectedDate = pDatePickerCtrl->GetValue();
 
     CalculateTotalTime(selectedDate);
@@ -800,7 +1084,7 @@ void MainFrame::OnTaskInserted(wxCommandEvent& event)
         pListCtrl->SetItem(listIndex, columnIndex++, taskItem->GetCategory()->GetName());
         pListCtrl->SetItem(listIndex, columnIndex++, taskItem->GetDescription());
 
-        pListCtrl->SetItemBackgroundColour(listIndex, taskItem->GetCategory()->GetColor());
+        pListCtrl->SetItemBackgroundColour(listIndex, wxColour(taskItem->GetCategory()->GetColor()));
 
         pListCtrl->SetItemPtrData(listIndex, static_cast<wxUIntPtr>(taskItem->GetTaskItemId()));
     }
@@ -834,7 +1118,7 @@ void MainFrame::OnTaskUpdated(wxCommandEvent& event)
     pListCtrl->SetItem(mItemIndex, columnIndex++, taskItem->GetCategory()->GetName());
     pListCtrl->SetItem(mItemIndex, columnIndex++, taskItem->GetDescription());
 
-    pListCtrl->SetItemBackgroundColour(mItemIndex, taskItem->GetCategory()->GetColor());
+    pListCtrl->SetItemBackgroundColour(mItemIndex, wxColour(taskItem->GetCategory()->GetColor()));
 
     pListCtrl->SetItemPtrData(mItemIndex, static_cast<wxUIntPtr>(taskItem->GetTaskItemId()));
 
@@ -873,8 +1157,88 @@ void MainFrame::OnNewStopwatchTaskFromPausedStopwatchTask(wxCommandEvent& event)
     pListCtrl->SetFocus();
 }
 
+void MainFrame::OnBackupVerificationFailed(wxThreadEvent& event)
+{
+    /* stays visible until dismissed, a failed backup must not go unnoticed */
+    pDismissInfoBarTimer->Stop();
+    pInfoBar->ShowMessage(event.GetString(), wxICON_WARNING);
+}
+
+void MainFrame::OnBackupVerificationRequested(wxThreadEvent& WXUNUSED(event))
+{
+    StartBackupVerification();
+}
+
+void MainFrame::OnDatabaseBackupCompleted(wxThreadEvent& WXUNUSED(event))
+{
+    StartBackupVerification();
+}
+
+void MainFrame::OnScheduledBackupCompleted(wxThreadEvent& event)
+{
+    bool success = event.GetInt() == 1;
+    if (!success) {
+        pLogger->error("Scheduled database backup encountered error(s)");
+    } else {
+        StartBackupVerification();
+    }
+
+    /* backups may have been turned off while this one was running */
+    if (pBackupScheduler) {
+        pBackupScheduler->BackupFinished(success);
+    }
+}
+
+void MainFrame::OnStartupDataLoaded(wxThreadEvent& event)
+{
+    auto startupData = event.GetPayload<std::shared_ptr<StartupData>>();
+    bStartupDataPending = false;
+    SetStatusText(wxT("Ready"), 0);
+
+    if (bStartupDataStale) {
+        /* a task was added or the day changed while loading, the data may be out of date */
+        DateChangedProcedure(pDatePickerCtrl->GetValue());
+    } else {
+        ShowTotalTime(startupData->TaskDurations);
+        ShowTaskItems(startupData->TaskItems);
+    }
+
+    CompleteStartup();
+}
+
+void MainFrame::OnFirstIdle(wxIdleEvent& event)
+{
+    /* the first idle event after Show() comes once the initial paint messages have been handled */
+    Unbind(wxEVT_IDLE, &MainFrame::OnFirstIdle, this);
+
+    bFirstPaintDone = true;
+    mFirstPaintMicroseconds = common::Tracer::Get().Mark("TimeToFirstPaint");
+    CompleteStartup();
+
+    event.Skip();
+}
+
+void MainFrame::OnConfigurationChanged(const cfg::ConfigurationChanges& changes)
+{
+    if (changes.General) {
+        if (cfg::ConfigurationProvider::Get().Configuration->IsShowInTray() && !pTaskBarIcon->IsIconInstalled()) {
+            pTaskBarIcon->SetTaskBarIcon();
+        } else if (!cfg::ConfigurationProvider::Get().Configuration->IsShowInTray() &&
+                   pTaskBarIcon->IsIconInstalled()) {
+            pTaskBarIcon->RemoveIcon();
+        }
+    }
+
+    /* the location, compression and retention settings are read at the start of every backup */
+    if (changes.BackupSchedule) {
+        RestartBackupScheduler();
+    }
+}
+
 void MainFrame::CalculateTotalTime(wxDateTime date)
 {
+    common::TraceSpan traceSpan("MainFrame::CalculateTotalTime");
+
     auto dateString = date.FormatISODate();
 
     data::TaskItemData taskItemData;
@@ -885,8 +1249,13 @@ void MainFrame::CalculateTotalTime(wxDateTime date)
         pLogger->error("Error occured on TaskItemData::GetHours() - {0:d} : {1}", e.get_code(), e.what());
     }
 
+    ShowTotalTime(taskDurations);
+}
+
+void MainFrame::ShowTotalTime(const std::vector<wxString>& taskDurations)
+{
     wxTimeSpan totalDuration;
-    for (auto duration : taskDurations) {
+    for (const auto& duration : taskDurations) {
         std::vector<std::string> durationSplit = util::lib::split(duration.ToStdString(), ':');
 
         wxTimeSpan currentDuration(std::atol(durationSplit[0].c_str()),
@@ -901,6 +1270,8 @@ void MainFrame::CalculateTotalTime(wxDateTime date)
 
 void MainFrame::FillListControl(wxDateTime date)
 {
+    common::TraceSpan traceSpan("MainFrame::FillListControl");
+
     wxString dateString = date.FormatISODate();
 
     data::TaskItemData taskItemData;
@@ -912,6 +1283,11 @@ void MainFrame::FillListControl(wxDateTime date)
         return;
     }
 
+    ShowTaskItems(taskItems);
+}
+
+void MainFrame::ShowTaskItems(const std::vector<std::unique_ptr<model::TaskItemModel>>& taskItems)
+{
     int listIndex = 0;
     int columnIndex = 0;
     for (const auto& taskItem : taskItems) {
@@ -926,7 +1302,7 @@ void MainFrame::FillListControl(wxDateTime date)
         pListCtrl->SetItem(listIndex, columnIndex++, taskItem->GetCategory()->GetName());
         pListCtrl->SetItem(listIndex, columnIndex++, taskItem->GetDescription());
 
-        pListCtrl->SetItemBackgroundColour(listIndex, taskItem->GetCategory()->GetColor());
+        pListCtrl->SetItemBackgroundColour(listIndex, wxColour(taskItem->GetCategory()->GetColor()));
 
         pListCtrl->SetItemPtrData(listIndex, static_cast<wxUIntPtr>(taskItem->GetTaskItemId()));
 
@@ -934,9 +1310,17 @@ void MainFrame::FillListControl(wxDateTime date)
     }
 }
 
-bool MainFrame::RunDatabaseBackup()
+bool MainFrame::RunDatabaseBackup(bool backupUpToDate)
 {
+    common::TraceSpan traceSpan("MainFrame::RunDatabaseBackup");
+
     if (cfg::ConfigurationProvider::Get().Configuration->IsBackupEnabled()) {
+        /* a scheduled backup may already hold everything written during the session */
+        if (backupUpToDate) {
+            pLogger->info("Skipping database backup on exit, no changes since the last scheduled backup");
+            return true;
+        }
+
         svc::DatabaseBackup dbBackup(pLogger);
         return dbBackup.Execute();
     }
@@ -944,6 +1328,175 @@ bool MainFrame::RunDatabaseBackup()
     return true;
 }
 
+bool MainFrame::RunDatabaseMaintenance()
+{
+    common::TraceSpan traceSpan("MainFrame::RunDatabaseMaintenance");
+
+    svc::DatabaseMaintenance dbMaintenance(pLogger);
+    return dbMaintenance.Execute();
+}
+
+/*
+ Runs at startup and after every backup taken during the session. Only backups not verified yet are
+ checked, so a run after a backup costs one quick_check of the new backup and one of the database.
+ */
+void MainFrame::StartBackupVerification()
+{
+    {
+        wxCriticalSectionLocker enter(mCriticalSection);
+        if (pBackupVerificationThread) {
+            bBackupVerificationRequested = true;
+            return;
+        }
+    }
+
+    pBackupVerificationThread = new BackupVerificationThread(this, pLogger);
+    auto ret = pBackupVerificationThread->Create();
+    if (ret == wxTHREAD_NO_ERROR) {
+        /* verification only reads, it should never compete with the UI */
+        pBackupVerificationThread->SetPriority(wxPRIORITY_MIN);
+        ret = pBackupVerificationThread->Run();
+    }
+
+    if (ret != wxTHREAD_NO_ERROR) {
+        pLogger->error("Could not start the backup verification thread");
+        delete pBackupVerificationThread;
+        pBackupVerificationThread = nullptr;
+    }
+}
+
+void MainFrame::StartBackupScheduler()
+{
+    auto interval = cfg::ConfigurationProvider::Get().Configuration->GetBackupInterval();
+    auto idleDelay = cfg::ConfigurationProvider::Get().Configuration->GetBackupIdleDelay();
+    if (interval <= 0 && idleDelay <= 0) {
+        return;
+    }
+
+    // clang-format off
+    Bind(
+        SCHEDULED_BACKUP_THREAD_COMPLETED,
+        &MainFrame::OnScheduledBackupCompleted,
+        this
+    );
+    // clang-format on
+
+    pBackupScheduler = std::make_unique<svc::BackupScheduler>(pLogger,
+        common::GetDatabaseFilePath(cfg::ConfigurationProvider::Get().Configuration->GetDatabasePath()),
+        cfg::ConfigurationProvider::Get().Configuration->GetBackupPath(),
+        interval,
+        idleDelay);
+    pBackupSchedulerTimer->Start(svc::BackupScheduler::PollIntervalSeconds * 1000);
+}
+
+void MainFrame::RestartBackupScheduler()
+{
+    auto interval = cfg::ConfigurationProvider::Get().Configuration->GetBackupInterval();
+    auto idleDelay = cfg::ConfigurationProvider::Get().Configuration->GetBackupIdleDelay();
+    bool enabled =
+        cfg::ConfigurationProvider::Get().Configuration->IsBackupEnabled() && (interval > 0 || idleDelay > 0);
+
+    /* a new scheduler would only know what the backup index says, this one knows what this session backed up */
+    if (enabled && pBackupScheduler) {
+        pBackupScheduler->Reconfigure(interval, idleDelay);
+        pLogger->info("Backup scheduler reconfigured");
+        return;
+    }
+
+    pBackupSchedulerTimer->Stop();
+    pBackupScheduler.reset();
+    /* StartBackupScheduler binds the completion event again */
+    Unbind(SCHEDULED_BACKUP_THREAD_COMPLETED, &MainFrame::OnScheduledBackupCompleted, this);
+
+    if (enabled) {
+        StartBackupScheduler();
+    }
+
+    pLogger->info("Backup scheduler reconfigured");
+}
+
+bool MainFrame::StartStartupDataLoad()
+{
+    // clang-format off
+    Bind(
+        STARTUP_DATA_THREAD_COMPLETED,
+        &MainFrame::OnStartupDataLoaded,
+        this
+    );
+    // clang-format on
+
+    pStartupDataThread = new StartupDataThread(this, pLogger, wxDateTime::Now());
+    auto ret = pStartupDataThread->Create();
+    if (ret == wxTHREAD_NO_ERROR) {
+        ret = pStartupDataThread->Run();
+    }
+
+    if (ret != wxTHREAD_NO_ERROR) {
+        pLogger->error("Could not start the startup data thread, loading on the UI thread");
+        delete pStartupDataThread;
+        pStartupDataThread = nullptr;
+        return false;
+    }
+
+    bStartupDataPending = true;
+    pTotalHoursText->SetLabel(wxT("Loading..."));
+    SetStatusText(wxT("Loading..."), 0);
+    return true;
+}
+
+void MainFrame::CompleteStartup()
+{
+    /* interactive once the first paint is done and today's data is in the list, in either order */
+    if (!bFirstPaintDone || bStartupDataPending) {
+        return;
+    }
+
+    auto interactiveMicroseconds = common::Tracer::Get().Mark("TimeToInteractive");
+    pLogger->info("Startup: first paint after {0:d}ms, interactive after {1:d}ms",
+        mFirstPaintMicroseconds / 1000,
+        interactiveMicroseconds / 1000);
+}
+
+void MainFrame::StopBackgroundThreads()
+{
+    {
+        wxCriticalSectionLocker enter(mCriticalSection);
+        if (pBackupVerificationThread) {
+            /* the verifier polls TestDestroy() through SQLite's progress handler */
+            auto ret = pBackupVerificationThread->Delete();
+            if (ret != wxTHREAD_NO_ERROR) {
+                wxLogError("Cannot delete thread!");
+            }
+        }
+
+        if (pScheduledBackupThread) {
+            /* the backup checks TestDestroy() after every step and removes the partial file */
+            auto ret = pScheduledBackupThread->Delete();
+            if (ret != wxTHREAD_NO_ERROR) {
+                wxLogError("Cannot delete thread!");
+            }
+        }
+
+        if (pStartupDataThread) {
+            /* only two queries, the thread drops its result once they are done */
+            auto ret = pStartupDataThread->Delete();
+            if (ret != wxTHREAD_NO_ERROR) {
+                wxLogError("Cannot delete thread!");
+            }
+        }
+    }
+
+    while (1) {
+        {
+            wxCriticalSectionLocker enter(mCriticalSection);
+            if (!pBackupVerificationThread && !pScheduledBackupThread && !pStartupDataThread) {
+                break;
+            }
+        }
+        wxThread::This()->Sleep(1);
+    }
+}
+
 void MainFrame::ShowInfoBarMessage(int modalRetCode)
 {
     if (modalRetCode == wxID_OK) {
@@ -959,6 +1512,10 @@ void MainFrame::ShowInfoBarMessage(int modalRetCode)
 
 void MainFrame::DateChangedProcedure(wxDateTime dateTime)
 {
+    if (bStartupDataPending) {
+        bStartupDataStale = true;
+    }
+
     pListCtrl->DeleteAllItems();
     pDatePickerCtrl->SetValue(dateTime);
 
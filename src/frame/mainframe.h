@@ -20,7 +20,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <sqlite_modern_cpp.h>
 
@@ -30,18 +32,81 @@
 #include <wx/dateevt.h>
 #include <wx/infobar.h>
 #include <wx/listctrl.h>
+#include <wx/thread.h>
 #include <wx/timer.h>
 
 #include <spdlog/spdlog.h>
 
+#include "../common/instancechannel.h"
 #include "../config/configurationprovider.h"
+#include "../models/taskitemmodel.h"
 #include "../services/taskstateservice.h"
 #include "../services/taskstorageservice.h"
+#include "../services/backupscheduler.h"
 #include "feedbackpopup.h"
 
+wxDECLARE_EVENT(BACKUP_VERIFICATION_THREAD_FAILED, wxThreadEvent);
+wxDECLARE_EVENT(BACKUP_VERIFICATION_REQUESTED, wxThreadEvent);
+wxDECLARE_EVENT(SCHEDULED_BACKUP_THREAD_COMPLETED, wxThreadEvent);
+wxDECLARE_EVENT(STARTUP_DATA_THREAD_COMPLETED, wxThreadEvent);
+
 namespace app::frm
 {
 class TaskBarIcon;
+class MainFrame;
+
+class BackupVerificationThread : public wxThread
+{
+public:
+    BackupVerificationThread() = delete;
+    BackupVerificationThread(MainFrame* handler, std::shared_ptr<spdlog::logger> logger);
+    virtual ~BackupVerificationThread();
+
+protected:
+    ExitCode Entry() override;
+
+private:
+    MainFrame* pHandler;
+    std::shared_ptr<spdlog::logger> pLogger;
+    bool bCancelled;
+};
+
+class ScheduledBackupThread : public wxThread
+{
+public:
+    ScheduledBackupThread() = delete;
+    ScheduledBackupThread(MainFrame* handler, std::shared_ptr<spdlog::logger> logger);
+    virtual ~ScheduledBackupThread();
+
+protected:
+    ExitCode Entry() override;
+
+private:
+    MainFrame* pHandler;
+    std::shared_ptr<spdlog::logger> pLogger;
+};
+
+/* what the main frame shows for a day, loaded off the UI thread at startup */
+struct StartupData {
+    std::vector<wxString> TaskDurations;
+    std::vector<std::unique_ptr<model::TaskItemModel>> TaskItems;
+};
+
+class StartupDataThread : public wxThread
+{
+public:
+    StartupDataThread() = delete;
+    StartupDataThread(MainFrame* handler, std::shared_ptr<spdlog::logger> logger, wxDateTime date);
+    virtual ~StartupDataThread();
+
+protected:
+    ExitCode Entry() override;
+
+private:
+    MainFrame* pHandler;
+    std::shared_ptr<spdlog::logger> pLogger;
+    wxDateTime mDate;
+};
 
 class MainFrame : public wxFrame
 {
@@ -54,6 +119,16 @@ class MainFrame : public wxFrame
     MainFrame& operator=(const MainFrame&) = delete;
 
     bool CreateFrame();
+    /* a command forwarded by a second launch, or the first launch's own command line */
+    void ExecuteInstanceCommand(common::InstanceCommands command);
+
+protected:
+    BackupVerificationThread* pBackupVerificationThread;
+    ScheduledBackupThread* pScheduledBackupThread;
+    StartupDataThread* pStartupDataThread;
+    /* a backup finished while verification was running, it has to run again for the new backup */
+    bool bBackupVerificationRequested;
+    wxCriticalSection mCriticalSection;
 
 private:
     wxDECLARE_EVENT_TABLE();
@@ -68,6 +143,7 @@ class MainFrame : public wxFrame
     void OnIconize(wxIconizeEvent& event);
     void OnResize(wxSizeEvent& event);
     void OnDismissInfoBar(wxTimerEvent& event);
+    void OnBackupSchedulerTimer(wxTimerEvent& event);
 
     /* Main Menu Event Handlers */
     void OnAbout(wxCommandEvent& event);
@@ -80,6 +156,7 @@ class MainFrame : public wxFrame
     void OnNewCategory(wxCommandEvent& event);
     void OnWeeklyView(wxCommandEvent& event);
     void OnMeetingsView(wxCommandEvent& event);
+    void OnReportView(wxCommandEvent& event);
     void OnEditEmployer(wxCommandEvent& event);
     void OnEditClient(wxCommandEvent& event);
     void OnEditProject(wxCommandEvent& event);
@@ -87,6 +164,7 @@ class MainFrame : public wxFrame
     void OnPreferences(wxCommandEvent& event);
     void OnTaskStopwatch(wxCommandEvent& event);
     void OnCheckForUpdate(wxCommandEvent& event);
+    void OnDiagnostics(wxCommandEvent& event);
     void OnRestoreDatabase(wxCommandEvent& event);
     void OnBackupDatabase(wxCommandEvent& event);
     void OnReturnToCurrentDate(wxCommandEvent& event);
@@ -112,11 +190,28 @@ class MainFrame : public wxFrame
     void OnTaskUpdated(wxCommandEvent& event);
     void OnTaskDeleted(wxCommandEvent& event);
     void OnNewStopwatchTaskFromPausedStopwatchTask(wxCommandEvent& event);
+    void OnBackupVerificationFailed(wxThreadEvent& event);
+    void OnBackupVerificationRequested(wxThreadEvent& event);
+    void OnDatabaseBackupCompleted(wxThreadEvent& event);
+    void OnScheduledBackupCompleted(wxThreadEvent& event);
+    void OnStartupDataLoaded(wxThreadEvent& event);
+    void OnFirstIdle(wxIdleEvent& event);
+    void OnConfigurationChanged(const cfg::ConfigurationChanges& changes);
 
     void CalculateTotalTime(wxDateTime date = wxDateTime::Now());
     void FillListControl(wxDateTime date = wxDateTime::Now());
+    void ShowTotalTime(const std::vector<wxString>& taskDurations);
+    void ShowTaskItems(const std::vector<std::unique_ptr<model::TaskItemModel>>& taskItems);
+
+    bool StartStartupDataLoad();
+    void CompleteStartup();
 
-    bool RunDatabaseBackup();
+    bool RunDatabaseBackup(bool backupUpToDate);
+    bool RunDatabaseMaintenance();
+    void StartBackupVerification();
+    void StartBackupScheduler();
+    void RestartBackupScheduler();
+    void StopBackgroundThreads();
 
     void ShowInfoBarMessage(int modalRetCode);
 
@@ -128,6 +223,8 @@ class MainFrame : public wxFrame
     std::unique_ptr<services::TaskStorage> pTaskStorage;
 
     std::unique_ptr<wxTimer> pDismissInfoBarTimer;
+    std::unique_ptr<wxTimer> pBackupSchedulerTimer;
+    std::unique_ptr<svc::BackupScheduler> pBackupScheduler;
 
     wxButton* pPrevDayBtn;
     wxDatePickerCtrl* pDatePickerCtrl;
@@ -141,8 +238,13 @@ class MainFrame : public wxFrame
     FeedbackPopupWindow* pFeedbackPopupWindow;
 
     bool bHasPendingTaskToResume;
+    bool bStartupDataPending;
+    bool bStartupDataStale;
+    bool bFirstPaintDone;
+    std::int64_t mFirstPaintMicroseconds;
     long mItemIndex;
     int mSelectedTaskItemId;
+    int mConfigurationSubscription;
 
     enum {
         IDC_PREV_DAY = wxID_HIGHEST + 1,
@@ -151,7 +253,12 @@ class MainFrame : public wxFrame
         IDC_HOURS_TEXT,
         IDC_LIST,
         IDC_FEEDBACK,
-        IDC_DISMISS_INFOBAR_TIMER
+        IDC_DISMISS_INFOBAR_TIMER,
+        IDC_BACKUP_SCHEDULER_TIMER
     };
+
+    friend class BackupVerificationThread;
+    friend class ScheduledBackupThread;
+    friend class StartupDataThread;
 };
 } // namespace app::frm
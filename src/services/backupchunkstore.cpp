@@ -0,0 +1,386 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "backupchunkstore.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include <wx/arrstr.h>
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include "../common/metrics.h"
+#include "../common/sha256.h"
+
+namespace app::svc
+{
+const wxString BackupChunkStore::ManifestFileExtension = wxT("manifest");
+/* 64 pages at the default SQLite page size, small enough that a day of edits touches few chunks */
+const std::size_t BackupChunkStore::ChunkSize = 256 * 1024;
+const std::string BackupChunkStore::ManifestHeader = "taskable-manifest 1";
+/*
+ An unreferenced chunk this young may belong to a backup whose manifest is not written yet: Store reuses
+ an existing chunk (refreshing its modification time) before the manifest naming it exists. A day is far
+ longer than any backup takes, including one run by taskable-cli next to the application.
+ */
+const wxTimeSpan BackupChunkStore::GarbageGracePeriod = wxTimeSpan::Day();
+
+BackupChunkStore::BackupChunkStore(std::shared_ptr<spdlog::logger> logger, const wxString& backupDirectory)
+    : pLogger(logger)
+    , mBackupDirectory(backupDirectory)
+{
+}
+
+bool BackupChunkStore::Store(const wxString& snapshotFilePath, const wxString& manifestFilePath)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    auto snapshot = std::unique_ptr<std::FILE, decltype(&std::fclose)>(
+        std::fopen(snapshotFilePath.ToStdString().c_str(), "rb"), std::fclose);
+    if (!snapshot) {
+        pLogger->error("Failed to open {0} for an incremental backup", snapshotFilePath.ToStdString());
+        return false;
+    }
+
+    if (!wxFileName::DirExists(GetChunksDirectory()) &&
+        !wxFileName::Mkdir(GetChunksDirectory(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+        pLogger->error("Failed to create chunk directory {0}", GetChunksDirectory().ToStdString());
+        return false;
+    }
+
+    BackupManifest manifest{ ChunkSize, 0, "", {} };
+    common::Sha256 fileHash;
+    std::vector<char> chunk(ChunkSize);
+    std::size_t newChunks = 0;
+    std::uint64_t bytesWritten = 0;
+    std::size_t read = 0;
+    while ((read = std::fread(chunk.data(), 1, chunk.size(), snapshot.get())) > 0) {
+        fileHash.Update(chunk.data(), read);
+        manifest.FileSize += read;
+
+        auto chunkHash = common::Sha256::Hash(chunk.data(), read);
+        wxFileName chunkFileName(GetChunkFilePath(chunkHash));
+        if (!chunkFileName.FileExists()) {
+            if (!WriteChunk(chunkHash, chunk, read)) {
+                return false;
+            }
+            newChunks++;
+            bytesWritten += read;
+        } else if (!chunkFileName.Touch()) {
+            /* garbage collection relies on the modification time to leave a reused chunk alone */
+            pLogger->error("Failed to update the modification time of chunk {0}", chunkHash);
+            return false;
+        }
+        manifest.ChunkHashes.push_back(chunkHash);
+    }
+
+    if (std::ferror(snapshot.get())) {
+        pLogger->error("Error occured when reading {0}", snapshotFilePath.ToStdString());
+        return false;
+    }
+    manifest.FileHash = fileHash.HexDigest();
+
+    common::MetricsRegistry::Get().GetCounter(common::MetricNames::BackupChunksWritten).Increment(newChunks);
+    common::MetricsRegistry::Get()
+        .GetCounter(common::MetricNames::BackupChunksReused)
+        .Increment(manifest.ChunkHashes.size() - newChunks);
+
+    /* the manifest is written last so it never references a chunk that is not stored yet */
+    if (!WriteManifest(manifestFilePath, manifest)) {
+        return false;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Incremental backup {0} : {1:d} chunks, {2:d} new ({3:d} of {4:d} bytes written), {5:d}ms",
+        manifestFilePath.ToStdString(),
+        manifest.ChunkHashes.size(),
+        newChunks,
+        bytesWritten,
+        manifest.FileSize,
+        elapsed.count());
+    return true;
+}
+
+bool BackupChunkStore::Restore(const wxString& manifestFilePath,
+    const wxString& destinationFilePath,
+    const std::function<bool()>& cancelCallback)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    BackupManifest manifest;
+    if (!ReadManifest(manifestFilePath, manifest)) {
+        return false;
+    }
+
+    auto destination = std::unique_ptr<std::FILE, decltype(&std::fclose)>(
+        std::fopen(destinationFilePath.ToStdString().c_str(), "wb"), std::fclose);
+    if (!destination) {
+        pLogger->error("Failed to create {0} for restore", destinationFilePath.ToStdString());
+        return false;
+    }
+
+    common::Sha256 fileHash;
+    std::vector<char> chunk(manifest.ChunkSize);
+    bool success = true;
+    for (const auto& chunkHash : manifest.ChunkHashes) {
+        auto chunkFilePath = GetChunkFilePath(chunkHash);
+        auto chunkFile = std::unique_ptr<std::FILE, decltype(&std::fclose)>(
+            std::fopen(chunkFilePath.ToStdString().c_str(), "rb"), std::fclose);
+        if (!chunkFile) {
+            pLogger->error("Missing chunk {0} referenced by {1}", chunkHash, manifestFilePath.ToStdString());
+            success = false;
+            break;
+        }
+
+        std::size_t read = std::fread(chunk.data(), 1, chunk.size(), chunkFile.get());
+        if (common::Sha256::Hash(chunk.data(), read) != chunkHash) {
+            pLogger->error("Chunk {0} referenced by {1} is corrupt", chunkHash, manifestFilePath.ToStdString());
+            success = false;
+            break;
+        }
+
+        fileHash.Update(chunk.data(), read);
+        if (std::fwrite(chunk.data(), 1, read, destination.get()) != read) {
+            pLogger->error("Error occured when writing {0}", destinationFilePath.ToStdString());
+            success = false;
+            break;
+        }
+
+        if (cancelCallback != nullptr && cancelCallback()) {
+            pLogger->info("Restore of {0} cancelled", manifestFilePath.ToStdString());
+            success = false;
+            break;
+        }
+    }
+
+    if (std::fclose(destination.release()) != 0) {
+        success = false;
+    }
+
+    if (success && fileHash.HexDigest() != manifest.FileHash) {
+        pLogger->error("Restored file {0} does not match the hash in {1}",
+            destinationFilePath.ToStdString(),
+            manifestFilePath.ToStdString());
+        success = false;
+    }
+
+    if (!success) {
+        wxRemoveFile(destinationFilePath);
+        return false;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Restored {0} ({1:d} chunks, {2:d} bytes) to {3}, {4:d}ms",
+        manifestFilePath.ToStdString(),
+        manifest.ChunkHashes.size(),
+        manifest.FileSize,
+        destinationFilePath.ToStdString(),
+        elapsed.count());
+    return true;
+}
+
+bool BackupChunkStore::CollectGarbage()
+{
+    if (!wxFileName::DirExists(GetChunksDirectory())) {
+        return true;
+    }
+
+    /* taken before the manifests are read, anything touched by a backup running meanwhile is newer */
+    wxDateTime collectionStart = wxDateTime::Now();
+
+    /* every chunk referenced by a remaining manifest is kept */
+    wxArrayString manifestFiles;
+    wxDir::GetAllFiles(
+        mBackupDirectory, &manifestFiles, wxString::Format(wxT("*.%s"), ManifestFileExtension), wxDIR_FILES);
+
+    std::set<std::string> referencedChunks;
+    for (const auto& manifestFile : manifestFiles) {
+        BackupManifest manifest;
+        if (!ReadManifest(manifestFile, manifest)) {
+            /* an unreadable manifest could reference anything, deleting chunks now could lose data */
+            pLogger->warn("Skipping chunk garbage collection, {0} could not be read", manifestFile.ToStdString());
+            return false;
+        }
+        referencedChunks.insert(manifest.ChunkHashes.begin(), manifest.ChunkHashes.end());
+    }
+
+    wxArrayString chunkFiles;
+    wxDir::GetAllFiles(GetChunksDirectory(), &chunkFiles, wxEmptyString, wxDIR_FILES | wxDIR_DIRS);
+
+    std::size_t removedChunks = 0;
+    std::size_t recentChunks = 0;
+    for (const auto& chunkFile : chunkFiles) {
+        wxFileName chunkFileName(chunkFile);
+        if (referencedChunks.find(chunkFileName.GetFullName().ToStdString()) != referencedChunks.end()) {
+            continue;
+        }
+
+        /* also covers the temporary file of a chunk still being written */
+        wxDateTime modificationTime = chunkFileName.GetModificationTime();
+        if (!modificationTime.IsValid() || modificationTime > collectionStart - GarbageGracePeriod) {
+            recentChunks++;
+            continue;
+        }
+
+        if (!wxRemoveFile(chunkFile)) {
+            pLogger->error("Failed to remove chunk {0}", chunkFile.ToStdString());
+            return false;
+        }
+        removedChunks++;
+    }
+
+    pLogger->info("Removed {0:d} unreferenced chunks, kept {1:d} recent ones, {2:d} chunks in use by {3:d} manifests",
+        removedChunks,
+        recentChunks,
+        referencedChunks.size(),
+        manifestFiles.size());
+    return true;
+}
+
+bool BackupChunkStore::ReadManifest(const wxString& manifestFilePath, BackupManifest& manifest)
+{
+    std::ifstream manifestFile(manifestFilePath.ToStdString());
+    if (!manifestFile) {
+        pLogger->error("Failed to open manifest {0}", manifestFilePath.ToStdString());
+        return false;
+    }
+
+    std::string header;
+    std::string key;
+    std::getline(manifestFile, header);
+    manifest.ChunkHashes.clear();
+    if (header != ManifestHeader || !(manifestFile >> key >> manifest.ChunkSize) || key != "chunk-size" ||
+        !(manifestFile >> key >> manifest.FileSize) || key != "size" ||
+        !(manifestFile >> key >> manifest.FileHash) || key != "sha256" || manifest.ChunkSize == 0) {
+        pLogger->error("Manifest {0} is not valid", manifestFilePath.ToStdString());
+        return false;
+    }
+
+    std::string chunkHash;
+    while (manifestFile >> chunkHash) {
+        manifest.ChunkHashes.push_back(chunkHash);
+    }
+
+    /* a truncated manifest would silently restore a shorter database */
+    auto expectedChunks = (manifest.FileSize + manifest.ChunkSize - 1) / manifest.ChunkSize;
+    if (manifest.ChunkHashes.size() != expectedChunks) {
+        pLogger->error("Manifest {0} lists {1:d} chunks, expected {2:d}",
+            manifestFilePath.ToStdString(),
+            manifest.ChunkHashes.size(),
+            expectedChunks);
+        return false;
+    }
+
+    return true;
+}
+
+bool BackupChunkStore::IsManifest(const wxString& fileName)
+{
+    return wxFileName(fileName).GetExt().IsSameAs(ManifestFileExtension, false);
+}
+
+wxString BackupChunkStore::GetManifestFileName(const wxString& fileName)
+{
+    return wxString::Format(wxT("%s.%s"), fileName, ManifestFileExtension);
+}
+
+wxString BackupChunkStore::GetRestoredFileName(const wxString& fileName)
+{
+    if (!IsManifest(fileName)) {
+        return fileName;
+    }
+    return fileName.substr(0, fileName.length() - ManifestFileExtension.length() - 1);
+}
+
+wxString BackupChunkStore::GetChunksDirectory() const
+{
+    return wxFileName(mBackupDirectory, wxT("chunks")).GetFullPath();
+}
+
+/* chunks are spread over 256 directories by the first two hex digits of their hash */
+wxString BackupChunkStore::GetChunkFilePath(const std::string& chunkHash) const
+{
+    wxFileName chunkFileName(GetChunksDirectory(), chunkHash);
+    chunkFileName.AppendDir(chunkHash.substr(0, 2));
+    return chunkFileName.GetFullPath();
+}
+
+bool BackupChunkStore::WriteChunk(const std::string& chunkHash, const std::vector<char>& chunk, std::size_t length)
+{
+    auto chunkFilePath = GetChunkFilePath(chunkHash);
+    auto chunkDirectory = wxFileName(chunkFilePath).GetPath();
+    if (!wxFileName::DirExists(chunkDirectory) &&
+        !wxFileName::Mkdir(chunkDirectory, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+        pLogger->error("Failed to create chunk directory {0}", chunkDirectory.ToStdString());
+        return false;
+    }
+
+    /* written under a temporary name so an interrupted backup never leaves a truncated chunk */
+    auto temporaryFilePath = wxString::Format(wxT("%s.tmp"), chunkFilePath);
+    {
+        auto chunkFile = std::unique_ptr<std::FILE, decltype(&std::fclose)>(
+            std::fopen(temporaryFilePath.ToStdString().c_str(), "wb"), std::fclose);
+        if (!chunkFile || std::fwrite(chunk.data(), 1, length, chunkFile.get()) != length ||
+            std::fclose(chunkFile.release()) != 0) {
+            pLogger->error("Failed to write chunk {0}", chunkFilePath.ToStdString());
+            wxRemoveFile(temporaryFilePath);
+            return false;
+        }
+    }
+
+    if (!wxRenameFile(temporaryFilePath, chunkFilePath)) {
+        pLogger->error("Failed to rename {0} to {1}", temporaryFilePath.ToStdString(), chunkFilePath.ToStdString());
+        wxRemoveFile(temporaryFilePath);
+        return false;
+    }
+    return true;
+}
+
+bool BackupChunkStore::WriteManifest(const wxString& manifestFilePath, const BackupManifest& manifest)
+{
+    auto temporaryFilePath = wxString::Format(wxT("%s.tmp"), manifestFilePath);
+    {
+        std::ofstream manifestFile(temporaryFilePath.ToStdString(), std::ios_base::out | std::ios_base::trunc);
+        manifestFile << ManifestHeader << "\n"
+                     << "chunk-size " << manifest.ChunkSize << "\n"
+                     << "size " << manifest.FileSize << "\n"
+                     << "sha256 " << manifest.FileHash << "\n";
+        for (const auto& chunkHash : manifest.ChunkHashes) {
+            manifestFile << chunkHash << "\n";
+        }
+
+        manifestFile.close();
+        if (!manifestFile) {
+            pLogger->error("Failed to write manifest {0}", manifestFilePath.ToStdString());
+            wxRemoveFile(temporaryFilePath);
+            return false;
+        }
+    }
+
+    if (!wxRenameFile(temporaryFilePath, manifestFilePath)) {
+        pLogger->error("Failed to rename {0} to {1}", temporaryFilePath.ToStdString(), manifestFilePath.ToStdString());
+        wxRemoveFile(temporaryFilePath);
+        return false;
+    }
+    return true;
+}
+} // namespace app::svc
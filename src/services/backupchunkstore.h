@@ -0,0 +1,87 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+#include <wx/datetime.h>
+#include <wx/string.h>
+
+namespace app::svc
+{
+struct BackupManifest {
+    std::uint64_t ChunkSize;
+    std::uint64_t FileSize;
+    std::string FileHash;
+    std::vector<std::string> ChunkHashes;
+};
+
+/*
+ Incremental backups: a database snapshot is split into fixed size chunks which are stored once,
+ named by their SHA-256, under "chunks" in the backup directory. Each backup only writes a small
+ manifest (<name>.<date>.db.manifest) listing its chunks in order, so unchanged parts of the
+ database are shared between all backups that contain them.
+
+ Store and CollectGarbage may run at the same time, from different threads or processes. Store refreshes
+ the modification time of each chunk it reuses, and garbage collection never removes a chunk modified
+ shortly before it started, so a chunk cannot vanish before the manifest that references it is written.
+ */
+class BackupChunkStore final
+{
+public:
+    BackupChunkStore() = delete;
+    BackupChunkStore(std::shared_ptr<spdlog::logger> logger, const wxString& backupDirectory);
+    ~BackupChunkStore() = default;
+
+    bool Store(const wxString& snapshotFilePath, const wxString& manifestFilePath);
+    /* cancelCallback is polled after every chunk, a cancelled restore removes the partial file */
+    bool Restore(const wxString& manifestFilePath,
+        const wxString& destinationFilePath,
+        const std::function<bool()>& cancelCallback = nullptr);
+    bool CollectGarbage();
+
+    bool ReadManifest(const wxString& manifestFilePath, BackupManifest& manifest);
+    wxString GetChunkFilePath(const std::string& chunkHash) const;
+
+    static bool IsManifest(const wxString& fileName);
+    static wxString GetManifestFileName(const wxString& fileName);
+    static wxString GetRestoredFileName(const wxString& fileName);
+
+    static const wxString ManifestFileExtension;
+
+private:
+    wxString GetChunksDirectory() const;
+    bool WriteChunk(const std::string& chunkHash, const std::vector<char>& chunk, std::size_t length);
+    bool WriteManifest(const wxString& manifestFilePath, const BackupManifest& manifest);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    wxString mBackupDirectory;
+
+    static const std::size_t ChunkSize;
+    static const std::string ManifestHeader;
+    static const wxTimeSpan GarbageGracePeriod;
+};
+} // namespace app::svc
@@ -0,0 +1,189 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "backupcompressor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <zlib.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+namespace app::svc
+{
+const wxString BackupCompressor::CompressedFileExtension = wxT("gz");
+const int BackupCompressor::CompressionLevel = Z_BEST_SPEED;
+const std::size_t BackupCompressor::BufferSize = 256 * 1024;
+
+BackupCompressor::BackupCompressor(std::shared_ptr<spdlog::logger> logger)
+    : pLogger(logger)
+{
+}
+
+bool BackupCompressor::Compress(const wxString& sourceFilePath, const wxString& compressedFilePath)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    auto source = std::unique_ptr<std::FILE, decltype(&std::fclose)>(
+        std::fopen(sourceFilePath.ToStdString().c_str(), "rb"), std::fclose);
+    if (!source) {
+        pLogger->error("Failed to open {0} for compression", sourceFilePath.ToStdString());
+        return false;
+    }
+
+    auto mode = wxString::Format(wxT("wb%d"), CompressionLevel);
+    gzFile compressed = gzopen(compressedFilePath.ToStdString().c_str(), mode.ToStdString().c_str());
+    if (compressed == nullptr) {
+        pLogger->error("Failed to create compressed file {0}", compressedFilePath.ToStdString());
+        return false;
+    }
+    gzbuffer(compressed, static_cast<unsigned int>(BufferSize));
+
+    std::vector<char> buffer(BufferSize);
+    bool success = true;
+    std::size_t read = 0;
+    while ((read = std::fread(buffer.data(), 1, buffer.size(), source.get())) > 0) {
+        if (gzwrite(compressed, buffer.data(), static_cast<unsigned int>(read)) != static_cast<int>(read)) {
+            int errorCode = 0;
+            const char* errorMessage = gzerror(compressed, &errorCode);
+            pLogger->error("Error occured when compressing {0} - {1:d} : {2}",
+                sourceFilePath.ToStdString(),
+                errorCode,
+                errorMessage);
+            success = false;
+            break;
+        }
+    }
+
+    if (std::ferror(source.get())) {
+        pLogger->error("Error occured when reading {0}", sourceFilePath.ToStdString());
+        success = false;
+    }
+
+    if (gzclose(compressed) != Z_OK) {
+        pLogger->error("Failed to finish compressed file {0}", compressedFilePath.ToStdString());
+        success = false;
+    }
+
+    if (!success) {
+        wxRemoveFile(compressedFilePath);
+        return false;
+    }
+
+    auto sourceSize = wxFileName::GetSize(sourceFilePath).GetValue();
+    auto compressedSize = wxFileName::GetSize(compressedFilePath).GetValue();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Compressed {0} ({1:d} bytes) to {2} ({3:d} bytes), ratio {4:.2f}, {5:d}ms",
+        sourceFilePath.ToStdString(),
+        sourceSize,
+        compressedFilePath.ToStdString(),
+        compressedSize,
+        compressedSize > 0 ? static_cast<double>(sourceSize) / static_cast<double>(compressedSize) : 0.0,
+        elapsed.count());
+    return true;
+}
+
+bool BackupCompressor::Decompress(const wxString& compressedFilePath,
+    const wxString& destinationFilePath,
+    const std::function<bool()>& cancelCallback)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    gzFile compressed = gzopen(compressedFilePath.ToStdString().c_str(), "rb");
+    if (compressed == nullptr) {
+        pLogger->error("Failed to open compressed file {0}", compressedFilePath.ToStdString());
+        return false;
+    }
+    gzbuffer(compressed, static_cast<unsigned int>(BufferSize));
+
+    auto destination = std::unique_ptr<std::FILE, decltype(&std::fclose)>(
+        std::fopen(destinationFilePath.ToStdString().c_str(), "wb"), std::fclose);
+    if (!destination) {
+        gzclose(compressed);
+        pLogger->error("Failed to create {0} for decompression", destinationFilePath.ToStdString());
+        return false;
+    }
+
+    std::vector<char> buffer(BufferSize);
+    bool success = true;
+    int read = 0;
+    while ((read = gzread(compressed, buffer.data(), static_cast<unsigned int>(buffer.size()))) > 0) {
+        if (std::fwrite(buffer.data(), 1, static_cast<std::size_t>(read), destination.get()) !=
+            static_cast<std::size_t>(read)) {
+            pLogger->error("Error occured when writing {0}", destinationFilePath.ToStdString());
+            success = false;
+            break;
+        }
+
+        if (cancelCallback != nullptr && cancelCallback()) {
+            pLogger->info("Decompression of {0} cancelled", compressedFilePath.ToStdString());
+            success = false;
+            break;
+        }
+    }
+
+    if (read < 0) {
+        int errorCode = 0;
+        const char* errorMessage = gzerror(compressed, &errorCode);
+        pLogger->error("Error occured when decompressing {0} - {1:d} : {2}",
+            compressedFilePath.ToStdString(),
+            errorCode,
+            errorMessage);
+        success = false;
+    }
+
+    gzclose(compressed);
+    if (std::fclose(destination.release()) != 0) {
+        success = false;
+    }
+
+    if (!success) {
+        wxRemoveFile(destinationFilePath);
+        return false;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Decompressed {0} to {1} ({2:d} bytes), {3:d}ms",
+        compressedFilePath.ToStdString(),
+        destinationFilePath.ToStdString(),
+        wxFileName::GetSize(destinationFilePath).GetValue(),
+        elapsed.count());
+    return true;
+}
+
+bool BackupCompressor::IsCompressedBackup(const wxString& fileName)
+{
+    return wxFileName(fileName).GetExt().IsSameAs(CompressedFileExtension, false);
+}
+
+wxString BackupCompressor::GetCompressedFileName(const wxString& fileName)
+{
+    return wxString::Format(wxT("%s.%s"), fileName, CompressedFileExtension);
+}
+
+wxString BackupCompressor::GetDecompressedFileName(const wxString& fileName)
+{
+    if (!IsCompressedBackup(fileName)) {
+        return fileName;
+    }
+    return fileName.substr(0, fileName.length() - CompressedFileExtension.length() - 1);
+}
+} // namespace app::svc
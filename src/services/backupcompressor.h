@@ -0,0 +1,59 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <spdlog/spdlog.h>
+#include <wx/string.h>
+
+namespace app::svc
+{
+/*
+ Streams database backups through zlib in the gzip format so compressed backups can also be
+ opened with any gzip tool. Neither direction holds more than one buffer of the file in memory.
+ */
+class BackupCompressor final
+{
+public:
+    BackupCompressor() = delete;
+    explicit BackupCompressor(std::shared_ptr<spdlog::logger> logger);
+    ~BackupCompressor() = default;
+
+    bool Compress(const wxString& sourceFilePath, const wxString& compressedFilePath);
+    /* cancelCallback is polled after every buffer, a cancelled decompression removes the partial file */
+    bool Decompress(const wxString& compressedFilePath,
+        const wxString& destinationFilePath,
+        const std::function<bool()>& cancelCallback = nullptr);
+
+    static bool IsCompressedBackup(const wxString& fileName);
+    static wxString GetCompressedFileName(const wxString& fileName);
+    static wxString GetDecompressedFileName(const wxString& fileName);
+
+    static const wxString CompressedFileExtension;
+
+private:
+    std::shared_ptr<spdlog::logger> pLogger;
+
+    static const int CompressionLevel;
+    static const std::size_t BufferSize;
+};
+} // namespace app::svc
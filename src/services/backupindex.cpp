@@ -0,0 +1,407 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "backupindex.h"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+
+#include <nlohmann/json.hpp>
+#include <wx/datetime.h>
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/regex.h>
+#include <zlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include "../common/sha256.h"
+#include "backupchunkstore.h"
+#include "backupcompressor.h"
+
+using json = nlohmann::ordered_json;
+
+namespace app::svc
+{
+namespace
+{
+/* backups are created and verified on worker threads while retention runs on the main thread */
+std::mutex IndexMutex;
+
+/*
+ Exclusive lock on a file next to the index, held from reading the index until it is saved. The running
+ application and taskable-cli prune-backups both update the index and IndexMutex only covers one process.
+ The operating system releases the lock when a process dies, so a stale lock file never blocks anyone.
+ */
+class IndexFileLock final
+{
+public:
+    IndexFileLock(std::shared_ptr<spdlog::logger> logger, const wxString& lockFilePath);
+    ~IndexFileLock();
+
+    IndexFileLock(const IndexFileLock&) = delete;
+    IndexFileLock& operator=(const IndexFileLock&) = delete;
+
+private:
+#ifdef _WIN32
+    HANDLE mHandle;
+#else
+    int mDescriptor;
+#endif // _WIN32
+};
+
+IndexFileLock::IndexFileLock(std::shared_ptr<spdlog::logger> logger, const wxString& lockFilePath)
+#ifdef _WIN32
+    : mHandle(INVALID_HANDLE_VALUE)
+#else
+    : mDescriptor(-1)
+#endif // _WIN32
+{
+    /* nothing to lock before the backup directory exists, there is no index to lose either */
+    if (!wxDirExists(wxFileName(lockFilePath).GetPath())) {
+        return;
+    }
+
+#ifdef _WIN32
+    mHandle = CreateFileW(lockFilePath.wc_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    OVERLAPPED overlapped = {};
+    if (mHandle != INVALID_HANDLE_VALUE && !LockFileEx(mHandle, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped)) {
+        CloseHandle(mHandle);
+        mHandle = INVALID_HANDLE_VALUE;
+    }
+    bool locked = mHandle != INVALID_HANDLE_VALUE;
+#else
+    mDescriptor = open(lockFilePath.ToStdString().c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    int result = -1;
+    while (mDescriptor != -1 && (result = flock(mDescriptor, LOCK_EX)) == -1 && errno == EINTR) {
+    }
+    if (mDescriptor != -1 && result == -1) {
+        close(mDescriptor);
+        mDescriptor = -1;
+    }
+    bool locked = mDescriptor != -1;
+#endif // _WIN32
+
+    if (!locked) {
+        logger->warn("Failed to lock {0}, the backup index is updated without it", lockFilePath.ToStdString());
+    }
+}
+
+IndexFileLock::~IndexFileLock()
+{
+#ifdef _WIN32
+    if (mHandle != INVALID_HANDLE_VALUE) {
+        OVERLAPPED overlapped = {};
+        UnlockFileEx(mHandle, 0, 1, 0, &overlapped);
+        CloseHandle(mHandle);
+    }
+#else
+    if (mDescriptor != -1) {
+        flock(mDescriptor, LOCK_UN);
+        close(mDescriptor);
+    }
+#endif // _WIN32
+}
+} // namespace
+
+const wxString BackupIndex::IndexFileName = wxT("backups.json");
+const wxString BackupIndex::LockFileName = wxT("backups.json.lock");
+const int BackupIndex::IndexVersion = 1;
+
+BackupIndex::BackupIndex(std::shared_ptr<spdlog::logger> logger, const wxString& backupDirectory)
+    : pLogger(logger)
+    , mBackupDirectory(backupDirectory)
+{
+}
+
+bool BackupIndex::Load()
+{
+    std::lock_guard<std::mutex> lock(IndexMutex);
+    IndexFileLock fileLock(pLogger, GetLockFilePath());
+    if (Read()) {
+        return true;
+    }
+    return Rebuild();
+}
+
+bool BackupIndex::Rebuild()
+{
+    mEntries.clear();
+    if (!wxDirExists(mBackupDirectory)) {
+        return true;
+    }
+
+    wxArrayString files;
+    wxDir::GetAllFiles(mBackupDirectory, &files, wxEmptyString, wxDIR_FILES);
+
+    wxRegEx dateRegex(wxT("([0-9]{4}-[0-9]{2}-[0-9]{2})"));
+    for (const auto& file : files) {
+        wxFileName fileName(file);
+        if (!BackupCompressor::IsCompressedBackup(file) && !BackupChunkStore::IsManifest(file) &&
+            !fileName.GetExt().IsSameAs(wxT("db"), false)) {
+            continue;
+        }
+
+        wxDateTime date;
+        if (!dateRegex.Matches(fileName.GetFullName()) ||
+            !date.ParseDate(dateRegex.GetMatch(fileName.GetFullName(), 0))) {
+            continue;
+        }
+
+        BackupIndexEntry entry{ fileName.GetFullName().ToStdString(),
+            static_cast<std::int64_t>(date.GetTicks()),
+            wxFileName::GetSize(file).GetValue(),
+            ReadBackupSchemaVersion(file),
+            "",
+            { 0, false, false, "", {} } };
+        mEntries.push_back(entry);
+    }
+
+    std::sort(mEntries.begin(), mEntries.end(), [](const BackupIndexEntry& lhs, const BackupIndexEntry& rhs) {
+        return lhs.Timestamp < rhs.Timestamp;
+    });
+
+    pLogger->info("Rebuilt backup index for {0} with {1:d} backups", mBackupDirectory.ToStdString(), mEntries.size());
+    return Save();
+}
+
+bool BackupIndex::Add(const wxString& backupFilePath, int schemaVersion)
+{
+    std::lock_guard<std::mutex> lock(IndexMutex);
+    IndexFileLock fileLock(pLogger, GetLockFilePath());
+    if (!Read() && !Rebuild()) {
+        return false;
+    }
+
+    wxFileName fileName(backupFilePath);
+    BackupIndexEntry entry{ fileName.GetFullName().ToStdString(),
+        static_cast<std::int64_t>(wxDateTime::Now().GetTicks()),
+        wxFileName::GetSize(backupFilePath).GetValue(),
+        schemaVersion,
+        common::Sha256::HashFile(backupFilePath.ToStdString()),
+        { 0, false, false, "", {} } };
+
+    /* a second backup on the same day replaces the file of the first one */
+    mEntries.erase(std::remove_if(mEntries.begin(),
+                       mEntries.end(),
+                       [&](const BackupIndexEntry& existing) { return existing.FileName == entry.FileName; }),
+        mEntries.end());
+    mEntries.push_back(entry);
+
+    return Save();
+}
+
+bool BackupIndex::Remove(const wxArrayString& fileNames)
+{
+    std::lock_guard<std::mutex> lock(IndexMutex);
+    IndexFileLock fileLock(pLogger, GetLockFilePath());
+    if (!Read() && !Rebuild()) {
+        return false;
+    }
+
+    mEntries.erase(std::remove_if(mEntries.begin(),
+                       mEntries.end(),
+                       [&](const BackupIndexEntry& entry) {
+                           return std::find(fileNames.begin(), fileNames.end(), wxString(entry.FileName)) !=
+                                  fileNames.end();
+                       }),
+        mEntries.end());
+
+    return Save();
+}
+
+bool BackupIndex::UpdateVerification(const BackupIndexEntry& entry)
+{
+    std::lock_guard<std::mutex> lock(IndexMutex);
+    IndexFileLock fileLock(pLogger, GetLockFilePath());
+    if (!Read() && !Rebuild()) {
+        return false;
+    }
+
+    auto existing = std::find_if(mEntries.begin(), mEntries.end(), [&](const BackupIndexEntry& candidate) {
+        return candidate.FileName == entry.FileName;
+    });
+    if (existing == mEntries.end()) {
+        return true;
+    }
+
+    /* a second backup on the same day replaced the file, the result belongs to the old one */
+    if (!existing->Checksum.empty() && existing->Checksum != entry.Checksum) {
+        return true;
+    }
+
+    /* the rest of the entry is left as Add wrote it, the verifier's copy may be older */
+    existing->Checksum = entry.Checksum;
+    existing->Verification = entry.Verification;
+    return Save();
+}
+
+const std::vector<BackupIndexEntry>& BackupIndex::GetEntries() const
+{
+    return mEntries;
+}
+
+int BackupIndex::ReadSchemaVersion(const wxString& databaseFilePath)
+{
+    /* gzread reads files that are not gzip compressed as they are */
+    gzFile file = gzopen(databaseFilePath.ToStdString().c_str(), "rb");
+    if (file == nullptr) {
+        return -1;
+    }
+
+    /* the user_version is stored big endian at offset 60 of the 100 byte database header */
+    unsigned char header[100];
+    int read = gzread(file, header, sizeof(header));
+    gzclose(file);
+    if (read != static_cast<int>(sizeof(header))) {
+        return -1;
+    }
+
+    return static_cast<int>((static_cast<std::uint32_t>(header[60]) << 24) |
+                            (static_cast<std::uint32_t>(header[61]) << 16) |
+                            (static_cast<std::uint32_t>(header[62]) << 8) | static_cast<std::uint32_t>(header[63]));
+}
+
+bool BackupIndex::Read()
+{
+    std::ifstream indexFile(GetIndexFilePath().ToStdString());
+    if (!indexFile) {
+        return false;
+    }
+
+    mEntries.clear();
+    try {
+        auto index = json::parse(indexFile);
+        if (index.at("version").get<int>() != IndexVersion) {
+            pLogger->warn("Backup index {0} has an unknown version", GetIndexFilePath().ToStdString());
+            return false;
+        }
+
+        for (const auto& backup : index.at("backups")) {
+            BackupIndexEntry entry{ backup.at("file").get<std::string>(),
+                backup.at("timestamp").get<std::int64_t>(),
+                backup.at("size").get<std::uint64_t>(),
+                backup.at("schemaVersion").get<int>(),
+                backup.at("checksum").get<std::string>(),
+                { 0, false, false, "", {} } };
+
+            if (backup.contains("verification")) {
+                const auto& verification = backup.at("verification");
+                entry.Verification.VerifiedAt = verification.at("verifiedAt").get<std::int64_t>();
+                entry.Verification.FullCheck = verification.at("fullCheck").get<bool>();
+                entry.Verification.Passed = verification.at("passed").get<bool>();
+                entry.Verification.Message = verification.at("message").get<std::string>();
+                entry.Verification.RowCounts =
+                    verification.at("rowCounts").get<std::map<std::string, std::int64_t>>();
+            }
+            mEntries.push_back(entry);
+        }
+    } catch (const json::exception& e) {
+        pLogger->warn(
+            "Backup index {0} could not be read - {1:d} : {2}", GetIndexFilePath().ToStdString(), e.id, e.what());
+        mEntries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool BackupIndex::Save()
+{
+    json backups = json::array();
+    for (const auto& entry : mEntries) {
+        json backup = { { "file", entry.FileName },
+            { "timestamp", entry.Timestamp },
+            { "size", entry.Size },
+            { "schemaVersion", entry.SchemaVersion },
+            { "checksum", entry.Checksum } };
+
+        if (entry.Verification.VerifiedAt > 0) {
+            backup["verification"] = { { "verifiedAt", entry.Verification.VerifiedAt },
+                { "fullCheck", entry.Verification.FullCheck },
+                { "passed", entry.Verification.Passed },
+                { "message", entry.Verification.Message },
+                { "rowCounts", entry.Verification.RowCounts } };
+        }
+        backups.push_back(backup);
+    }
+    json index = { { "version", IndexVersion }, { "backups", backups } };
+
+    /* replaced with a rename so a crash never leaves a half written index behind */
+    auto temporaryFilePath = wxString::Format(wxT("%s.tmp"), GetIndexFilePath());
+    {
+        std::ofstream indexFile(temporaryFilePath.ToStdString(), std::ios_base::out | std::ios_base::trunc);
+        indexFile << index.dump(4) << "\n";
+        indexFile.close();
+        if (!indexFile) {
+            pLogger->error("Failed to write backup index {0}", temporaryFilePath.ToStdString());
+            wxRemoveFile(temporaryFilePath);
+            return false;
+        }
+    }
+
+    if (!wxRenameFile(temporaryFilePath, GetIndexFilePath())) {
+        pLogger->error(
+            "Failed to rename {0} to {1}", temporaryFilePath.ToStdString(), GetIndexFilePath().ToStdString());
+        wxRemoveFile(temporaryFilePath);
+        return false;
+    }
+    return true;
+}
+
+wxString BackupIndex::GetIndexFilePath() const
+{
+    return wxFileName(mBackupDirectory, IndexFileName).GetFullPath();
+}
+
+wxString BackupIndex::GetLockFilePath() const
+{
+    return wxFileName(mBackupDirectory, LockFileName).GetFullPath();
+}
+
+int BackupIndex::ReadBackupSchemaVersion(const wxString& backupFilePath)
+{
+    if (!BackupChunkStore::IsManifest(backupFilePath)) {
+        return ReadSchemaVersion(backupFilePath);
+    }
+
+    /* the database header of an incremental backup is in its first chunk */
+    BackupChunkStore backupChunkStore(pLogger, mBackupDirectory);
+    BackupManifest manifest;
+    if (!backupChunkStore.ReadManifest(backupFilePath, manifest) || manifest.ChunkHashes.empty()) {
+        return -1;
+    }
+    return ReadSchemaVersion(backupChunkStore.GetChunkFilePath(manifest.ChunkHashes.front()));
+}
+} // namespace app::svc
@@ -0,0 +1,100 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+namespace app::svc
+{
+struct BackupVerification {
+    /* 0 until the backup has been verified */
+    std::int64_t VerifiedAt;
+    /* integrity_check instead of quick_check */
+    bool FullCheck;
+    bool Passed;
+    std::string Message;
+    std::map<std::string, std::int64_t> RowCounts;
+};
+
+struct BackupIndexEntry {
+    std::string FileName;
+    std::int64_t Timestamp;
+    std::uint64_t Size;
+    int SchemaVersion;
+    /* SHA-256 of the stored file, empty for backups only known from a directory scan */
+    std::string Checksum;
+    BackupVerification Verification;
+};
+
+/*
+ Index of the backups in the backup directory, kept in a single JSON file next to them so retention
+ and the restore wizard do not have to list the directory and parse dates out of file names.
+ A missing or unreadable index is rebuilt by scanning the directory once. Every update re-reads the index
+ under an exclusive lock file, so the application and taskable-cli never overwrite each other's changes.
+ */
+class BackupIndex final
+{
+public:
+    BackupIndex() = delete;
+    BackupIndex(std::shared_ptr<spdlog::logger> logger, const wxString& backupDirectory);
+    ~BackupIndex() = default;
+
+    bool Load();
+
+    bool Add(const wxString& backupFilePath, int schemaVersion);
+    bool Remove(const wxArrayString& fileNames);
+    /*
+     stores the verification result (and the checksum of a backup found by a directory scan) of the entry
+     with the same file name, unless the backup has been deleted or replaced since it was verified
+     */
+    bool UpdateVerification(const BackupIndexEntry& entry);
+
+    const std::vector<BackupIndexEntry>& GetEntries() const;
+
+    /* user_version from the database header, -1 if it cannot be read */
+    static int ReadSchemaVersion(const wxString& databaseFilePath);
+
+    static const wxString IndexFileName;
+    /* locked by every read, modify and save of the index, whichever process does it */
+    static const wxString LockFileName;
+
+private:
+    bool Read();
+    bool Rebuild();
+    bool Save();
+    wxString GetIndexFilePath() const;
+    wxString GetLockFilePath() const;
+    int ReadBackupSchemaVersion(const wxString& backupFilePath);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    wxString mBackupDirectory;
+    std::vector<BackupIndexEntry> mEntries;
+
+    static const int IndexVersion;
+};
+} // namespace app::svc
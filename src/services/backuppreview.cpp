@@ -0,0 +1,175 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "backuppreview.h"
+
+#include <map>
+
+#include <sqlite_modern_cpp.h>
+#include <wx/filefn.h>
+
+namespace app::svc
+{
+namespace
+{
+const std::string DailyTotalsQuery = "SELECT tasks.task_date, "
+                                     "SUM(CAST(substr(task_items.duration, 1, 2) AS INTEGER) * 3600 "
+                                     "+ CAST(substr(task_items.duration, 4, 2) AS INTEGER) * 60 "
+                                     "+ CAST(substr(task_items.duration, 7, 2) AS INTEGER)) "
+                                     "FROM task_items "
+                                     "INNER JOIN tasks ON task_items.task_id = tasks.task_id "
+                                     "WHERE task_items.is_active = 1 AND tasks.task_date >= ? "
+                                     "GROUP BY tasks.task_date;";
+
+std::map<std::string, std::int64_t> ReadDailyTotals(sqlite::database& database, const std::string& fromDate)
+{
+    std::map<std::string, std::int64_t> dailyTotals;
+    database << DailyTotalsQuery << fromDate >>
+        [&](std::string date, std::int64_t seconds) { dailyTotals[date] = seconds; };
+    return dailyTotals;
+}
+} // namespace
+
+const int BackupPreviewer::ComparedDays = 90;
+const int BackupPreviewer::TimeBudgetMilliseconds = 750;
+
+BackupPreviewer::BackupPreviewer(std::shared_ptr<spdlog::logger> logger, PreviewCancelCallback cancelCallback)
+    : pLogger(logger)
+    , mCancelCallback(cancelCallback)
+    , mDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(TimeBudgetMilliseconds))
+{
+}
+
+bool BackupPreviewer::Preview(const wxString& backupFilePath, const wxString& databaseFilePath, BackupPreview& preview)
+{
+    auto start = std::chrono::steady_clock::now();
+    preview = { 0, "", "", 0, 0, 0, "", false, 0, {}, false };
+
+    auto config = sqlite::sqlite_config{ sqlite::OpenFlags::READONLY, nullptr, sqlite::Encoding::UTF8 };
+    std::map<std::string, std::int64_t> backupTotals;
+    std::string fromDate;
+    try {
+        sqlite::database backupDatabase(backupFilePath.ToStdString(), config);
+        sqlite3_progress_handler(backupDatabase.connection().get(), 1000, &BackupPreviewer::OnProgress, this);
+
+        backupDatabase << "PRAGMA user_version;" >> preview.SchemaVersion;
+        backupDatabase << "SELECT IFNULL(MIN(task_date), ''), IFNULL(MAX(task_date), '') FROM tasks;" >>
+            [&](std::string first, std::string last) {
+                preview.FirstTaskDate = first;
+                preview.LastTaskDate = last;
+            };
+        backupDatabase << "SELECT COUNT(*) FROM task_items;" >> preview.TaskItemCount;
+        /* backups from before schema version 2 have no meetings table */
+        int meetingsTables = 0;
+        backupDatabase << "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'meetings';" >>
+            meetingsTables;
+        if (meetingsTables > 0) {
+            backupDatabase << "SELECT COUNT(*) FROM meetings;" >> preview.MeetingCount;
+        }
+        backupDatabase << "SELECT date_modified, description FROM task_items "
+                          "ORDER BY date_modified DESC LIMIT 1;" >>
+            [&](std::int64_t dateModified, std::string description) {
+                preview.LastModified = dateModified;
+                preview.LastModifiedDescription = description;
+            };
+
+        if (databaseFilePath.empty() || !wxFileExists(databaseFilePath) || preview.LastTaskDate.empty()) {
+            return true;
+        }
+
+        backupDatabase << "SELECT date(?, ?);" << preview.LastTaskDate
+                       << "-" + std::to_string(ComparedDays - 1) + " days" >>
+            fromDate;
+        backupTotals = ReadDailyTotals(backupDatabase, fromDate);
+    } catch (const sqlite::sqlite_exception& e) {
+        if (e.get_code() == SQLITE_INTERRUPT) {
+            preview.Truncated = true;
+            return true;
+        }
+
+        pLogger->error("Error occured when previewing backup {0} - {1:d} : {2}",
+            backupFilePath.ToStdString(),
+            e.get_code(),
+            e.what());
+        return false;
+    }
+
+    std::map<std::string, std::int64_t> databaseTotals;
+    try {
+        sqlite::database database(databaseFilePath.ToStdString(), config);
+        sqlite3_progress_handler(database.connection().get(), 1000, &BackupPreviewer::OnProgress, this);
+        databaseTotals = ReadDailyTotals(database, fromDate);
+    } catch (const sqlite::sqlite_exception& e) {
+        if (e.get_code() == SQLITE_INTERRUPT) {
+            preview.Truncated = true;
+            return true;
+        }
+
+        pLogger->error("Error occured when comparing backup {0} with {1} - {2:d} : {3}",
+            backupFilePath.ToStdString(),
+            databaseFilePath.ToStdString(),
+            e.get_code(),
+            e.what());
+        return false;
+    }
+
+    /* both maps are ordered by date, so a single merge pass finds every differing day */
+    auto backupDay = backupTotals.begin();
+    auto databaseDay = databaseTotals.begin();
+    while (backupDay != backupTotals.end() || databaseDay != databaseTotals.end()) {
+        if (databaseDay == databaseTotals.end() ||
+            (backupDay != backupTotals.end() && backupDay->first < databaseDay->first)) {
+            preview.DifferingDays.push_back({ backupDay->first, backupDay->second, -1 });
+            ++backupDay;
+        } else if (backupDay == backupTotals.end() || databaseDay->first < backupDay->first) {
+            preview.DifferingDays.push_back({ databaseDay->first, -1, databaseDay->second });
+            ++databaseDay;
+        } else {
+            if (backupDay->second != databaseDay->second) {
+                preview.DifferingDays.push_back({ backupDay->first, backupDay->second, databaseDay->second });
+            }
+            ++backupDay;
+            ++databaseDay;
+        }
+    }
+
+    preview.DatabaseCompared = true;
+    preview.ComparedDays = ComparedDays;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Previewed backup {0} : {1:d} differing days in {2:d}ms",
+        backupFilePath.ToStdString(),
+        preview.DifferingDays.size(),
+        elapsed.count());
+    return true;
+}
+
+bool BackupPreviewer::ShouldStop() const
+{
+    if (mCancelCallback != nullptr && mCancelCallback()) {
+        return true;
+    }
+    return std::chrono::steady_clock::now() > mDeadline;
+}
+
+int BackupPreviewer::OnProgress(void* previewer)
+{
+    return static_cast<BackupPreviewer*>(previewer)->ShouldStop() ? 1 : 0;
+}
+} // namespace app::svc
@@ -0,0 +1,93 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+#include <wx/string.h>
+
+namespace app::svc
+{
+struct BackupPreviewDayDifference {
+    std::string Date;
+    /* total task duration on that day, -1 when the day is missing */
+    std::int64_t BackupSeconds;
+    std::int64_t DatabaseSeconds;
+};
+
+struct BackupPreview {
+    int SchemaVersion;
+    std::string FirstTaskDate;
+    std::string LastTaskDate;
+    std::int64_t TaskItemCount;
+    std::int64_t MeetingCount;
+    std::int64_t LastModified;
+    std::string LastModifiedDescription;
+    /* daily totals compared from ComparedDays before the last day in the backup onwards */
+    bool DatabaseCompared;
+    int ComparedDays;
+    std::vector<BackupPreviewDayDifference> DifferingDays;
+    /*
+     the time budget ran out or the preview was cancelled, the comparison with the database was skipped
+     entirely (and when it happened while counting, the summary above is incomplete too)
+     */
+    bool Truncated;
+};
+
+/* polled while SQLite runs the preview queries, return true to stop */
+using PreviewCancelCallback = std::function<bool()>;
+
+/*
+ Summarizes a backup without restoring it, so a version can be picked on content instead of
+ file name. The backup and the live database are opened read-only on separate connections.
+ The per day comparison is limited to the most recent ComparedDays days. Every query, the counts
+ included, is interrupted once TimeBudgetMilliseconds have passed or the cancel callback asks to stop,
+ so a large backup cannot hold up the restore wizard. The budget starts when the previewer is created,
+ extracting a compressed or incremental backup polls ShouldStop and counts against it too.
+ */
+class BackupPreviewer final
+{
+public:
+    BackupPreviewer() = delete;
+    BackupPreviewer(std::shared_ptr<spdlog::logger> logger, PreviewCancelCallback cancelCallback);
+    ~BackupPreviewer() = default;
+
+    /* backupFilePath must be a plain database file, databaseFilePath may not exist */
+    bool Preview(const wxString& backupFilePath, const wxString& databaseFilePath, BackupPreview& preview);
+    /* the time budget ran out or the cancel callback asks to stop */
+    bool ShouldStop() const;
+
+    static const int ComparedDays;
+    static const int TimeBudgetMilliseconds;
+
+private:
+    static int OnProgress(void* previewer);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    PreviewCancelCallback mCancelCallback;
+    std::chrono::steady_clock::time_point mDeadline;
+};
+} // namespace app::svc
@@ -0,0 +1,126 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "backupretention.h"
+
+#include <algorithm>
+#include <array>
+
+#include <wx/datetime.h>
+
+namespace app::svc
+{
+namespace
+{
+enum Tier { Daily = 0, Weekly, Monthly, Yearly, TierCount };
+
+const std::array<std::string, TierCount> TierNames = { "daily", "weekly", "monthly", "yearly" };
+
+/* keys are only compared for equality between neighbouring backups */
+int GetPeriodKey(Tier tier, const wxDateTime& date)
+{
+    switch (tier) {
+    case Daily:
+        return date.GetYear() * 10000 + (static_cast<int>(date.GetMonth()) + 1) * 100 + date.GetDay();
+    case Weekly:
+        return date.GetWeekBasedYear() * 100 + date.GetWeekOfYear();
+    case Monthly:
+        return date.GetYear() * 100 + static_cast<int>(date.GetMonth()) + 1;
+    case Yearly:
+    default:
+        return date.GetYear();
+    }
+}
+} // namespace
+
+bool BackupRetentionPolicy::IsTiered() const
+{
+    return KeepDaily > 0 || KeepWeekly > 0 || KeepMonthly > 0 || KeepYearly > 0;
+}
+
+BackupRetentionPlanner::BackupRetentionPlanner(const BackupRetentionPolicy& policy)
+    : mPolicy(policy)
+{
+}
+
+std::vector<BackupRetentionDecision> BackupRetentionPlanner::Plan(const std::vector<BackupIndexEntry>& entries,
+    std::int64_t now) const
+{
+    std::vector<const BackupIndexEntry*> newestFirst;
+    newestFirst.reserve(entries.size());
+    for (const auto& entry : entries) {
+        newestFirst.push_back(&entry);
+    }
+    std::sort(newestFirst.begin(), newestFirst.end(), [](const BackupIndexEntry* lhs, const BackupIndexEntry* rhs) {
+        return lhs->Timestamp > rhs->Timestamp;
+    });
+
+    const std::array<int, TierCount> keepCounts = {
+        mPolicy.KeepDaily, mPolicy.KeepWeekly, mPolicy.KeepMonthly, mPolicy.KeepYearly
+    };
+    std::array<int, TierCount> keptCounts = { 0, 0, 0, 0 };
+    std::array<int, TierCount> lastPeriods = { -1, -1, -1, -1 };
+
+    const std::int64_t OneDay = 24 * 60 * 60;
+    const std::int64_t cutOff = now - OneDay * mPolicy.DeleteBackupsAfter;
+
+    std::vector<BackupRetentionDecision> decisions;
+    decisions.reserve(newestFirst.size());
+    for (const auto* entry : newestFirst) {
+        BackupRetentionDecision decision{ entry->FileName, false, "" };
+
+        if (!mPolicy.IsTiered()) {
+            decision.Keep = entry->Timestamp >= cutOff;
+            decision.Reason = decision.Keep ? "within " : "older than ";
+            decision.Reason += std::to_string(mPolicy.DeleteBackupsAfter) + " days";
+        } else {
+            /* walking newest to oldest, the first backup seen in a period is the one that period keeps */
+            wxDateTime date(static_cast<time_t>(entry->Timestamp));
+            for (int tier = Daily; tier < TierCount; tier++) {
+                if (keptCounts[tier] >= keepCounts[tier]) {
+                    continue;
+                }
+
+                int period = GetPeriodKey(static_cast<Tier>(tier), date);
+                if (period == lastPeriods[tier]) {
+                    continue;
+                }
+
+                lastPeriods[tier] = period;
+                keptCounts[tier]++;
+                decision.Reason += decision.Keep ? ", " + TierNames[tier] : TierNames[tier];
+                decision.Keep = true;
+            }
+
+            if (!decision.Keep) {
+                decision.Reason = "not needed by any tier";
+            }
+        }
+
+        if (!decision.Keep && decisions.empty()) {
+            decision.Keep = true;
+            decision.Reason = "newest backup";
+        }
+
+        decisions.push_back(decision);
+    }
+
+    return decisions;
+}
+} // namespace app::svc
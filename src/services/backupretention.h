@@ -0,0 +1,65 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "backupindex.h"
+
+namespace app::svc
+{
+struct BackupRetentionPolicy {
+    int DeleteBackupsAfter;
+    int KeepDaily;
+    int KeepWeekly;
+    int KeepMonthly;
+    int KeepYearly;
+
+    /* any grandfather-father-son count replaces the age based DeleteBackupsAfter */
+    bool IsTiered() const;
+};
+
+struct BackupRetentionDecision {
+    std::string FileName;
+    bool Keep;
+    std::string Reason;
+};
+
+/*
+ Decides which backups to keep from the backup index alone. With a tiered policy the newest backup
+ of each of the last KeepDaily days, KeepWeekly weeks, KeepMonthly months and KeepYearly years is
+ kept; the newest backup overall is never deleted.
+ */
+class BackupRetentionPlanner final
+{
+public:
+    BackupRetentionPlanner() = delete;
+    explicit BackupRetentionPlanner(const BackupRetentionPolicy& policy);
+    ~BackupRetentionPlanner() = default;
+
+    /* one decision per entry, newest first */
+    std::vector<BackupRetentionDecision> Plan(const std::vector<BackupIndexEntry>& entries, std::int64_t now) const;
+
+private:
+    BackupRetentionPolicy mPolicy;
+};
+} // namespace app::svc
@@ -0,0 +1,151 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "backupscheduler.h"
+
+#include <algorithm>
+
+#include <wx/datetime.h>
+#include <wx/filename.h>
+
+#include "backupindex.h"
+
+namespace app::svc
+{
+const int BackupScheduler::PollIntervalSeconds = 60;
+
+BackupScheduler::BackupScheduler(std::shared_ptr<spdlog::logger> logger,
+    const wxString& databaseFilePath,
+    const wxString& backupDirectory,
+    int intervalMinutes,
+    int idleDelayMinutes)
+    : pLogger(logger)
+    , pDatabase(nullptr)
+    , mInterval(intervalMinutes)
+    , mIdleDelay(idleDelayMinutes)
+    , mLastBackupTime(std::chrono::steady_clock::now())
+    , mLastChangeTime(std::chrono::steady_clock::now())
+    , mDataVersion(-1)
+    , mBackedUpDataVersion(-1)
+    , mPendingDataVersion(-1)
+    , bHasBackup(false)
+{
+    try {
+        auto config = sqlite::sqlite_config{ sqlite::OpenFlags::READONLY, nullptr, sqlite::Encoding::UTF8 };
+        pDatabase = std::make_unique<sqlite::database>(databaseFilePath.ToStdString(), config);
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured when opening {0} for backup scheduling - {1:d} : {2}",
+            databaseFilePath.ToStdString(),
+            e.get_code(),
+            e.what());
+        return;
+    }
+
+    PollDataVersion();
+    if (IsStartupDataBackedUp(databaseFilePath, backupDirectory)) {
+        mBackedUpDataVersion = mDataVersion;
+    } else {
+        pLogger->info("No backup newer than the last change to {0}, a scheduled backup is due",
+            databaseFilePath.ToStdString());
+    }
+}
+
+bool BackupScheduler::IsBackupDue()
+{
+    if (!PollDataVersion() || mDataVersion == mBackedUpDataVersion || mPendingDataVersion != -1) {
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    bool intervalElapsed = mInterval.count() > 0 && now - mLastBackupTime >= mInterval;
+    bool idle = mIdleDelay.count() > 0 && now - mLastChangeTime >= mIdleDelay;
+    return intervalElapsed || idle;
+}
+
+bool BackupScheduler::IsUpToDate()
+{
+    return PollDataVersion() && bHasBackup && mDataVersion == mBackedUpDataVersion;
+}
+
+void BackupScheduler::BackupStarted()
+{
+    /* commits made while the backup runs bump the version again and are picked up by the next one */
+    mPendingDataVersion = mDataVersion;
+}
+
+void BackupScheduler::BackupFinished(bool success)
+{
+    if (success && mPendingDataVersion != -1) {
+        mBackedUpDataVersion = mPendingDataVersion;
+        mLastBackupTime = std::chrono::steady_clock::now();
+        bHasBackup = true;
+    }
+    mPendingDataVersion = -1;
+}
+
+void BackupScheduler::Reconfigure(int intervalMinutes, int idleDelayMinutes)
+{
+    mInterval = std::chrono::minutes(intervalMinutes);
+    mIdleDelay = std::chrono::minutes(idleDelayMinutes);
+}
+
+bool BackupScheduler::IsStartupDataBackedUp(const wxString& databaseFilePath, const wxString& backupDirectory)
+{
+    BackupIndex backupIndex(pLogger, backupDirectory);
+    if (!backupIndex.Load() || backupIndex.GetEntries().empty()) {
+        return false;
+    }
+
+    const auto& entries = backupIndex.GetEntries();
+    auto newestBackup = std::max_element(
+        entries.begin(), entries.end(), [](const BackupIndexEntry& lhs, const BackupIndexEntry& rhs) {
+            return lhs.Timestamp < rhs.Timestamp;
+        });
+
+    /* the database is kept in rollback journal mode, every commit updates the file itself */
+    wxDateTime lastModified = wxFileName(databaseFilePath).GetModificationTime();
+    if (!lastModified.IsValid()) {
+        return false;
+    }
+
+    /* strictly newer, both are in whole seconds */
+    return newestBackup->Timestamp > static_cast<std::int64_t>(lastModified.GetTicks());
+}
+
+bool BackupScheduler::PollDataVersion()
+{
+    if (!pDatabase) {
+        return false;
+    }
+
+    std::int64_t dataVersion = 0;
+    try {
+        *pDatabase << "PRAGMA data_version;" >> dataVersion;
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured when reading the database data version - {0:d} : {1}", e.get_code(), e.what());
+        return false;
+    }
+
+    if (dataVersion != mDataVersion) {
+        mDataVersion = dataVersion;
+        mLastChangeTime = std::chrono::steady_clock::now();
+    }
+    return true;
+}
+} // namespace app::svc
@@ -0,0 +1,81 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <spdlog/spdlog.h>
+#include <sqlite_modern_cpp.h>
+#include <wx/string.h>
+
+namespace app::svc
+{
+/*
+ Decides when a backup should run during the session. Changes are detected through
+ PRAGMA data_version on a dedicated read-only connection, which increments whenever any other
+ connection commits, so an unchanged database is never backed up twice. A backup is due once
+ there are changes and either the interval has passed since the last backup or the database
+ has been idle (no new commits) for the idle delay. Not thread safe, poll it from one thread.
+
+ The data present at startup only counts as backed up when the newest backup in the index was taken
+ after the database file was last written. After a crash the previous session never took its exit
+ backup, so the first scheduled backup becomes due as usual.
+ */
+class BackupScheduler final
+{
+public:
+    BackupScheduler() = delete;
+    BackupScheduler(std::shared_ptr<spdlog::logger> logger,
+        const wxString& databaseFilePath,
+        const wxString& backupDirectory,
+        int intervalMinutes,
+        int idleDelayMinutes);
+    ~BackupScheduler() = default;
+
+    bool IsBackupDue();
+    /* true when a backup of the current data was already taken during this session */
+    bool IsUpToDate();
+
+    void BackupStarted();
+    void BackupFinished(bool success);
+
+    /* changes the schedule only, what was already backed up and a backup in progress are kept */
+    void Reconfigure(int intervalMinutes, int idleDelayMinutes);
+
+    static const int PollIntervalSeconds;
+
+private:
+    bool PollDataVersion();
+    bool IsStartupDataBackedUp(const wxString& databaseFilePath, const wxString& backupDirectory);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::unique_ptr<sqlite::database> pDatabase;
+    std::chrono::minutes mInterval;
+    std::chrono::minutes mIdleDelay;
+    std::chrono::steady_clock::time_point mLastBackupTime;
+    std::chrono::steady_clock::time_point mLastChangeTime;
+    std::int64_t mDataVersion;
+    std::int64_t mBackedUpDataVersion;
+    std::int64_t mPendingDataVersion;
+    bool bHasBackup;
+};
+} // namespace app::svc
@@ -0,0 +1,274 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "backupverifier.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <sqlite_modern_cpp.h>
+#include <wx/datetime.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include "../common/sha256.h"
+#include "backupchunkstore.h"
+#include "backupcompressor.h"
+
+namespace app::svc
+{
+const int BackupVerifier::FullCheckIntervalDays = 7;
+const std::vector<std::string> BackupVerifier::RequiredTables = { "employers", "projects", "categories", "task_items" };
+
+BackupVerifier::BackupVerifier(std::shared_ptr<spdlog::logger> logger,
+    const wxString& backupDirectory,
+    const wxString& databaseFilePath,
+    VerificationCancelCallback cancelCallback)
+    : pLogger(logger)
+    , mBackupDirectory(backupDirectory)
+    , mDatabaseFilePath(databaseFilePath)
+    , mCancelCallback(cancelCallback)
+    , mFailures()
+    , bCancelled(false)
+{
+}
+
+bool BackupVerifier::Execute()
+{
+    auto start = std::chrono::steady_clock::now();
+    mFailures.clear();
+
+    BackupIndex backupIndex(pLogger, mBackupDirectory);
+    if (!backupIndex.Load()) {
+        return false;
+    }
+
+    std::vector<BackupIndexEntry> entries = backupIndex.GetEntries();
+    std::sort(entries.begin(), entries.end(), [](const BackupIndexEntry& lhs, const BackupIndexEntry& rhs) {
+        return lhs.Timestamp < rhs.Timestamp;
+    });
+
+    /* the full check is due once no backup has had one within the interval */
+    const std::int64_t OneDay = 24 * 60 * 60;
+    auto now = static_cast<std::int64_t>(wxDateTime::Now().GetTicks());
+    bool fullCheckDue = std::none_of(entries.begin(), entries.end(), [&](const BackupIndexEntry& entry) {
+        return entry.Verification.FullCheck && entry.Verification.VerifiedAt > now - OneDay * FullCheckIntervalDays;
+    });
+
+    std::size_t verifiedBackups = 0;
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        auto& entry = entries[i];
+        bool newest = i + 1 == entries.size();
+        if (entry.Verification.VerifiedAt > 0 && !(newest && fullCheckDue)) {
+            continue;
+        }
+
+        if (OnProgress(this) != 0) {
+            return true;
+        }
+
+        VerifyBackup(entry, i > 0 ? &entries[i - 1] : nullptr, newest && fullCheckDue);
+        if (IsCancelled()) {
+            return true;
+        }
+
+        if (!backupIndex.UpdateVerification(entry)) {
+            return false;
+        }
+        verifiedBackups++;
+    }
+
+    BackupVerification databaseVerification{ 0, false, false, "", {} };
+    if (!mDatabaseFilePath.empty() && wxFileExists(mDatabaseFilePath) &&
+        !CheckDatabase(mDatabaseFilePath, fullCheckDue, databaseVerification) && !IsCancelled()) {
+        mFailures.push_back("Database " + mDatabaseFilePath.ToStdString() + " : " + databaseVerification.Message);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Verified {0:d} backups and the database ({1}), {2:d} failures, {3:d}ms",
+        verifiedBackups,
+        fullCheckDue ? "integrity_check" : "quick_check",
+        mFailures.size(),
+        elapsed.count());
+    return true;
+}
+
+bool BackupVerifier::IsCancelled() const
+{
+    return bCancelled;
+}
+
+const std::vector<std::string>& BackupVerifier::GetFailures() const
+{
+    return mFailures;
+}
+
+void BackupVerifier::VerifyBackup(BackupIndexEntry& entry, const BackupIndexEntry* previousEntry, bool fullCheck)
+{
+    auto& verification = entry.Verification;
+    verification = { static_cast<std::int64_t>(wxDateTime::Now().GetTicks()), fullCheck, false, "", {} };
+
+    auto backupFilePath = wxFileName(mBackupDirectory, entry.FileName).GetFullPath();
+    auto checksum = common::Sha256::HashFile(backupFilePath.ToStdString());
+    if (checksum.empty()) {
+        verification.Message = "backup file could not be read";
+    } else if (!entry.Checksum.empty() && entry.Checksum != checksum) {
+        verification.Message = "checksum does not match";
+    } else {
+        /* backups found by a directory scan get their checksum on first verification */
+        entry.Checksum = checksum;
+
+        auto databaseFilePath = ExtractBackup(entry.FileName);
+        if (databaseFilePath.empty()) {
+            verification.Message = "backup could not be extracted";
+        } else {
+            verification.Passed = CheckDatabase(databaseFilePath, fullCheck, verification);
+            if (databaseFilePath != backupFilePath) {
+                wxRemoveFile(databaseFilePath);
+            }
+        }
+    }
+
+    if (IsCancelled()) {
+        return;
+    }
+
+    /* rows are never deleted, so fewer rows than in the previous backup is worth a warning */
+    if (verification.Passed && previousEntry != nullptr) {
+        for (const auto& [table, previousCount] : previousEntry->Verification.RowCounts) {
+            auto rowCount = verification.RowCounts.find(table);
+            if (rowCount != verification.RowCounts.end() && rowCount->second < previousCount) {
+                pLogger->warn("Backup {0} has {1:d} rows in {2}, {3:d} less than {4}",
+                    entry.FileName,
+                    rowCount->second,
+                    table,
+                    previousCount - rowCount->second,
+                    previousEntry->FileName);
+            }
+        }
+    }
+
+    if (!verification.Passed) {
+        pLogger->error("Verification of backup {0} failed : {1}", entry.FileName, verification.Message);
+        mFailures.push_back("Backup " + entry.FileName + " : " + verification.Message);
+    }
+}
+
+bool BackupVerifier::CheckDatabase(const wxString& databaseFilePath,
+    bool fullCheck,
+    BackupVerification& verification)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> problems;
+    try {
+        auto config = sqlite::sqlite_config{ sqlite::OpenFlags::READONLY, nullptr, sqlite::Encoding::UTF8 };
+        sqlite::database database(databaseFilePath.ToStdString(), config);
+
+        /* lets a cancelled verification interrupt a long running check */
+        sqlite3_progress_handler(database.connection().get(), 10000, &BackupVerifier::OnProgress, this);
+
+        database << (fullCheck ? "PRAGMA integrity_check;" : "PRAGMA quick_check;") >>
+            [&](std::string result) { problems.push_back(result); };
+
+        std::vector<std::string> tables;
+        database << "SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%';" >>
+            [&](std::string name) { tables.push_back(name); };
+
+        for (const auto& table : tables) {
+            std::int64_t rowCount = 0;
+            database << "SELECT COUNT(*) FROM \"" + table + "\";" >> rowCount;
+            verification.RowCounts[table] = rowCount;
+        }
+    } catch (const sqlite::sqlite_exception& e) {
+        if (e.get_code() == SQLITE_INTERRUPT) {
+            return false;
+        }
+
+        pLogger->error("Error occured when verifying {0} - {1:d} : {2}",
+            databaseFilePath.ToStdString(),
+            e.get_code(),
+            e.what());
+        verification.Message = e.what();
+        return false;
+    }
+
+    if (problems.size() != 1 || problems.front() != "ok") {
+        verification.Message = problems.empty() ? "check returned no result" : problems.front();
+        return false;
+    }
+
+    for (const auto& table : RequiredTables) {
+        if (verification.RowCounts.find(table) == verification.RowCounts.end()) {
+            verification.Message = "table " + table + " is missing";
+            return false;
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Verified {0} with {1}, {2:d} tables, {3:d}ms",
+        databaseFilePath.ToStdString(),
+        fullCheck ? "integrity_check" : "quick_check",
+        verification.RowCounts.size(),
+        elapsed.count());
+    verification.Message = "ok";
+    return true;
+}
+
+/* plain backups are checked in place, compressed and incremental ones in a temporary copy */
+wxString BackupVerifier::ExtractBackup(const wxString& backupFileName)
+{
+    auto backupFilePath = wxFileName(mBackupDirectory, backupFileName).GetFullPath();
+    if (!BackupCompressor::IsCompressedBackup(backupFileName) && !BackupChunkStore::IsManifest(backupFileName)) {
+        return backupFilePath;
+    }
+
+    auto temporaryFilePath =
+        wxFileName::CreateTempFileName(wxFileName(wxFileName::GetTempDir(), backupFileName).GetFullPath());
+    if (temporaryFilePath.empty()) {
+        return wxGetEmptyString();
+    }
+
+    /* the same cancellation as the checks, IsCancelled tells a cancelled extraction from a failed one */
+    auto cancelCallback = [this]() { return OnProgress(this) != 0; };
+
+    bool extracted = false;
+    if (BackupChunkStore::IsManifest(backupFileName)) {
+        BackupChunkStore backupChunkStore(pLogger, mBackupDirectory);
+        extracted = backupChunkStore.Restore(backupFilePath, temporaryFilePath, cancelCallback);
+    } else {
+        BackupCompressor backupCompressor(pLogger);
+        extracted = backupCompressor.Decompress(backupFilePath, temporaryFilePath, cancelCallback);
+    }
+
+    if (!extracted) {
+        wxRemoveFile(temporaryFilePath);
+        return wxGetEmptyString();
+    }
+    return temporaryFilePath;
+}
+
+int BackupVerifier::OnProgress(void* verifier)
+{
+    auto self = static_cast<BackupVerifier*>(verifier);
+    if (!self->bCancelled && self->mCancelCallback != nullptr && self->mCancelCallback()) {
+        self->bCancelled = true;
+    }
+    return self->bCancelled ? 1 : 0;
+}
+} // namespace app::svc
@@ -0,0 +1,83 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+#include <wx/string.h>
+
+#include "backupindex.h"
+
+namespace app::svc
+{
+/* polled between checks and while SQLite runs them, return true to stop verifying */
+using VerificationCancelCallback = std::function<bool()>;
+
+/*
+ Checks that backups can actually be restored before anyone needs them. Every backup not yet
+ verified is checksummed, opened read-only and run through PRAGMA quick_check with per table row
+ counts, and the results are written back to the backup index. The live database gets the same
+ check, and once every FullCheckIntervalDays both use the slower PRAGMA integrity_check.
+ */
+class BackupVerifier final
+{
+public:
+    BackupVerifier() = delete;
+    BackupVerifier(std::shared_ptr<spdlog::logger> logger,
+        const wxString& backupDirectory,
+        const wxString& databaseFilePath,
+        VerificationCancelCallback cancelCallback);
+    ~BackupVerifier() = default;
+
+    /* false when verification could not run, failed checks are reported by GetFailures */
+    bool Execute();
+
+    bool IsCancelled() const;
+    const std::vector<std::string>& GetFailures() const;
+
+    /* runs quick_check or integrity_check, collects row counts and checks the required tables exist */
+    bool CheckDatabase(const wxString& databaseFilePath, bool fullCheck, BackupVerification& verification);
+    /*
+     path to a plain database file for the backup, a temporary copy the caller removes if it differs.
+     Empty when extracting failed or was cancelled.
+     */
+    wxString ExtractBackup(const wxString& backupFileName);
+
+    static const int FullCheckIntervalDays;
+
+private:
+    void VerifyBackup(BackupIndexEntry& entry, const BackupIndexEntry* previousEntry, bool fullCheck);
+
+    static int OnProgress(void* verifier);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    wxString mBackupDirectory;
+    wxString mDatabaseFilePath;
+    VerificationCancelCallback mCancelCallback;
+    std::vector<std::string> mFailures;
+    bool bCancelled;
+
+    static const std::vector<std::string> RequiredTables;
+};
+} // namespace app::svc
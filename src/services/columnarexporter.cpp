@@ -0,0 +1,359 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "columnarexporter.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <sqlite_modern_cpp/errors.h>
+
+#include "exportdatareader.h"
+
+namespace app::svc
+{
+namespace
+{
+const char Magic[4] = { 'T', 'S', 'K', 'C' };
+
+void AppendUInt8(std::string& buffer, std::uint8_t value)
+{
+    buffer.push_back(static_cast<char>(value));
+}
+
+void AppendUInt16(std::string& buffer, std::uint16_t value)
+{
+    for (int i = 0; i < 2; i++) {
+        buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+void AppendUInt32(std::string& buffer, std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+void AppendUInt64(std::string& buffer, std::uint64_t value)
+{
+    for (int i = 0; i < 8; i++) {
+        buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+void AppendFloat64(std::string& buffer, double value)
+{
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    AppendUInt64(buffer, bits);
+}
+
+void AppendBitmap(std::string& buffer, const std::vector<bool>& bits)
+{
+    std::uint8_t current = 0;
+    for (std::size_t i = 0; i < bits.size(); i++) {
+        if (bits[i]) {
+            current |= static_cast<std::uint8_t>(1u << (i % 8));
+        }
+        if (i % 8 == 7) {
+            AppendUInt8(buffer, current);
+            current = 0;
+        }
+    }
+    if (bits.size() % 8 != 0) {
+        AppendUInt8(buffer, current);
+    }
+}
+
+void AppendColumn(std::string& buffer, const char* name, ColumnarExporter::ColumnType type, std::uint8_t flags)
+{
+    std::size_t nameLength = std::strlen(name);
+    AppendUInt8(buffer, static_cast<std::uint8_t>(type));
+    AppendUInt8(buffer, flags);
+    AppendUInt8(buffer, static_cast<std::uint8_t>(nameLength));
+    buffer.append(name, nameLength);
+}
+
+std::string EncodeInt32Chunk(const std::vector<std::int32_t>& values, const std::vector<bool>* validity = nullptr)
+{
+    std::string chunk;
+    chunk.reserve(values.size() * 4 + values.size() / 8 + 1);
+    if (validity != nullptr) {
+        AppendBitmap(chunk, *validity);
+    }
+    for (auto value : values) {
+        AppendUInt32(chunk, static_cast<std::uint32_t>(value));
+    }
+    return chunk;
+}
+
+std::string EncodeUInt32Chunk(const std::vector<std::uint32_t>& values)
+{
+    std::string chunk;
+    chunk.reserve(values.size() * 4);
+    for (auto value : values) {
+        AppendUInt32(chunk, value);
+    }
+    return chunk;
+}
+
+std::string EncodeFloat64Chunk(const std::vector<double>& values, const std::vector<bool>& validity)
+{
+    std::string chunk;
+    chunk.reserve(values.size() * 8 + values.size() / 8 + 1);
+    AppendBitmap(chunk, validity);
+    for (auto value : values) {
+        AppendFloat64(chunk, value);
+    }
+    return chunk;
+}
+
+/* Days since 1970-01-01 for a 'YYYY-MM-DD' date (proleptic Gregorian calendar) */
+std::int32_t DateToDays(const std::string& date)
+{
+    int year = std::atoi(date.c_str());
+    unsigned month = date.size() >= 7 ? static_cast<unsigned>(std::atoi(date.c_str() + 5)) : 1;
+    unsigned day = date.size() >= 10 ? static_cast<unsigned>(std::atoi(date.c_str() + 8)) : 1;
+
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<std::int32_t>(dayOfEra) - 719468;
+}
+} // namespace
+
+const std::uint16_t ColumnarExporter::FormatVersion = 1;
+const std::size_t ColumnarExporter::RowGroupSize = 4096;
+
+ColumnarExporter::ColumnarExporter(std::shared_ptr<spdlog::logger> logger,
+    const std::string& fromDate,
+    const std::string& toDate,
+    const std::string& fileName)
+    : pLogger(logger)
+    , mFromDate(fromDate)
+    , mToDate(toDate)
+    , mFileName(fileName)
+    , mFile()
+    , mBytesWritten(0)
+    , mRowGroup()
+    , mTaskItemTypes()
+    , mProjects()
+    , mCategories()
+{
+}
+
+bool ColumnarExporter::ExportData()
+{
+    std::string fullFilePath = GetExportFilePath(mFileName);
+
+    mFile.open(fullFilePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!mFile) {
+        pLogger->error("Error when trying to create a columnar file at specified location {0}", fullFilePath);
+        return false;
+    }
+
+    WriteHeader();
+
+    try {
+        ExportDataReader reader(mFromDate, mToDate);
+        reader.Read([&](const ExportRow& row) {
+            AppendRow(row);
+            if (mRowGroup.Size() >= RowGroupSize) {
+                FlushRowGroup();
+            }
+        });
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured in ColumnarExporter::ExportData - {0:d} : {1}", e.get_code(), e.what());
+        mFile.close();
+        return false;
+    }
+
+    FlushRowGroup();
+
+    /* end marker: a row group with zero rows */
+    std::string endMarker;
+    AppendUInt32(endMarker, 0);
+    mFile.write(endMarker.data(), endMarker.size());
+    mBytesWritten += endMarker.size();
+
+    WriteDictionaries();
+
+    mFile.close();
+    if (mFile.fail()) {
+        pLogger->error("Error when writing columnar file {0}", fullFilePath);
+        return false;
+    }
+
+    return true;
+}
+
+std::uint32_t ColumnarExporter::Dictionary::Encode(const std::string& value)
+{
+    auto it = Lookup.find(value);
+    if (it != Lookup.end()) {
+        return it->second;
+    }
+
+    auto index = static_cast<std::uint32_t>(Values.size());
+    Lookup.emplace(value, index);
+    Values.push_back(value);
+    return index;
+}
+
+std::size_t ColumnarExporter::RowGroup::Size() const
+{
+    return Dates.size();
+}
+
+void ColumnarExporter::RowGroup::Clear()
+{
+    Dates.clear();
+    StartTimes.clear();
+    StartTimesValid.clear();
+    EndTimes.clear();
+    EndTimesValid.clear();
+    Durations.clear();
+    DescriptionOffsets.clear();
+    DescriptionBytes.clear();
+    CalculatedRates.clear();
+    CalculatedRatesValid.clear();
+    TaskItemTypes.clear();
+    Projects.clear();
+    Billable.clear();
+    ProjectRates.clear();
+    ProjectRatesValid.clear();
+    Categories.clear();
+}
+
+void ColumnarExporter::WriteHeader()
+{
+    std::string header;
+    header.append(Magic, sizeof(Magic));
+    AppendUInt16(header, FormatVersion);
+    AppendUInt16(header, 11);
+
+    AppendColumn(header, "date", ColumnType::Date32, ColumnFlags::None);
+    AppendColumn(header, "start_time", ColumnType::Time32, ColumnFlags::Nullable);
+    AppendColumn(header, "end_time", ColumnType::Time32, ColumnFlags::Nullable);
+    AppendColumn(header, "duration", ColumnType::Int32, ColumnFlags::None);
+    AppendColumn(header, "description", ColumnType::String, ColumnFlags::None);
+    AppendColumn(header, "calculated_rate", ColumnType::Float64, ColumnFlags::Nullable);
+    AppendColumn(header, "task_item_type", ColumnType::Dictionary, ColumnFlags::None);
+    AppendColumn(header, "project", ColumnType::Dictionary, ColumnFlags::None);
+    AppendColumn(header, "billable", ColumnType::Bool, ColumnFlags::None);
+    AppendColumn(header, "project_rate", ColumnType::Float64, ColumnFlags::Nullable);
+    AppendColumn(header, "category", ColumnType::Dictionary, ColumnFlags::None);
+
+    mFile.write(header.data(), header.size());
+    mBytesWritten += header.size();
+}
+
+void ColumnarExporter::AppendRow(const ExportRow& row)
+{
+    mRowGroup.Dates.push_back(DateToDays(row.TaskDate));
+
+    mRowGroup.StartTimes.push_back(row.StartTime ? DurationToSeconds(*row.StartTime) : 0);
+    mRowGroup.StartTimesValid.push_back(row.StartTime != nullptr);
+
+    mRowGroup.EndTimes.push_back(row.EndTime ? DurationToSeconds(*row.EndTime) : 0);
+    mRowGroup.EndTimesValid.push_back(row.EndTime != nullptr);
+
+    mRowGroup.Durations.push_back(DurationToSeconds(row.Duration));
+
+    mRowGroup.DescriptionBytes.append(row.Description);
+    mRowGroup.DescriptionOffsets.push_back(static_cast<std::uint32_t>(mRowGroup.DescriptionBytes.size()));
+
+    mRowGroup.CalculatedRates.push_back(row.CalculatedRate ? *row.CalculatedRate : 0.0);
+    mRowGroup.CalculatedRatesValid.push_back(row.CalculatedRate != nullptr);
+
+    mRowGroup.TaskItemTypes.push_back(mTaskItemTypes.Encode(row.TaskItemType));
+    mRowGroup.Projects.push_back(mProjects.Encode(row.ProjectName));
+    mRowGroup.Billable.push_back(row.Billable);
+
+    mRowGroup.ProjectRates.push_back(row.Rate ? *row.Rate : 0.0);
+    mRowGroup.ProjectRatesValid.push_back(row.Rate != nullptr);
+
+    mRowGroup.Categories.push_back(mCategories.Encode(row.CategoryName));
+}
+
+void ColumnarExporter::FlushRowGroup()
+{
+    if (mRowGroup.Size() == 0) {
+        return;
+    }
+
+    std::string descriptions = EncodeUInt32Chunk(mRowGroup.DescriptionOffsets);
+    descriptions.append(mRowGroup.DescriptionBytes);
+
+    std::string billable;
+    AppendBitmap(billable, mRowGroup.Billable);
+
+    const std::string chunks[] = {
+        EncodeInt32Chunk(mRowGroup.Dates),
+        EncodeInt32Chunk(mRowGroup.StartTimes, &mRowGroup.StartTimesValid),
+        EncodeInt32Chunk(mRowGroup.EndTimes, &mRowGroup.EndTimesValid),
+        EncodeInt32Chunk(mRowGroup.Durations),
+        descriptions,
+        EncodeFloat64Chunk(mRowGroup.CalculatedRates, mRowGroup.CalculatedRatesValid),
+        EncodeUInt32Chunk(mRowGroup.TaskItemTypes),
+        EncodeUInt32Chunk(mRowGroup.Projects),
+        billable,
+        EncodeFloat64Chunk(mRowGroup.ProjectRates, mRowGroup.ProjectRatesValid),
+        EncodeUInt32Chunk(mRowGroup.Categories),
+    };
+
+    std::string prefix;
+    AppendUInt32(prefix, static_cast<std::uint32_t>(mRowGroup.Size()));
+    mFile.write(prefix.data(), prefix.size());
+    mBytesWritten += prefix.size();
+
+    for (const auto& chunk : chunks) {
+        std::string length;
+        AppendUInt32(length, static_cast<std::uint32_t>(chunk.size()));
+        mFile.write(length.data(), length.size());
+        mFile.write(chunk.data(), chunk.size());
+        mBytesWritten += length.size() + chunk.size();
+    }
+
+    mRowGroup.Clear();
+}
+
+void ColumnarExporter::WriteDictionaries()
+{
+    std::uint64_t dictionariesOffset = mBytesWritten;
+
+    std::string buffer;
+    for (const Dictionary* dictionary : { &mTaskItemTypes, &mProjects, &mCategories }) {
+        AppendUInt32(buffer, static_cast<std::uint32_t>(dictionary->Values.size()));
+        for (const auto& value : dictionary->Values) {
+            AppendUInt32(buffer, static_cast<std::uint32_t>(value.size()));
+            buffer.append(value);
+        }
+    }
+
+    AppendUInt64(buffer, dictionariesOffset);
+    buffer.append(Magic, sizeof(Magic));
+
+    mFile.write(buffer.data(), buffer.size());
+    mBytesWritten += buffer.size();
+}
+} // namespace app::svc
@@ -0,0 +1,150 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "exporter.h"
+
+namespace app::svc
+{
+struct ExportRow;
+
+/*
+ Taskable columnar export format (.tskc), version 1
+
+ Rows are buffered into row groups of up to RowGroupSize rows and every column of a
+ row group is written out as one contiguous chunk. Only the current row group and the
+ dictionaries are held in memory. All integers are little-endian.
+
+ File         := Header RowGroup* EndMarker Dictionaries Footer
+ Header       := "TSKC" u16:version u16:columnCount Column[columnCount]
+ Column       := u8:type u8:flags u8:nameLength u8[nameLength]:name
+ RowGroup     := u32:rowCount (> 0) Chunk[columnCount]
+ Chunk        := u32:byteLength [Validity] Values
+ Validity     := only when flags has Nullable, ceil(rowCount / 8) bytes,
+                 bit (i % 8) of byte (i / 8) is set when row i has a value
+ Values       := Date32      i32[rowCount] days since 1970-01-01
+               | Time32      i32[rowCount] seconds since midnight
+               | Int32       i32[rowCount]
+               | Float64     f64[rowCount] IEEE-754
+               | Bool        ceil(rowCount / 8) bytes, same bit order as Validity
+               | String      u32[rowCount] end offsets into the bytes that follow, then UTF-8 bytes
+               | Dictionary  u32[rowCount] indices into the dictionary of the column
+ EndMarker    := u32:0
+ Dictionaries := per Dictionary column, in column order: u32:count (u32:length u8[length])[count]
+ Footer       := u64:offset of Dictionaries from the start of the file, "TSKC"
+
+ Null values are written as zero and must be read through the validity bitmap.
+
+ Columns (version 1):
+   date             Date32
+   start_time       Time32      nullable
+   end_time         Time32      nullable
+   duration         Int32       seconds
+   description      String
+   calculated_rate  Float64     nullable
+   task_item_type   Dictionary
+   project          Dictionary
+   billable         Bool
+   project_rate     Float64     nullable
+   category         Dictionary
+ */
+class ColumnarExporter final : public IExporter
+{
+public:
+    ColumnarExporter(std::shared_ptr<spdlog::logger> logger,
+        const std::string& fromDate,
+        const std::string& toDate,
+        const std::string& fileName);
+    virtual ~ColumnarExporter() = default;
+
+    bool ExportData() override;
+
+    enum class ColumnType : std::uint8_t {
+        Date32 = 1,
+        Time32,
+        Int32,
+        Float64,
+        Bool,
+        String,
+        Dictionary,
+    };
+
+    enum ColumnFlags : std::uint8_t { None = 0, Nullable = 1 };
+
+    static const std::uint16_t FormatVersion;
+    static const std::size_t RowGroupSize;
+
+private:
+    struct Dictionary {
+        std::unordered_map<std::string, std::uint32_t> Lookup;
+        std::vector<std::string> Values;
+
+        std::uint32_t Encode(const std::string& value);
+    };
+
+    struct RowGroup {
+        std::vector<std::int32_t> Dates;
+        std::vector<std::int32_t> StartTimes;
+        std::vector<bool> StartTimesValid;
+        std::vector<std::int32_t> EndTimes;
+        std::vector<bool> EndTimesValid;
+        std::vector<std::int32_t> Durations;
+        std::vector<std::uint32_t> DescriptionOffsets;
+        std::string DescriptionBytes;
+        std::vector<double> CalculatedRates;
+        std::vector<bool> CalculatedRatesValid;
+        std::vector<std::uint32_t> TaskItemTypes;
+        std::vector<std::uint32_t> Projects;
+        std::vector<bool> Billable;
+        std::vector<double> ProjectRates;
+        std::vector<bool> ProjectRatesValid;
+        std::vector<std::uint32_t> Categories;
+
+        std::size_t Size() const;
+        void Clear();
+    };
+
+    void WriteHeader();
+    void AppendRow(const ExportRow& row);
+    void FlushRowGroup();
+    void WriteDictionaries();
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::string mFromDate;
+    std::string mToDate;
+    std::string mFileName;
+
+    std::ofstream mFile;
+    std::uint64_t mBytesWritten;
+    RowGroup mRowGroup;
+    Dictionary mTaskItemTypes;
+    Dictionary mProjects;
+    Dictionary mCategories;
+};
+} // namespace app::svc
@@ -19,141 +19,90 @@
 
 #include "csvexporter.h"
 
+#include <cstring>
 #include <fstream>
 
 #include <sqlite_modern_cpp/errors.h>
 
 #include "../config/configurationprovider.h"
+#include "csvwriter.h"
+#include "exportdatareader.h"
 
 namespace app::svc
 {
-std::string CsvExporter::Query = "SELECT "
-                                 "  task_items.start_time "
-                                 ", task_items.end_time "
-                                 ", task_items.duration "
-                                 ", task_items.description "
-                                 ", task_items.calculated_rate "
-                                 ", task_item_types.name "
-                                 ", projects.name "
-                                 ", projects.billable "
-                                 ", projects.rate "
-                                 ", categories.name "
-                                 ", tasks.task_date "
-                                 "FROM task_items "
-                                 "INNER JOIN task_item_types "
-                                 "ON task_items.task_item_type_id = task_item_types.task_item_type_id "
-                                 "INNER JOIN projects "
-                                 "ON task_items.project_id = projects.project_id "
-                                 "INNER JOIN categories "
-                                 "ON task_items.category_id = categories.category_id "
-                                 "INNER JOIN tasks "
-                                 "ON task_items.task_id = tasks.task_id "
-                                 "WHERE tasks.task_date >= ? "
-                                 "AND tasks.task_date <= ? "
-                                 "AND task_items.is_active = 1";
-
 CsvExporter::CsvExporter(std::shared_ptr<spdlog::logger> logger,
     const std::string& fromDate,
     const std::string& toDate,
     const std::string& fileName)
     : pLogger(logger)
     , mFromDate(fromDate)
-    , mToDate(mToDate)
+    , mToDate(toDate)
     , mFileName(fileName)
 {
-    pConnection = db::ConnectionProvider::Get().Handle()->Acquire();
-}
-
-CsvExporter::~CsvExporter()
-{
-    db::ConnectionProvider::Get().Handle()->Release(pConnection);
 }
 
 bool CsvExporter::ExportData()
 {
-    /* get raw data from database */
-    std::vector<DataSet*> dataSets;
-    try {
-        dataSets = GetDataSet();
-    } catch (const sqlite::sqlite_exception& e) {
-        pLogger->error("Error occured in CsvExporter::ExportData - {0:d} : {1}", e.get_code(), e.what());
-        return false;
-    }
-
     /* get the delimiter */
-    std::string delimiter = cfg::ConfigurationProvider::Get().Configuration->GetDelimiter();
+    std::string configDelimiter = cfg::ConfigurationProvider::Get().Configuration->GetDelimiter();
+    char delimiter = configDelimiter.empty() ? ',' : configDelimiter[0];
 
     /* get the export path and combine with filename */
-    std::string exportFilePath = cfg::ConfigurationProvider::Get().Configuration->GetExportPath();
-    std::string fullFilePath = exportFilePath + "\\" + mFileName;
+    std::string fullFilePath = GetExportFilePath(mFileName);
 
     /* open and create file */
-    std::ofstream csvFile(fullFilePath);
+    std::ofstream csvFile(fullFilePath, std::ios_base::out | std::ios_base::binary);
 
     if (!csvFile) {
         pLogger->error("Error when trying to create a CSV file at specified location {0}", fullFilePath);
         return false;
     }
 
+    CsvWriter writer(csvFile, delimiter);
+
     /* write the headers */
-    csvFile << "Start Time" << delimiter << "End Time" << delimiter << "Duration" << delimiter << "Description"
-            << delimiter << "Calculated Rate" << delimiter << "Task Item Type" << delimiter << "Project" << delimiter
-            << "Billable" << delimiter << "Project Rate" << delimiter << "Category" << delimiter << "Date"
-            << "\n";
+    for (const char* header : { "Start Time",
+             "End Time",
+             "Duration",
+             "Description",
+             "Calculated Rate",
+             "Task Item Type",
+             "Project",
+             "Billable",
+             "Project Rate",
+             "Category",
+             "Date" }) {
+        writer.WriteField(header, std::strlen(header));
+    }
+    writer.EndRow();
 
-    /* write the data */
-    for (const auto& dataSet : dataSets) {
-        csvFile << (dataSet->StartTime ? *dataSet->StartTime : "N/A") << delimiter
-                << (dataSet->EndTime ? *dataSet->EndTime : "N/A") << delimiter << dataSet->Duration << delimiter
-                << dataSet->Description << delimiter << (dataSet->CalculatedRate ? *dataSet->CalculatedRate : -1)
-                << delimiter << dataSet->TaskItemType << delimiter << dataSet->ProjectName << delimiter
-                << (dataSet->Rate ? *dataSet->Rate : -1) << delimiter << dataSet->CategoryName << delimiter
-                << dataSet->TaskDate << "\n";
+    /* write the data as it is read from the database */
+    try {
+        ExportDataReader reader(mFromDate, mToDate);
+        reader.Read([&](const ExportRow& dataSet) {
+            writer.WriteField(dataSet.StartTime ? *dataSet.StartTime : NotApplicable);
+            writer.WriteField(dataSet.EndTime ? *dataSet.EndTime : NotApplicable);
+            writer.WriteField(dataSet.Duration);
+            writer.WriteField(dataSet.Description);
+            writer.WriteField(dataSet.CalculatedRate ? *dataSet.CalculatedRate : -1.0);
+            writer.WriteField(dataSet.TaskItemType);
+            writer.WriteField(dataSet.ProjectName);
+            writer.WriteField(dataSet.Billable);
+            writer.WriteField(dataSet.Rate ? *dataSet.Rate : -1.0);
+            writer.WriteField(dataSet.CategoryName);
+            writer.WriteField(dataSet.TaskDate);
+            writer.EndRow();
+        });
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured in CsvExporter::ExportData - {0:d} : {1}", e.get_code(), e.what());
+        return false;
     }
 
     /* clean up */
     csvFile.close();
 
-    while (!dataSets.empty()) {
-        delete dataSets.back();
-        dataSets.pop_back();
-    }
-
-    return true;
+    return !csvFile.fail();
 }
 
-std::vector<CsvExporter::DataSet*> CsvExporter::GetDataSet()
-{
-    std::vector<DataSet*> dataSets;
-
-    *pConnection->DatabaseExecutableHandle() << CsvExporter::Query << mFromDate << mToDate >>
-        [&](std::unique_ptr<std::string> taskItemsStartTime,
-            std::unique_ptr<std::string> taskItemsEndTime,
-            std::string taskItemsDuration,
-            std::string taskItemsDescription,
-            std::unique_ptr<double> taskItemsCalculatedRate,
-            std::string taskItemTypesName,
-            std::string projectsName,
-            bool projectsBillable,
-            std::unique_ptr<double> projectsRate,
-            std::string categoriesName,
-            std::string tasksDate) {
-            DataSet* data = new DataSet;
-            data->StartTime = std::move(taskItemsStartTime);
-            data->EndTime = std::move(taskItemsEndTime);
-            data->Duration = taskItemsDuration;
-            data->Description = taskItemsDescription;
-            data->CalculatedRate = std::move(taskItemsCalculatedRate);
-            data->TaskItemType = taskItemTypesName;
-            data->ProjectName = projectsName;
-            data->Billable = projectsBillable;
-            data->Rate = std::move(projectsRate);
-            data->CategoryName = categoriesName;
-            data->TaskDate = tasksDate;
-
-            dataSets.push_back(data);
-        };
-
-    return dataSets;
-}
+const std::string CsvExporter::NotApplicable = "N/A";
 } // namespace app::svc
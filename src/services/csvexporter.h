@@ -24,42 +24,24 @@
 
 #include <spdlog/spdlog.h>
 
-#include "../database/sqliteconnection.h"
-#include "../database/connectionprovider.h"
+#include "exporter.h"
 
 namespace app::svc
 {
-class CsvExporter
+class CsvExporter final : public IExporter
 {
 public:
     CsvExporter(std::shared_ptr<spdlog::logger> logger, const std::string& fromDate, const std::string& toDate, const std::string& fileName);
-    ~CsvExporter();
+    virtual ~CsvExporter() = default;
 
-    bool ExportData();
+    bool ExportData() override;
 
 private:
-    struct DataSet {
-        std::unique_ptr<std::string> StartTime;
-        std::unique_ptr<std::string> EndTime;
-        std::string Duration;
-        std::string Description;
-        std::unique_ptr<double> CalculatedRate;
-        std::string TaskItemType;
-        std::string ProjectName;
-        bool Billable;
-        std::unique_ptr<double> Rate;
-        std::string CategoryName;
-        std::string TaskDate;
-    };
-
-    std::vector<CsvExporter::DataSet*> GetDataSet();
-
     std::shared_ptr<spdlog::logger> pLogger;
-    std::shared_ptr<db::SqliteConnection> pConnection;
     std::string mFromDate;
     std::string mToDate;
     std::string mFileName;
 
-    static std::string Query;
+    static const std::string NotApplicable;
 };
 } // namespace app::svc
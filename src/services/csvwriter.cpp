@@ -0,0 +1,192 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "csvwriter.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TASKABLE_CSV_SSE2
+#endif // __SSE2__
+
+namespace app::svc
+{
+namespace
+{
+const std::uint64_t LowBits = 0x0101010101010101ull;
+const std::uint64_t HighBits = 0x8080808080808080ull;
+
+/* Non-zero when any byte of the word is zero */
+inline std::uint64_t HasZeroByte(std::uint64_t word)
+{
+    return (word - LowBits) & ~word & HighBits;
+}
+
+/* Non-zero when any byte of the word equals the byte broadcast into pattern */
+inline std::uint64_t HasByte(std::uint64_t word, std::uint64_t pattern)
+{
+    return HasZeroByte(word ^ pattern);
+}
+
+} // namespace
+
+CsvWriter::CsvWriter(std::ostream& output, char delimiter)
+    : mOutput(output)
+    , mDelimiter(delimiter)
+    , bFirstField(true)
+    , mRow()
+    , mSpecialBytes()
+{
+    mSpecialBytes[static_cast<unsigned char>(mDelimiter)] = true;
+    mSpecialBytes[static_cast<unsigned char>('"')] = true;
+    mSpecialBytes[static_cast<unsigned char>('\n')] = true;
+    mSpecialBytes[static_cast<unsigned char>('\r')] = true;
+}
+
+void CsvWriter::WriteField(const std::string& value)
+{
+    WriteField(value.data(), value.size());
+}
+
+void CsvWriter::WriteField(const char* value, std::size_t length)
+{
+    AppendDelimiter();
+
+    if (RequiresQuoting(value, length)) {
+        AppendQuoted(value, length);
+    } else {
+        mRow.append(value, length);
+    }
+}
+
+void CsvWriter::WriteField(double value)
+{
+    AppendDelimiter();
+
+    /* matches the default formatting of std::ostream for doubles */
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    mRow.append(buffer, length > 0 ? static_cast<std::size_t>(length) : 0);
+}
+
+void CsvWriter::WriteField(bool value)
+{
+    AppendDelimiter();
+    mRow.push_back(value ? '1' : '0');
+}
+
+void CsvWriter::EndRow()
+{
+    mRow.push_back('\n');
+    mOutput.write(mRow.data(), mRow.size());
+
+    mRow.clear();
+    bFirstField = true;
+}
+
+bool CsvWriter::RequiresQuoting(const char* value, std::size_t length) const
+{
+    /* most fields (times, dates, rates, names) are short, a table lookup beats setting up a wide scan */
+    if (length < 16) {
+        for (std::size_t i = 0; i < length; i++) {
+            if (mSpecialBytes[static_cast<unsigned char>(value[i])]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char delimiter = mDelimiter;
+    const std::uint64_t delimiterPattern = LowBits * static_cast<unsigned char>(delimiter);
+    const std::uint64_t quotePattern = LowBits * static_cast<unsigned char>('"');
+    const std::uint64_t newLinePattern = LowBits * static_cast<unsigned char>('\n');
+    const std::uint64_t carriageReturnPattern = LowBits * static_cast<unsigned char>('\r');
+
+    std::size_t i = 0;
+
+#ifdef TASKABLE_CSV_SSE2
+    const __m128i delimiterVector = _mm_set1_epi8(delimiter);
+    const __m128i quoteVector = _mm_set1_epi8('"');
+    const __m128i newLineVector = _mm_set1_epi8('\n');
+    const __m128i carriageReturnVector = _mm_set1_epi8('\r');
+
+    for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(value + i));
+        __m128i matches = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, delimiterVector), _mm_cmpeq_epi8(block, quoteVector)),
+            _mm_or_si128(_mm_cmpeq_epi8(block, newLineVector), _mm_cmpeq_epi8(block, carriageReturnVector)));
+
+        if (_mm_movemask_epi8(matches) != 0) {
+            return true;
+        }
+    }
+#endif // TASKABLE_CSV_SSE2
+
+    for (; i + sizeof(std::uint64_t) <= length; i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, value + i, sizeof(word));
+
+        if (HasByte(word, delimiterPattern) | HasByte(word, quotePattern) | HasByte(word, newLinePattern) |
+            HasByte(word, carriageReturnPattern)) {
+            return true;
+        }
+    }
+
+    for (; i < length; i++) {
+        if (mSpecialBytes[static_cast<unsigned char>(value[i])]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void CsvWriter::AppendDelimiter()
+{
+    if (!bFirstField) {
+        mRow.push_back(mDelimiter);
+    }
+    bFirstField = false;
+}
+
+void CsvWriter::AppendQuoted(const char* value, std::size_t length)
+{
+    mRow.push_back('"');
+
+    const char* begin = value;
+    const char* end = value + length;
+    while (begin < end) {
+        auto quote = static_cast<const char*>(std::memchr(begin, '"', end - begin));
+        if (quote == nullptr) {
+            mRow.append(begin, end - begin);
+            break;
+        }
+
+        /* copy up to and including the quote, then double it */
+        mRow.append(begin, quote - begin + 1);
+        mRow.push_back('"');
+        begin = quote + 1;
+    }
+
+    mRow.push_back('"');
+}
+} // namespace app::svc
@@ -0,0 +1,62 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace app::svc
+{
+/*
+ Writes RFC 4180 style rows. A field is only quoted when it contains the delimiter, a double
+ quote or a line break, in which case it is wrapped in double quotes and embedded quotes are
+ doubled. Fields are scanned sixteen bytes at a time with SSE2 where available and eight bytes
+ at a time otherwise, so the common case (nothing to escape) costs about the same as writing
+ the field raw.
+ */
+class CsvWriter final
+{
+public:
+    CsvWriter() = delete;
+    CsvWriter(std::ostream& output, char delimiter);
+    ~CsvWriter() = default;
+
+    void WriteField(const std::string& value);
+    void WriteField(const char* value, std::size_t length);
+    void WriteField(double value);
+    void WriteField(bool value);
+    void EndRow();
+
+    bool RequiresQuoting(const char* value, std::size_t length) const;
+
+private:
+    void AppendDelimiter();
+    void AppendQuoted(const char* value, std::size_t length);
+
+    std::ostream& mOutput;
+    char mDelimiter;
+    bool bFirstField;
+    std::string mRow;
+
+    /* lookup table used for fields too short for a word-sized scan */
+    bool mSpecialBytes[256];
+};
+} // namespace app::svc
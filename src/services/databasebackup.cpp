@@ -19,19 +19,30 @@
 
 #include "databasebackup.h"
 
+#include <chrono>
 #include <string>
 
 #include <wx/datetime.h>
-#include <wx/file.h>
-#include <wx/stdpaths.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
 
-#include "../common/common.h"
+#include "../common/metrics.h"
+#include "../common/paths.h"
+#include "../common/perflog.h"
 #include "../config/configurationprovider.h"
+#include "backupchunkstore.h"
+#include "backupcompressor.h"
+#include "backupindex.h"
 
 namespace app::svc
 {
+const int DatabaseBackup::DefaultPagesPerStep = 1024;
+const int DatabaseBackup::DefaultStepSleepMilliseconds = 10;
+const int DatabaseBackup::BusyRetryMilliseconds = 50;
+
 DatabaseBackup::DatabaseBackup(std::shared_ptr<spdlog::logger> logger)
     : pLogger(logger)
+    , bCancelled(false)
 {
     pConnection = db::ConnectionProvider::Get().Handle()->Acquire();
 }
@@ -43,19 +54,92 @@ DatabaseBackup::~DatabaseBackup()
 
 bool DatabaseBackup::Execute()
 {
+    return Execute(-1, 0, nullptr);
+}
+
+bool DatabaseBackup::Execute(int pagesPerStep, int sleepMilliseconds, BackupProgressCallback progressCallback)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    bool success = CreateBackup(pagesPerStep, sleepMilliseconds, progressCallback);
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+
+    std::string mode = "full";
+    if (cfg::ConfigurationProvider::Get().Configuration->IsIncrementalBackups()) {
+        mode = "incremental";
+    } else if (cfg::ConfigurationProvider::Get().Configuration->IsCompressBackups()) {
+        mode = "compressed";
+    }
+    common::MetricsRegistry::Get()
+        .GetHistogram(common::MetricNames::BackupPrefix + mode)
+        .Record(static_cast<std::uint64_t>(duration.count() * 1000.0));
+    if (!success) {
+        common::MetricsRegistry::Get().GetCounter(common::MetricNames::BackupFailed).Increment();
+    }
+    common::PerfLog::Get().RecordBackup(mode, duration.count(), success);
+
+    return success;
+}
+
+bool DatabaseBackup::CreateBackup(int pagesPerStep, int sleepMilliseconds, BackupProgressCallback progressCallback)
+{
+    bCancelled = false;
+
     wxString fileName = CreateBackupFileName();
     wxString filePath = GetBackupFullPath(fileName);
     if (fileName.empty() || filePath.empty()) {
         return false;
     }
 
-    if (!CreateBackupFile(filePath)) {
+    /*
+     the snapshot is taken into a temporary file in the backup directory and only replaces today's backup
+     once it is complete, so a failed or cancelled backup leaves the earlier one of the day intact.
+     Compressed and incremental backups stream the snapshot through zlib or split it into chunks,
+     incremental backups take precedence.
+     */
+    bool incrementalBackup = cfg::ConfigurationProvider::Get().Configuration->IsIncrementalBackups();
+    bool compressBackup = !incrementalBackup && cfg::ConfigurationProvider::Get().Configuration->IsCompressBackups();
+    wxString snapshotFilePath = CreateTemporaryFile(filePath);
+    if (snapshotFilePath.empty()) {
         return false;
     }
-    if (!ExecuteBackup(filePath)) {
+
+    if (!ExecuteBackup(snapshotFilePath, pagesPerStep, sleepMilliseconds, progressCallback)) {
+        wxRemoveFile(snapshotFilePath);
         return false;
     }
-    return true;
+
+    int schemaVersion = BackupIndex::ReadSchemaVersion(snapshotFilePath);
+
+    wxString backupFilePath = filePath;
+    bool stored = true;
+    if (incrementalBackup) {
+        /* the manifest is itself written under a temporary name and renamed */
+        backupFilePath = BackupChunkStore::GetManifestFileName(filePath);
+        BackupChunkStore backupChunkStore(pLogger, wxFileName(filePath).GetPath());
+        stored = backupChunkStore.Store(snapshotFilePath, backupFilePath);
+        wxRemoveFile(snapshotFilePath);
+    } else if (compressBackup) {
+        backupFilePath = BackupCompressor::GetCompressedFileName(filePath);
+        wxString compressedFilePath = CreateTemporaryFile(backupFilePath);
+        BackupCompressor backupCompressor(pLogger);
+        stored = !compressedFilePath.empty() && backupCompressor.Compress(snapshotFilePath, compressedFilePath) &&
+                 ReplaceBackupFile(compressedFilePath, backupFilePath);
+        wxRemoveFile(snapshotFilePath);
+    } else {
+        stored = ReplaceBackupFile(snapshotFilePath, backupFilePath);
+    }
+
+    if (!stored) {
+        return false;
+    }
+
+    BackupIndex backupIndex(pLogger, wxFileName(filePath).GetPath());
+    return backupIndex.Add(backupFilePath, schemaVersion);
+}
+
+bool DatabaseBackup::IsCancelled() const
+{
+    return bCancelled;
 }
 
 wxString DatabaseBackup::CreateBackupFileName()
@@ -78,23 +162,39 @@ wxString DatabaseBackup::CreateBackupFileName()
 wxString DatabaseBackup::GetBackupFullPath(const wxString& filename)
 {
     auto backupDirectory = cfg::ConfigurationProvider::Get().Configuration->GetBackupPath();
-    auto backupFilePath = wxString::Format(wxT("%s\\%s"), backupDirectory, filename);
-    return backupFilePath;
+    return wxFileName(backupDirectory, filename).GetFullPath();
 }
 
-bool DatabaseBackup::CreateBackupFile(const wxString& fileName)
+/* an empty, uniquely named file next to filePath, "<name>.tmp" followed by random characters */
+wxString DatabaseBackup::CreateTemporaryFile(const wxString& filePath)
 {
-    wxFile file;
-    bool success = file.Create(fileName, true);
-    if (!success) {
-        pLogger->error("Failed to create file {0}", fileName.ToStdString());
+    auto temporaryFilePath = wxFileName::CreateTempFileName(wxString::Format(wxT("%s.tmp"), filePath));
+    if (temporaryFilePath.empty()) {
+        pLogger->error("Failed to create temporary file for {0}", filePath.ToStdString());
     }
-    file.Close();
-    return success;
+    return temporaryFilePath;
+}
+
+bool DatabaseBackup::ReplaceBackupFile(const wxString& temporaryFilePath, const wxString& backupFilePath)
+{
+    if (!wxRenameFile(temporaryFilePath, backupFilePath)) {
+        pLogger->error("Failed to rename {0} to {1}", temporaryFilePath.ToStdString(), backupFilePath.ToStdString());
+        wxRemoveFile(temporaryFilePath);
+        return false;
+    }
+    return true;
 }
 
-bool DatabaseBackup::ExecuteBackup(const wxString& fileName)
+bool DatabaseBackup::ExecuteBackup(const wxString& fileName,
+    int pagesPerStep,
+    int sleepMilliseconds,
+    BackupProgressCallback progressCallback)
 {
+    auto start = std::chrono::steady_clock::now();
+    int rc = SQLITE_OK;
+    int pageCount = 0;
+    int steps = 0;
+
     try {
         auto config = sqlite::sqlite_config{ sqlite::OpenFlags::READWRITE, nullptr, sqlite::Encoding::UTF8 };
         sqlite::database backupConnection(fileName.ToStdString(), config);
@@ -104,16 +204,53 @@ bool DatabaseBackup::ExecuteBackup(const wxString& fileName)
             sqlite3_backup_init(backupConnection.connection().get(), "main", existingConnection.get(), "main"),
             sqlite3_backup_finish);
 
-        if (state) {
-            int rc = -1;
-            do {
-                rc = sqlite3_backup_step(state.get(), -1);
-            } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+        if (!state) {
+            pLogger->error("Error occured when initializing database backup - {0:d} : {1}",
+                sqlite3_errcode(backupConnection.connection().get()),
+                sqlite3_errmsg(backupConnection.connection().get()));
+            return false;
         }
+
+        do {
+            rc = sqlite3_backup_step(state.get(), pagesPerStep);
+            steps++;
+            pageCount = sqlite3_backup_pagecount(state.get());
+
+            if (progressCallback != nullptr && !progressCallback(sqlite3_backup_remaining(state.get()), pageCount)) {
+                bCancelled = true;
+                break;
+            }
+
+            /* source locks are only held during a step, sleeping between steps lets writers through */
+            if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+                sqlite3_sleep(BusyRetryMilliseconds);
+            } else if (rc == SQLITE_OK && sleepMilliseconds > 0) {
+                sqlite3_sleep(sleepMilliseconds);
+            }
+        } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+
+        rc = sqlite3_backup_finish(state.release());
     } catch (const sqlite::sqlite_exception& e) {
         pLogger->error("Error occured when running database backup - {0:d} : {1}", e.get_code(), e.what());
         return false;
     }
+
+    if (bCancelled) {
+        pLogger->info("Database backup to {0} cancelled", fileName.ToStdString());
+        return false;
+    }
+
+    if (rc != SQLITE_OK) {
+        pLogger->error("Error occured when running database backup - {0:d} : {1}", rc, sqlite3_errstr(rc));
+        return false;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Database backup to {0} completed : {1:d} pages in {2:d} steps, {3:d}ms",
+        fileName.ToStdString(),
+        pageCount,
+        steps,
+        elapsed.count());
     return true;
 }
 } // namespace app::svc
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include <spdlog/spdlog.h>
@@ -30,6 +31,9 @@
 
 namespace app::svc
 {
+/* called after every backup step with the pages left to copy and the total, return false to cancel */
+using BackupProgressCallback = std::function<bool(int remaining, int pageCount)>;
+
 class DatabaseBackup final
 {
 public:
@@ -37,15 +41,34 @@ class DatabaseBackup final
     DatabaseBackup(std::shared_ptr<spdlog::logger> logger);
     ~DatabaseBackup();
 
+    /* copies the whole database in a single step */
     bool Execute();
+    /*
+     copies pagesPerStep pages at a time and sleeps between steps so other connections
+     can write to the database while the backup is running
+     */
+    bool Execute(int pagesPerStep, int sleepMilliseconds, BackupProgressCallback progressCallback);
+
+    bool IsCancelled() const;
+
+    static const int DefaultPagesPerStep;
+    static const int DefaultStepSleepMilliseconds;
 
 private:
+    bool CreateBackup(int pagesPerStep, int sleepMilliseconds, BackupProgressCallback progressCallback);
     wxString CreateBackupFileName();
     wxString GetBackupFullPath(const wxString& fileName);
-    bool CreateBackupFile(const wxString& fileName);
-    bool ExecuteBackup(const wxString& fileName);
+    wxString CreateTemporaryFile(const wxString& filePath);
+    bool ReplaceBackupFile(const wxString& temporaryFilePath, const wxString& backupFilePath);
+    bool ExecuteBackup(const wxString& fileName,
+        int pagesPerStep,
+        int sleepMilliseconds,
+        BackupProgressCallback progressCallback);
 
     std::shared_ptr<spdlog::logger> pLogger;
     std::shared_ptr<db::SqliteConnection> pConnection;
+    bool bCancelled;
+
+    static const int BusyRetryMilliseconds;
 };
 } // namespace app::svc
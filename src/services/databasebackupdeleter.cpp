@@ -19,65 +19,86 @@
 
 #include "databasebackupdeleter.h"
 
-#include <wx/dir.h>
+#include <wx/datetime.h>
+#include <wx/filefn.h>
 #include <wx/filename.h>
-#include <wx/regex.h>
 
-#include "../common/common.h"
+#include "backupchunkstore.h"
+#include "backupindex.h"
+#include "backupretention.h"
 
 namespace app::svc
 {
-bool DatabaseBackupDeleter::Execute()
+DatabaseBackupDeleter::DatabaseBackupDeleter(std::shared_ptr<spdlog::logger> logger)
+    : pLogger(logger)
 {
-    auto filesToDelete = GetFilesForDeletion();
-    if (filesToDelete.empty()) {
+}
+
+bool DatabaseBackupDeleter::Execute(bool dryRun)
+{
+    auto backupPath = cfg::ConfigurationProvider::Get().Configuration->GetBackupPath();
+    BackupIndex backupIndex(pLogger, backupPath);
+    if (!backupIndex.Load()) {
+        return false;
+    }
+
+    auto filesToDelete = GetFilesForDeletion(backupIndex, dryRun);
+    if (filesToDelete.empty() || dryRun) {
         return true;
     }
 
-    auto result = DeleteFilesAfterSpecifiedDate(filesToDelete);
+    auto result = DeleteFilesAfterSpecifiedDate(backupPath, filesToDelete);
+    if (!result) {
+        return false;
+    }
 
-    return result;
+    if (!backupIndex.Remove(filesToDelete)) {
+        return false;
+    }
+
+    /* chunks only referenced by the expired incremental backups can go now */
+    BackupChunkStore backupChunkStore(pLogger, backupPath);
+    return backupChunkStore.CollectGarbage();
 }
 
-wxArrayString DatabaseBackupDeleter::GetFilesForDeletion()
+const std::vector<BackupRetentionDecision>& DatabaseBackupDeleter::GetRetentionPlan() const
 {
-    auto backupPath = cfg::ConfigurationProvider::Get().Configuration->GetBackupPath();
-    auto deleteBackupsAfter = cfg::ConfigurationProvider::Get().Configuration->GetDeleteBackupsAfter();
-
-    wxArrayString backupPathFileNames;
-    wxDir::GetAllFiles(backupPath, &backupPathFileNames, wxEmptyString, wxDIR_FILES);
+    return mRetentionPlan;
+}
 
-    wxArrayString filesToDelete;
+wxArrayString DatabaseBackupDeleter::GetFilesForDeletion(const BackupIndex& backupIndex, bool dryRun)
+{
+    BackupRetentionPolicy policy{ cfg::ConfigurationProvider::Get().Configuration->GetDeleteBackupsAfter(),
+        cfg::ConfigurationProvider::Get().Configuration->GetKeepDailyBackups(),
+        cfg::ConfigurationProvider::Get().Configuration->GetKeepWeeklyBackups(),
+        cfg::ConfigurationProvider::Get().Configuration->GetKeepMonthlyBackups(),
+        cfg::ConfigurationProvider::Get().Configuration->GetKeepYearlyBackups() };
 
-    for (const auto& file : backupPathFileNames) {
-        wxRegEx dateRegex(wxT("([0-9]{4}-[0-9]{2}-[0-9]{2})"));
-        if (dateRegex.IsValid()) {
-            if (dateRegex.Matches(file)) {
-                wxFileName filename(file);
-                auto dateComponent = dateRegex.GetMatch(file, 0);
-                wxDateTime date;
-                if (!date.ParseDate(dateComponent)) {
-                    return wxArrayString();
-                }
-                const time_t OneDay = 24 * 60 * 60;
-                auto dateOffset = OneDay * deleteBackupsAfter;
-                auto dateNow = wxDateTime::Now().GetTicks();
-                auto olderDate = wxDateTime(dateNow - dateOffset);
+    BackupRetentionPlanner planner(policy);
+    mRetentionPlan = planner.Plan(backupIndex.GetEntries(), wxDateTime::Now().GetTicks());
 
-                if (date.IsEarlierThan(olderDate)) {
-                    filesToDelete.Add(file);
-                }
-            }
+    wxArrayString filesToDelete;
+    for (const auto& decision : mRetentionPlan) {
+        if (!decision.Keep) {
+            pLogger->info("Backup {0} {1} : {2}",
+                decision.FileName,
+                dryRun ? "would expire" : "expired",
+                decision.Reason);
+            filesToDelete.Add(decision.FileName);
         }
     }
 
     return filesToDelete;
 }
 
-bool DatabaseBackupDeleter::DeleteFilesAfterSpecifiedDate(const wxArrayString& filesToDelete)
+bool DatabaseBackupDeleter::DeleteFilesAfterSpecifiedDate(const wxString& backupPath,
+    const wxArrayString& filesToDelete)
 {
     for (const auto& file : filesToDelete) {
-        if (!wxRemoveFile(file)) {
+        auto filePath = wxFileName(backupPath, file).GetFullPath();
+        /* a backup removed by hand is only dropped from the index */
+        if (wxFileExists(filePath) && !wxRemoveFile(filePath)) {
+            pLogger->error("Failed to remove backup {0}", filePath.ToStdString());
             return false;
         }
     }
@@ -20,24 +20,35 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
+#include <spdlog/spdlog.h>
 #include <wx/arrstr.h>
 #include <wx/string.h>
 
 #include "../config/configurationprovider.h"
+#include "backupindex.h"
+#include "backupretention.h"
 
 namespace app::svc
 {
 class DatabaseBackupDeleter final
 {
 public:
-    DatabaseBackupDeleter() = default;
+    DatabaseBackupDeleter() = delete;
+    DatabaseBackupDeleter(std::shared_ptr<spdlog::logger> logger);
     ~DatabaseBackupDeleter() = default;
 
-    bool Execute();
+    /* a dry run only computes the retention plan, nothing is deleted */
+    bool Execute(bool dryRun = false);
+
+    const std::vector<BackupRetentionDecision>& GetRetentionPlan() const;
 
 private:
-    wxArrayString GetFilesForDeletion();
-    bool DeleteFilesAfterSpecifiedDate(const wxArrayString& filesToDelete);
+    wxArrayString GetFilesForDeletion(const BackupIndex& backupIndex, bool dryRun);
+    bool DeleteFilesAfterSpecifiedDate(const wxString& backupPath, const wxArrayString& filesToDelete);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::vector<BackupRetentionDecision> mRetentionPlan;
 };
 } // namespace app::svc
@@ -0,0 +1,150 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "databasemaintenance.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+namespace app::svc
+{
+const int DatabaseMaintenance::AnalyzeChangeThreshold = 10;
+const int DatabaseMaintenance::IncrementalAutoVacuum = 2;
+const std::int64_t DatabaseMaintenance::AutoVacuumConversionSizeLimit = 256 * 1024 * 1024;
+
+DatabaseMaintenance::DatabaseMaintenance(std::shared_ptr<spdlog::logger> logger)
+    : pLogger(logger)
+    , mReport{ 0, 0, 0, 0, false }
+{
+    pConnection = db::ConnectionProvider::Get().Handle()->Acquire();
+}
+
+DatabaseMaintenance::~DatabaseMaintenance()
+{
+    db::ConnectionProvider::Get().Handle()->Release(pConnection);
+}
+
+bool DatabaseMaintenance::Execute()
+{
+    auto start = std::chrono::steady_clock::now();
+    mReport = { 0, 0, 0, 0, false };
+    if (!ReadFileStatistics(mReport.FileSizeBefore, mReport.FreePagesBefore)) {
+        return false;
+    }
+
+    try {
+        auto databaseHandle = pConnection->DatabaseExecutableHandle();
+
+        if (IsAnalyzeDue()) {
+            *databaseHandle << "ANALYZE;";
+            mReport.Analyzed = true;
+        }
+        *databaseHandle << "PRAGMA optimize;";
+
+        int autoVacuum = 0;
+        *databaseHandle << "PRAGMA auto_vacuum;" >> autoVacuum;
+        if (autoVacuum != IncrementalAutoVacuum && mReport.FileSizeBefore > AutoVacuumConversionSizeLimit) {
+            /* the VACUUM rewrites the whole file while the application is closing, too slow for this size */
+            pLogger->warn("Database is {0:d} bytes, above {1:d}, not switching it to incremental auto_vacuum",
+                mReport.FileSizeBefore,
+                AutoVacuumConversionSizeLimit);
+        } else if (autoVacuum != IncrementalAutoVacuum) {
+            /* databases created before auto_vacuum was set in create-taskable.sql, changing it on an
+               existing database only takes effect after a full VACUUM (which cannot run in a transaction
+               and so is not part of the migrations). Runs once, on the first shutdown after upgrading */
+            auto vacuumStart = std::chrono::steady_clock::now();
+            *databaseHandle << "PRAGMA auto_vacuum = INCREMENTAL;";
+            *databaseHandle << "VACUUM;";
+            auto vacuumElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - vacuumStart);
+            pLogger->info("Switched database of {0:d} bytes to incremental auto_vacuum in {1:d}ms",
+                mReport.FileSizeBefore,
+                vacuumElapsed.count());
+        } else if (mReport.FreePagesBefore > 0) {
+            *databaseHandle << "PRAGMA incremental_vacuum;";
+        }
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured when running database maintenance - {0:d} : {1}", e.get_code(), e.what());
+        return false;
+    }
+
+    if (!ReadFileStatistics(mReport.FileSizeAfter, mReport.FreePagesAfter)) {
+        return false;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Database maintenance completed{0} : size {1:d} -> {2:d} bytes, "
+                  "free pages {3:d} -> {4:d}, {5:d}ms",
+        mReport.Analyzed ? " with ANALYZE" : "",
+        mReport.FileSizeBefore,
+        mReport.FileSizeAfter,
+        mReport.FreePagesBefore,
+        mReport.FreePagesAfter,
+        elapsed.count());
+    return true;
+}
+
+const DatabaseMaintenanceReport& DatabaseMaintenance::GetReport() const
+{
+    return mReport;
+}
+
+bool DatabaseMaintenance::IsAnalyzeDue()
+{
+    auto databaseHandle = pConnection->DatabaseExecutableHandle();
+
+    int statisticsTables = 0;
+    *databaseHandle << "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'sqlite_stat1';" >>
+        statisticsTables;
+    if (statisticsTables == 0) {
+        return true;
+    }
+
+    /* the first number of a table's stat column is the row count at the time of the last ANALYZE */
+    std::string statistics;
+    *databaseHandle << "SELECT IFNULL(MAX(stat), '') FROM sqlite_stat1 WHERE tbl = 'task_items';" >> statistics;
+    if (statistics.empty()) {
+        return true;
+    }
+
+    std::int64_t analyzedRows = std::atoll(statistics.c_str());
+    std::int64_t rows = 0;
+    *databaseHandle << "SELECT COUNT(*) FROM task_items;" >> rows;
+    return std::llabs(rows - analyzedRows) * 100 > analyzedRows * AnalyzeChangeThreshold;
+}
+
+bool DatabaseMaintenance::ReadFileStatistics(std::int64_t& fileSize, std::int64_t& freePages)
+{
+    std::int64_t pageCount = 0;
+    std::int64_t pageSize = 0;
+    try {
+        auto databaseHandle = pConnection->DatabaseExecutableHandle();
+        *databaseHandle << "PRAGMA page_count;" >> pageCount;
+        *databaseHandle << "PRAGMA page_size;" >> pageSize;
+        *databaseHandle << "PRAGMA freelist_count;" >> freePages;
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured when reading database statistics - {0:d} : {1}", e.get_code(), e.what());
+        return false;
+    }
+
+    fileSize = pageCount * pageSize;
+    return true;
+}
+} // namespace app::svc
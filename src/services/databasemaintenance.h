@@ -0,0 +1,71 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <spdlog/spdlog.h>
+
+#include "../database/connectionprovider.h"
+#include "../database/sqliteconnection.h"
+
+namespace app::svc
+{
+struct DatabaseMaintenanceReport {
+    std::int64_t FileSizeBefore;
+    std::int64_t FileSizeAfter;
+    std::int64_t FreePagesBefore;
+    std::int64_t FreePagesAfter;
+    bool Analyzed;
+};
+
+/*
+ Keeps the database compact and the query planner informed. Every run does PRAGMA optimize,
+ a full ANALYZE when there are no statistics yet or task_items grew or shrank by more than
+ AnalyzeChangeThreshold percent since the last one, and returns free pages to the file system
+ with PRAGMA incremental_vacuum. Databases that are not INCREMENTAL yet are converted with a
+ one-off VACUUM on their first run, which rewrites the whole file and so is skipped for databases
+ above AutoVacuumConversionSizeLimit bytes.
+ */
+class DatabaseMaintenance final
+{
+public:
+    DatabaseMaintenance() = delete;
+    DatabaseMaintenance(std::shared_ptr<spdlog::logger> logger);
+    ~DatabaseMaintenance();
+
+    bool Execute();
+
+    const DatabaseMaintenanceReport& GetReport() const;
+
+    static const int AnalyzeChangeThreshold;
+    static const int IncrementalAutoVacuum;
+    static const std::int64_t AutoVacuumConversionSizeLimit;
+
+private:
+    bool IsAnalyzeDue();
+    bool ReadFileStatistics(std::int64_t& fileSize, std::int64_t& freePages);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::shared_ptr<db::SqliteConnection> pConnection;
+    DatabaseMaintenanceReport mReport;
+};
+} // namespace app::svc
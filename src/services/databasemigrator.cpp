@@ -17,64 +17,115 @@
 //  Contact:
 //    szymonwelgus at gmail dot com
 
-#include "databasestructureupdater.h"
+#include "databasemigrator.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
-#include <vector>
+
+#include "../common/tracer.h"
 
 namespace app::svc
 {
-DatabaseStructureUpdater::DatabaseStructureUpdater(std::shared_ptr<spdlog::logger> logger)
+const int DatabaseMigrator::LatestVersion = 3;
+
+DatabaseMigrator::DatabaseMigrator(std::shared_ptr<spdlog::logger> logger)
     : pLogger(logger)
 {
     pConnection = db::ConnectionProvider::Get().Handle()->Acquire();
-}
 
-DatabaseStructureUpdater::~DatabaseStructureUpdater()
-{
-    db::ConnectionProvider::Get().Handle()->Release(pConnection);
+    /* ordered by version, never renumber or remove a migration that has shipped */
+    mMigrations = {
+        { 1, "DropProjectsHoursColumn", [this]() { DropProjectsHoursColumn(); } },
+        { 2, "CreateMeetingsTable", [this]() { CreateMeetingsTable(); } },
+        { 3, "AddMeetingForeignKeyToTaskItemsTable", [this]() { AddMeetingForeignKeyToTaskItemsTable(); } },
+    };
 }
 
-bool DatabaseStructureUpdater::ExecuteScripts()
+DatabaseMigrator::~DatabaseMigrator()
 {
-    bool projectsHoursColumnDropped = DropProjectsHoursColumn();
-    bool meetingsTableCreated = CreateMeetingsTableScript();
-    bool meetingForeignKeyAdded = AddMeetingForeignKeyToTaskItemsTable();
-
-    return projectsHoursColumnDropped && meetingsTableCreated && meetingForeignKeyAdded;
+    db::ConnectionProvider::Get().Handle()->Release(pConnection);
 }
 
-bool DatabaseStructureUpdater::DropProjectsHoursColumn()
+bool DatabaseMigrator::Execute()
 {
-    const std::string DropProjectsHourColumnOperationName = "DropProjectsHourColumn";
+    common::TraceSpan traceSpan("DatabaseMigrator::Execute");
 
-    const std::string ProjectsHourColumnName = "hours";
+    int version = 0;
+    if (!ReadVersion(version)) {
+        return false;
+    }
 
-    const std::string PragmaInfoTable = "pragma table_info(projects);";
+    if (version >= LatestVersion) {
+        pLogger->info("Database schema is current at version {0:d}", version);
+        return true;
+    }
 
-    std::vector<std::string> columnNames;
+    auto start = std::chrono::steady_clock::now();
+    auto databaseHandle = pConnection->DatabaseExecutableHandle();
+    std::string migrationName;
     try {
-        *pConnection->DatabaseExecutableHandle() << PragmaInfoTable >> [&](int64_t cid,
-                                                                           std::string name,
-                                                                           std::string type,
-                                                                           int notnull,
-                                                                           std::unique_ptr<std::string> dlft_value,
-                                                                           int pk) { columnNames.push_back(name); };
+        *databaseHandle << "BEGIN IMMEDIATE;";
+
+        for (const auto& migration : mMigrations) {
+            if (migration.Version <= version) {
+                continue;
+            }
+
+            migrationName = migration.Name;
+            auto migrationStart = std::chrono::steady_clock::now();
+            migration.Apply();
+            auto migrationElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - migrationStart);
+            pLogger->info("Applied database migration {0:d} {1} in {2:d}ms",
+                migration.Version,
+                migration.Name,
+                migrationElapsed.count());
+        }
+
+        migrationName.clear();
+        *databaseHandle << "PRAGMA user_version = " + std::to_string(LatestVersion) + ";";
+        *databaseHandle << "COMMIT;";
     } catch (const sqlite::sqlite_exception& e) {
-        pLogger->error("Error in database structure update operation {0} | {1:d} : {2}",
-            DropProjectsHourColumnOperationName,
+        pLogger->error("Error in database migration {0} | {1:d} : {2}",
+            migrationName.empty() ? "BEGIN/COMMIT" : migrationName,
             e.get_code(),
             e.what());
+        try {
+            *databaseHandle << "ROLLBACK;";
+        } catch (const sqlite::sqlite_exception&) {
+            /* nothing to roll back when the transaction could not be started */
+        }
         return false;
     }
 
-    auto hoursColumnExistsIterator = std::find_if_not(columnNames.begin(),
-        columnNames.end(),
-        [=](const std::string& columnName) { return columnName != ProjectsHourColumnName; });
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    pLogger->info("Migrated database schema from version {0:d} to {1:d} in {2:d}ms",
+        version,
+        LatestVersion,
+        elapsed.count());
+    return true;
+}
 
-    if (hoursColumnExistsIterator == columnNames.end()) {
-        return true;
+bool DatabaseMigrator::ReadVersion(int& version)
+{
+    try {
+        *pConnection->DatabaseExecutableHandle() << "PRAGMA user_version;" >> version;
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured when reading database schema version - {0:d} : {1}", e.get_code(), e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void DatabaseMigrator::DropProjectsHoursColumn()
+{
+    const std::string ProjectsHourColumnName = "hours";
+
+    auto columnNames = GetColumnNames("projects");
+    if (std::find(columnNames.begin(), columnNames.end(), ProjectsHourColumnName) == columnNames.end()) {
+        return;
     }
 
     const std::string CreateTempTable = "CREATE TABLE temp_projects_table "
@@ -95,7 +146,7 @@ bool DatabaseStructureUpdater::DropProjectsHoursColumn()
                                         "FOREIGN KEY(employer_id) REFERENCES employers(employer_id), "
                                         "FOREIGN KEY(client_id) REFERENCES clients(client_id), "
                                         "FOREIGN KEY(rate_type_id) REFERENCES rate_types(rate_type_id), "
-                                        "FOREIGN KEY(currency_id) REFERENCES currencies(currency_id)) "
+                                        "FOREIGN KEY(currency_id) REFERENCES currencies(currency_id)"
                                         ")";
 
     const std::string CopyOldDataToTempTable = "INSERT INTO temp_projects_table "
@@ -115,33 +166,16 @@ bool DatabaseStructureUpdater::DropProjectsHoursColumn()
                                                "FROM projects";
     const std::string DropOldTable = "DROP TABLE projects;";
 
-    const std::string RenameTempTableToTaskItemsTable = "ALTER TABLE temp_projects_table RENAME TO projects";
-
-    try {
-        *pConnection->DatabaseExecutableHandle() << "BEGIN";
-
-        *pConnection->DatabaseExecutableHandle() << CreateTempTable;
-        *pConnection->DatabaseExecutableHandle() << CopyOldDataToTempTable;
-        *pConnection->DatabaseExecutableHandle() << DropOldTable;
-        *pConnection->DatabaseExecutableHandle() << RenameTempTableToTaskItemsTable;
+    const std::string RenameTempTableToProjectsTable = "ALTER TABLE temp_projects_table RENAME TO projects";
 
-        *pConnection->DatabaseExecutableHandle() << "COMMIT";
-    } catch (const sqlite::sqlite_exception& e) {
-        *pConnection->DatabaseExecutableHandle() << "ROLLBACK";
-        pLogger->error("Error in database structure update operation {0} | {1:d} : {2}",
-            DropProjectsHourColumnOperationName,
-            e.get_code(),
-            e.what());
-        return false;
-    }
-
-    return true;
+    *pConnection->DatabaseExecutableHandle() << CreateTempTable;
+    *pConnection->DatabaseExecutableHandle() << CopyOldDataToTempTable;
+    *pConnection->DatabaseExecutableHandle() << DropOldTable;
+    *pConnection->DatabaseExecutableHandle() << RenameTempTableToProjectsTable;
 }
 
-bool DatabaseStructureUpdater::CreateMeetingsTableScript()
+void DatabaseMigrator::CreateMeetingsTable()
 {
-    const std::string CreateMeetingsTableOperationName = "CreateMeetingsTableScript";
-
     const std::string CreateMeetingsTable =
         "CREATE TABLE IF NOT EXISTS meetings "
         "( "
@@ -160,48 +194,16 @@ bool DatabaseStructureUpdater::CreateMeetingsTableScript()
         "FOREIGN KEY(task_id) REFERENCES tasks(task_id)"
         ");";
 
-    try {
-        *pConnection->DatabaseExecutableHandle() << CreateMeetingsTable;
-    } catch (const sqlite::sqlite_exception& e) {
-        pLogger->error("Error in database structure update operation {0} | {1:d} : {2}",
-            CreateMeetingsTableOperationName,
-            e.get_code(),
-            e.what());
-        return false;
-    }
-
-    return true;
+    *pConnection->DatabaseExecutableHandle() << CreateMeetingsTable;
 }
 
-bool DatabaseStructureUpdater::AddMeetingForeignKeyToTaskItemsTable()
+void DatabaseMigrator::AddMeetingForeignKeyToTaskItemsTable()
 {
-    const std::string AddMeetingForeignKeyToTaskItemsTableOperationName = "AddMeetingForeignKeyToTaskItemsTable";
     const std::string MeetingForeignKeyColumnName = "meeting_id";
 
-    const std::string PragmaInfoTable = "pragma table_info(task_items);";
-
-    std::vector<std::string> columnNames;
-    try {
-        *pConnection->DatabaseExecutableHandle() << PragmaInfoTable >> [&](int64_t cid,
-                                                                           std::string name,
-                                                                           std::string type,
-                                                                           int notnull,
-                                                                           std::unique_ptr<std::string> dlft_value,
-                                                                           int pk) { columnNames.push_back(name); };
-    } catch (const sqlite::sqlite_exception& e) {
-        pLogger->error("Error in database structure update operation {0} | {1:d} : {2}",
-            AddMeetingForeignKeyToTaskItemsTableOperationName,
-            e.get_code(),
-            e.what());
-        return false;
-    }
-
-    auto meetingForeignKeyExistsIterator = std::find_if_not(columnNames.begin(),
-        columnNames.end(),
-        [=](const std::string& columnName) { return columnName == MeetingForeignKeyColumnName; });
-
-    if (meetingForeignKeyExistsIterator == columnNames.end()) {
-        return true;
+    auto columnNames = GetColumnNames("task_items");
+    if (std::find(columnNames.begin(), columnNames.end(), MeetingForeignKeyColumnName) != columnNames.end()) {
+        return;
     }
 
     const std::string CreateTempTable =
@@ -250,23 +252,23 @@ bool DatabaseStructureUpdater::AddMeetingForeignKeyToTaskItemsTable()
 
     const std::string RenameTempTableToTaskItemsTable = "ALTER TABLE sqlb_temp_table_1 RENAME TO task_items";
 
-    try {
-        *pConnection->DatabaseExecutableHandle() << "BEGIN";
-
-        *pConnection->DatabaseExecutableHandle() << CreateTempTable;
-        *pConnection->DatabaseExecutableHandle() << CopyOldDataToTempTable;
-        *pConnection->DatabaseExecutableHandle() << DropOldTable;
-        *pConnection->DatabaseExecutableHandle() << RenameTempTableToTaskItemsTable;
+    *pConnection->DatabaseExecutableHandle() << CreateTempTable;
+    *pConnection->DatabaseExecutableHandle() << CopyOldDataToTempTable;
+    *pConnection->DatabaseExecutableHandle() << DropOldTable;
+    *pConnection->DatabaseExecutableHandle() << RenameTempTableToTaskItemsTable;
+}
 
-        *pConnection->DatabaseExecutableHandle() << "COMMIT";
-    } catch (const sqlite::sqlite_exception& e) {
-        *pConnection->DatabaseExecutableHandle() << "ROLLBACK";
-        pLogger->error("Error in database structure update operation {0} | {1:d} : {2}",
-            AddMeetingForeignKeyToTaskItemsTableOperationName,
-            e.get_code(),
-            e.what());
-        return false;
-    }
-    return true;
+std::vector<std::string> DatabaseMigrator::GetColumnNames(const std::string& tableName)
+{
+    std::vector<std::string> columnNames;
+    *pConnection->DatabaseExecutableHandle() << "pragma table_info(" + tableName + ");" >>
+        [&](int64_t cid,
+            std::string name,
+            std::string type,
+            int notnull,
+            std::unique_ptr<std::string> dlft_value,
+            int pk) { columnNames.push_back(name); };
+
+    return columnNames;
 }
 } // namespace app::svc
@@ -0,0 +1,74 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "../database/connectionprovider.h"
+#include "../database/sqliteconnection.h"
+
+namespace app::svc
+{
+struct DatabaseMigration {
+    int Version;
+    std::string Name;
+    std::function<void()> Apply;
+};
+
+/*
+ Brings an existing database up to the schema of create-taskable.sql. The schema version is kept in
+ PRAGMA user_version, the migrations after it are applied in order in a single transaction together
+ with the new version, so a failed migration leaves the database as it was. A database that is already
+ current is left alone after reading user_version once.
+
+ Migrations must be idempotent: databases created before user_version was used start at version 0
+ even if some of the changes were already made to them.
+ */
+class DatabaseMigrator final
+{
+public:
+    DatabaseMigrator() = delete;
+    DatabaseMigrator(std::shared_ptr<spdlog::logger> logger);
+    ~DatabaseMigrator();
+
+    bool Execute();
+
+    /* create-taskable.sql sets user_version to this, bump both when adding a migration */
+    static const int LatestVersion;
+
+private:
+    bool ReadVersion(int& version);
+
+    void DropProjectsHoursColumn();
+    void CreateMeetingsTable();
+    void AddMeetingForeignKeyToTaskItemsTable();
+
+    std::vector<std::string> GetColumnNames(const std::string& tableName);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::shared_ptr<db::SqliteConnection> pConnection;
+    std::vector<DatabaseMigration> mMigrations;
+};
+} // namespace app::svc
@@ -0,0 +1,194 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "databaserestore.h"
+
+#include <chrono>
+
+#include <sqlite_modern_cpp.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include "../database/connectionprovider.h"
+#include "../database/sqliteconnection.h"
+#include "backupverifier.h"
+#include "databasebackup.h"
+#include "databasemigrator.h"
+
+namespace app::svc
+{
+const std::string DatabaseRestore::RollbackFileExtension = ".rollback";
+const int DatabaseRestore::BusyRetryMilliseconds = 50;
+const int DatabaseRestore::MaxBusyRetries = 200;
+
+DatabaseRestore::DatabaseRestore(std::shared_ptr<spdlog::logger> logger, const wxString& databaseFilePath)
+    : pLogger(logger)
+    , mDatabaseFilePath(databaseFilePath)
+{
+}
+
+bool DatabaseRestore::Execute(const wxString& backupFilePath)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    wxFileName backupFileName(backupFilePath);
+    BackupVerifier backupVerifier(pLogger, backupFileName.GetPath(), wxGetEmptyString(), nullptr);
+    auto sourceFilePath = backupVerifier.ExtractBackup(backupFileName.GetFullName());
+    if (sourceFilePath.empty()) {
+        pLogger->error("Failed to extract backup {0}", backupFilePath.ToStdString());
+        return false;
+    }
+
+    /* a damaged backup must never replace a working database */
+    BackupVerification verification{ 0, true, false, "", {} };
+    bool success = backupVerifier.CheckDatabase(sourceFilePath, true, verification);
+    if (!success) {
+        pLogger->error("Backup {0} failed the integrity check : {1}",
+            backupFilePath.ToStdString(),
+            verification.Message);
+    } else if (wxFileExists(mDatabaseFilePath)) {
+        success = RestoreIntoConnectionPool(sourceFilePath);
+    } else {
+        success = RestoreIntoNewFile(sourceFilePath);
+    }
+
+    if (sourceFilePath != backupFilePath) {
+        wxRemoveFile(sourceFilePath);
+    }
+
+    if (success) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        pLogger->info("Restored database from {0} in {1:d}ms", backupFilePath.ToStdString(), elapsed.count());
+    }
+    return success;
+}
+
+wxString DatabaseRestore::GetRollbackFilePath(const wxString& databaseFilePath)
+{
+    return wxString::Format(wxT("%s%s"), databaseFilePath, RollbackFileExtension);
+}
+
+bool DatabaseRestore::RestoreIntoConnectionPool(const wxString& sourceFilePath)
+{
+    auto rollbackFilePath = GetRollbackFilePath(mDatabaseFilePath);
+    auto connection = db::ConnectionProvider::Get().Handle()->Acquire();
+    auto liveDatabase = connection->DatabaseExecutableHandle()->connection();
+
+    bool success = false;
+    bool keepRollbackFile = false;
+    try {
+        auto readWriteConfig = sqlite::sqlite_config{
+            sqlite::OpenFlags::READWRITE | sqlite::OpenFlags::CREATE, nullptr, sqlite::Encoding::UTF8
+        };
+        sqlite::database rollbackDatabase(rollbackFilePath.ToStdString(), readWriteConfig);
+        if (!CopyDatabase(liveDatabase.get(), rollbackDatabase.connection().get())) {
+            pLogger->error("Failed to create rollback point {0}", rollbackFilePath.ToStdString());
+        } else {
+            auto readOnlyConfig =
+                sqlite::sqlite_config{ sqlite::OpenFlags::READONLY, nullptr, sqlite::Encoding::UTF8 };
+            sqlite::database sourceDatabase(sourceFilePath.ToStdString(), readOnlyConfig);
+            success = CopyDatabase(sourceDatabase.connection().get(), liveDatabase.get());
+
+            /* a backup from before the latest migrations would leave the running application on an old schema */
+            if (success) {
+                DatabaseMigrator databaseMigrator(pLogger);
+                success = databaseMigrator.Execute();
+                if (!success) {
+                    pLogger->error("Failed to migrate the restored database to the current schema");
+                }
+            }
+
+            /* the live database may be half written, put the rollback point back */
+            if (!success && !CopyDatabase(rollbackDatabase.connection().get(), liveDatabase.get())) {
+                pLogger->critical("Rollback failed, the previous database is kept at {0}",
+                    rollbackFilePath.ToStdString());
+                keepRollbackFile = true;
+            }
+        }
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured when restoring database - {0:d} : {1}", e.get_code(), e.what());
+        success = false;
+    }
+
+    db::ConnectionProvider::Get().Handle()->Release(connection);
+    if (!keepRollbackFile) {
+        wxRemoveFile(rollbackFilePath);
+    }
+    return success;
+}
+
+bool DatabaseRestore::RestoreIntoNewFile(const wxString& sourceFilePath)
+{
+    /* copy next to the database so the final rename stays on one volume and is atomic */
+    auto temporaryFilePath = wxString::Format(wxT("%s.tmp"), mDatabaseFilePath);
+    if (!wxCopyFile(sourceFilePath, temporaryFilePath)) {
+        pLogger->error("Failed to copy {0} to {1}", sourceFilePath.ToStdString(), temporaryFilePath.ToStdString());
+        return false;
+    }
+
+    if (!wxRenameFile(temporaryFilePath, mDatabaseFilePath)) {
+        pLogger->error("Failed to rename {0} to {1}", temporaryFilePath.ToStdString(), mDatabaseFilePath.ToStdString());
+        wxRemoveFile(temporaryFilePath);
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseRestore::CopyDatabase(sqlite3* source, sqlite3* destination)
+{
+    auto state = std::unique_ptr<sqlite3_backup, decltype(&sqlite3_backup_finish)>(
+        sqlite3_backup_init(destination, "main", source, "main"), sqlite3_backup_finish);
+    if (!state) {
+        pLogger->error("Error occured when initializing database copy - {0:d} : {1}",
+            sqlite3_errcode(destination),
+            sqlite3_errmsg(destination));
+        return false;
+    }
+
+    int rc = SQLITE_OK;
+    int busyRetries = 0;
+    do {
+        rc = sqlite3_backup_step(state.get(), DatabaseBackup::DefaultPagesPerStep);
+        if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+            /* consecutive retries, a connection that never lets go fails the copy instead of hanging it */
+            if (++busyRetries > MaxBusyRetries) {
+                break;
+            }
+            sqlite3_sleep(BusyRetryMilliseconds);
+        } else {
+            busyRetries = 0;
+        }
+    } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+
+    /* finish reports SQLITE_OK after busy or locked steps, those are not errors of the copy itself */
+    int finishRc = sqlite3_backup_finish(state.release());
+    if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+        pLogger->error("Gave up copying database, it stayed busy for {0:d}ms - {1:d} : {2}",
+            MaxBusyRetries * BusyRetryMilliseconds,
+            rc,
+            sqlite3_errstr(rc));
+        return false;
+    }
+    if (finishRc != SQLITE_OK) {
+        pLogger->error("Error occured when copying database - {0:d} : {1}", finishRc, sqlite3_errstr(finishRc));
+        return false;
+    }
+    return true;
+}
+} // namespace app::svc
@@ -0,0 +1,65 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <spdlog/spdlog.h>
+#include <sqlite3.h>
+#include <wx/string.h>
+
+namespace app::svc
+{
+/*
+ Restores a backup into the live database. The backup is extracted if needed and must pass
+ PRAGMA integrity_check before anything is touched. When the database exists it is first
+ copied to a rollback file and then overwritten page by page with the SQLite backup API through
+ a pooled connection, so every connection in the pool stays open and simply sees the restored
+ data. The restored database is then migrated to the current schema. Any failure, including a
+ copy that stays busy for ten seconds or a failed migration, copies the rollback file back. Without
+ an existing database the backup is copied to a temporary file next to it and renamed into place,
+ the startup migration brings it up to date.
+ */
+class DatabaseRestore final
+{
+public:
+    DatabaseRestore() = delete;
+    DatabaseRestore(std::shared_ptr<spdlog::logger> logger, const wxString& databaseFilePath);
+    ~DatabaseRestore() = default;
+
+    bool Execute(const wxString& backupFilePath);
+
+    static wxString GetRollbackFilePath(const wxString& databaseFilePath);
+
+    static const std::string RollbackFileExtension;
+
+private:
+    bool RestoreIntoConnectionPool(const wxString& sourceFilePath);
+    bool RestoreIntoNewFile(const wxString& sourceFilePath);
+    bool CopyDatabase(sqlite3* source, sqlite3* destination);
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    wxString mDatabaseFilePath;
+
+    static const int BusyRetryMilliseconds;
+    static const int MaxBusyRetries;
+};
+} // namespace app::svc
@@ -0,0 +1,113 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "exportdatareader.h"
+
+#include <cstdlib>
+
+namespace app::svc
+{
+const std::string ExportDataReader::Query = "SELECT "
+                                            "  task_items.start_time "
+                                            ", task_items.end_time "
+                                            ", task_items.duration "
+                                            ", task_items.description "
+                                            ", task_items.calculated_rate "
+                                            ", task_item_types.name "
+                                            ", projects.name "
+                                            ", projects.billable "
+                                            ", projects.rate "
+                                            ", categories.name "
+                                            ", tasks.task_date "
+                                            "FROM task_items "
+                                            "INNER JOIN task_item_types "
+                                            "ON task_items.task_item_type_id = task_item_types.task_item_type_id "
+                                            "INNER JOIN projects "
+                                            "ON task_items.project_id = projects.project_id "
+                                            "INNER JOIN categories "
+                                            "ON task_items.category_id = categories.category_id "
+                                            "INNER JOIN tasks "
+                                            "ON task_items.task_id = tasks.task_id "
+                                            "WHERE tasks.task_date >= ? "
+                                            "AND tasks.task_date <= ? "
+                                            "AND task_items.is_active = 1";
+
+ExportDataReader::ExportDataReader(const std::string& fromDate, const std::string& toDate)
+    : mFromDate(fromDate)
+    , mToDate(toDate)
+{
+    pConnection = db::ConnectionProvider::Get().Handle()->Acquire();
+}
+
+ExportDataReader::~ExportDataReader()
+{
+    db::ConnectionProvider::Get().Handle()->Release(pConnection);
+}
+
+void ExportDataReader::Read(const std::function<void(const ExportRow&)>& onRow)
+{
+    /* the callback receives fresh values for every row, they are moved into the one row handed to onRow */
+    ExportRow row;
+
+    *pConnection->DatabaseExecutableHandle() << ExportDataReader::Query << mFromDate << mToDate >>
+        [&](std::unique_ptr<std::string> taskItemsStartTime,
+            std::unique_ptr<std::string> taskItemsEndTime,
+            std::string taskItemsDuration,
+            std::string taskItemsDescription,
+            std::unique_ptr<double> taskItemsCalculatedRate,
+            std::string taskItemTypesName,
+            std::string projectsName,
+            bool projectsBillable,
+            std::unique_ptr<double> projectsRate,
+            std::string categoriesName,
+            std::string tasksDate) {
+            row.StartTime = std::move(taskItemsStartTime);
+            row.EndTime = std::move(taskItemsEndTime);
+            row.Duration = std::move(taskItemsDuration);
+            row.Description = std::move(taskItemsDescription);
+            row.CalculatedRate = std::move(taskItemsCalculatedRate);
+            row.TaskItemType = std::move(taskItemTypesName);
+            row.ProjectName = std::move(projectsName);
+            row.Billable = projectsBillable;
+            row.Rate = std::move(projectsRate);
+            row.CategoryName = std::move(categoriesName);
+            row.TaskDate = std::move(tasksDate);
+
+            onRow(row);
+        };
+}
+
+/* Durations (and start/end times) are stored as 'HH:MM:SS' strings */
+int DurationToSeconds(const std::string& duration)
+{
+    int seconds = 0;
+    const char* cursor = duration.c_str();
+    for (int part = 0; part < 3 && *cursor != '\0'; part++) {
+        char* end = nullptr;
+        long value = std::strtol(cursor, &end, 10);
+        if (end == cursor) {
+            break;
+        }
+
+        seconds = seconds * 60 + static_cast<int>(value);
+        cursor = *end == ':' ? end + 1 : end;
+    }
+    return seconds;
+}
+} // namespace app::svc
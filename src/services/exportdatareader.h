@@ -0,0 +1,68 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "../database/connectionprovider.h"
+#include "../database/sqliteconnection.h"
+
+namespace app::svc
+{
+struct ExportRow {
+    std::unique_ptr<std::string> StartTime;
+    std::unique_ptr<std::string> EndTime;
+    std::string Duration;
+    std::string Description;
+    std::unique_ptr<double> CalculatedRate;
+    std::string TaskItemType;
+    std::string ProjectName;
+    bool Billable;
+    std::unique_ptr<double> Rate;
+    std::string CategoryName;
+    std::string TaskDate;
+};
+
+/*
+ Runs the export query and hands each row to the callback as it is read from the database so
+ exporters can write rows out without holding the whole result set in memory.
+ The row passed to the callback is only valid for the duration of the call.
+ */
+class ExportDataReader final
+{
+public:
+    ExportDataReader() = delete;
+    ExportDataReader(const std::string& fromDate, const std::string& toDate);
+    ~ExportDataReader();
+
+    void Read(const std::function<void(const ExportRow&)>& onRow);
+
+private:
+    std::shared_ptr<db::SqliteConnection> pConnection;
+    std::string mFromDate;
+    std::string mToDate;
+
+    static const std::string Query;
+};
+
+int DurationToSeconds(const std::string& duration);
+} // namespace app::svc
@@ -0,0 +1,136 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "exporter.h"
+
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+
+#include <wx/filename.h>
+
+#include "../common/metrics.h"
+#include "../common/perflog.h"
+#include "../config/configurationprovider.h"
+
+#include "csvexporter.h"
+#include "jsonlinesexporter.h"
+#include "columnarexporter.h"
+
+namespace app::svc
+{
+namespace
+{
+/* Records how long an export took and how much it wrote to the metrics and the perf log */
+class InstrumentedExporter final : public IExporter
+{
+public:
+    InstrumentedExporter(std::unique_ptr<IExporter> exporter, std::string format, std::string fileName)
+        : pExporter(std::move(exporter))
+        , mFormat(std::move(format))
+        , mFileName(std::move(fileName))
+    {
+    }
+
+    bool ExportData() override
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        bool success = pExporter->ExportData();
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+
+        std::error_code ec;
+        auto bytes = std::filesystem::file_size(GetExportFilePath(mFileName), ec);
+        if (ec) {
+            bytes = 0;
+        }
+
+        auto microseconds = static_cast<std::uint64_t>(duration.count() * 1000.0);
+        common::MetricsRegistry::Get().GetHistogram(common::MetricNames::ExportPrefix + mFormat).Record(microseconds);
+        common::MetricsRegistry::Get().GetCounter(common::MetricNames::ExportBytes).Increment(bytes);
+        common::PerfLog::Get().RecordExport(mFormat, bytes, duration.count(), success);
+
+        return success;
+    }
+
+private:
+    std::unique_ptr<IExporter> pExporter;
+    std::string mFormat;
+    std::string mFileName;
+};
+
+std::unique_ptr<IExporter> CreateFormatExporter(constants::ExportFormats format,
+    std::shared_ptr<spdlog::logger> logger,
+    const std::string& fromDate,
+    const std::string& toDate,
+    const std::string& fileName)
+{
+    switch (format) {
+    case constants::ExportFormats::Csv:
+        return std::make_unique<CsvExporter>(logger, fromDate, toDate, fileName);
+    case constants::ExportFormats::JsonLines:
+        return std::make_unique<JsonLinesExporter>(logger, fromDate, toDate, fileName);
+    case constants::ExportFormats::Columnar:
+        return std::make_unique<ColumnarExporter>(logger, fromDate, toDate, fileName);
+    default:
+        return nullptr;
+    }
+}
+} // namespace
+
+std::unique_ptr<IExporter> CreateExporter(constants::ExportFormats format,
+    std::shared_ptr<spdlog::logger> logger,
+    const std::string& fromDate,
+    const std::string& toDate,
+    const std::string& fileName)
+{
+    auto exporter = CreateFormatExporter(format, logger, fromDate, toDate, fileName);
+    if (exporter == nullptr) {
+        return exporter;
+    }
+
+    /* the extension names the format in the metrics and the perf log, e.g. "csv" */
+    return std::make_unique<InstrumentedExporter>(
+        std::move(exporter), GetExportFileExtension(format).substr(1), fileName);
+}
+
+std::string GetExportFileExtension(constants::ExportFormats format)
+{
+    switch (format) {
+    case constants::ExportFormats::Csv:
+        return ".csv";
+    case constants::ExportFormats::JsonLines:
+        return ".ndjson";
+    case constants::ExportFormats::Columnar:
+        return ".tskc";
+    default:
+        return "";
+    }
+}
+
+std::string GetExportFilePath(const std::string& fileName)
+{
+    /* Absolute paths (e.g. from the command line tool) are used as is */
+    wxFileName exportFile(fileName);
+    if (!exportFile.IsAbsolute()) {
+        exportFile.MakeAbsolute(cfg::ConfigurationProvider::Get().Configuration->GetExportPath());
+    }
+
+    return exportFile.GetFullPath().ToStdString();
+}
+} // namespace app::svc
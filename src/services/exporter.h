@@ -24,25 +24,26 @@
 
 #include <spdlog/spdlog.h>
 
-#include "../database/connectionprovider.h"
-#include "../database/sqliteconnection.h"
+#include "../common/constants.h"
 
 namespace app::svc
 {
-class DatabaseStructureUpdater final
+class IExporter
 {
 public:
-    DatabaseStructureUpdater(std::shared_ptr<spdlog::logger> logger);
-    ~DatabaseStructureUpdater();
+    IExporter() = default;
+    virtual ~IExporter() = default;
 
-    bool ExecuteScripts();
+    virtual bool ExportData() = 0;
+};
 
-private:
-    bool DropProjectsHoursColumn();
-    bool CreateMeetingsTableScript();
-    bool AddMeetingForeignKeyToTaskItemsTable();
+std::unique_ptr<IExporter> CreateExporter(constants::ExportFormats format,
+    std::shared_ptr<spdlog::logger> logger,
+    const std::string& fromDate,
+    const std::string& toDate,
+    const std::string& fileName);
 
-    std::shared_ptr<spdlog::logger> pLogger;
-    std::shared_ptr<db::SqliteConnection> pConnection;
-};
+std::string GetExportFileExtension(constants::ExportFormats format);
+
+std::string GetExportFilePath(const std::string& fileName);
 } // namespace app::svc
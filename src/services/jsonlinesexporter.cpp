@@ -0,0 +1,105 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "jsonlinesexporter.h"
+
+#include <fstream>
+
+#include <sqlite_modern_cpp/errors.h>
+
+#include "../common/jsonlinewriter.h"
+
+#include "exportdatareader.h"
+
+namespace app::svc
+{
+namespace
+{
+void WriteOptional(common::JsonLineWriter& writer, const char* name, const std::unique_ptr<std::string>& value)
+{
+    if (value) {
+        writer.WriteString(name, *value);
+    } else {
+        writer.WriteNull(name);
+    }
+}
+
+void WriteOptional(common::JsonLineWriter& writer, const char* name, const std::unique_ptr<double>& value)
+{
+    if (value) {
+        writer.WriteNumber(name, *value);
+    } else {
+        writer.WriteNull(name);
+    }
+}
+} // namespace
+
+JsonLinesExporter::JsonLinesExporter(std::shared_ptr<spdlog::logger> logger,
+    const std::string& fromDate,
+    const std::string& toDate,
+    const std::string& fileName)
+    : pLogger(logger)
+    , mFromDate(fromDate)
+    , mToDate(toDate)
+    , mFileName(fileName)
+{
+}
+
+bool JsonLinesExporter::ExportData()
+{
+    std::string fullFilePath = GetExportFilePath(mFileName);
+
+    std::ofstream jsonFile(fullFilePath, std::ios_base::out | std::ios_base::binary);
+    if (!jsonFile) {
+        pLogger->error("Error when trying to create a JSON Lines file at specified location {0}", fullFilePath);
+        return false;
+    }
+
+    try {
+        ExportDataReader reader(mFromDate, mToDate);
+        /* reused for every row, the fields are written straight into it in a fixed order */
+        common::JsonLineWriter writer;
+        reader.Read([&](const ExportRow& dataSet) {
+            writer.Begin();
+            writer.WriteString("date", dataSet.TaskDate);
+            WriteOptional(writer, "startTime", dataSet.StartTime);
+            WriteOptional(writer, "endTime", dataSet.EndTime);
+            writer.WriteInteger("durationSeconds", DurationToSeconds(dataSet.Duration));
+            writer.WriteString("description", dataSet.Description);
+            WriteOptional(writer, "calculatedRate", dataSet.CalculatedRate);
+            writer.WriteString("taskItemType", dataSet.TaskItemType);
+            writer.WriteString("project", dataSet.ProjectName);
+            writer.WriteBool("billable", dataSet.Billable);
+            WriteOptional(writer, "projectRate", dataSet.Rate);
+            writer.WriteString("category", dataSet.CategoryName);
+
+            const auto& line = writer.End();
+            jsonFile.write(line.data(), static_cast<std::streamsize>(line.size()));
+            jsonFile.put('\n');
+        });
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured in JsonLinesExporter::ExportData - {0:d} : {1}", e.get_code(), e.what());
+        return false;
+    }
+
+    jsonFile.close();
+
+    return !jsonFile.fail();
+}
+} // namespace app::svc
@@ -0,0 +1,52 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "exporter.h"
+
+namespace app::svc
+{
+/*
+ Writes one JSON object per line (NDJSON). Each row is escaped straight into a reused line buffer by
+ common::JsonLineWriter and written as soon as it is read, no JSON document is built for it.
+ */
+class JsonLinesExporter final : public IExporter
+{
+public:
+    JsonLinesExporter(std::shared_ptr<spdlog::logger> logger,
+        const std::string& fromDate,
+        const std::string& toDate,
+        const std::string& fileName);
+    virtual ~JsonLinesExporter() = default;
+
+    bool ExportData() override;
+
+private:
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::string mFromDate;
+    std::string mToDate;
+    std::string mFileName;
+};
+} // namespace app::svc
@@ -0,0 +1,289 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#include "reportservice.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <sqlite_modern_cpp/errors.h>
+
+#include "csvwriter.h"
+
+namespace app::svc
+{
+namespace
+{
+/*
+ Grouping keys are integers or short ISO strings so SQLite can group cheaply, the display label
+ is only evaluated once per group. Weeks are keyed on the Monday-based julian week number and
+ labelled with the ISO 8601 week (the week's Thursday decides the year).
+ */
+struct GroupingColumns {
+    std::string Key;
+    std::string Label;
+    std::string Order;
+    std::vector<std::string> Joins;
+};
+
+const std::string JoinProjects = "INNER JOIN projects ON task_items.project_id = projects.project_id ";
+const std::string JoinClients = "LEFT JOIN clients ON projects.client_id = clients.client_id ";
+const std::string JoinEmployers = "INNER JOIN employers ON projects.employer_id = employers.employer_id ";
+const std::string JoinCategories = "INNER JOIN categories ON task_items.category_id = categories.category_id ";
+const std::string JoinTaskItemTypes =
+    "INNER JOIN task_item_types ON task_items.task_item_type_id = task_item_types.task_item_type_id ";
+
+const std::string IsoWeekThursday = "date(MIN(tasks.task_date), '-3 days', 'weekday 4')";
+
+GroupingColumns GetGroupingColumns(constants::ReportGroupings grouping)
+{
+    switch (grouping) {
+    case constants::ReportGroupings::Project:
+        return { "task_items.project_id",
+            "projects.display_name",
+            "projects.display_name COLLATE NOCASE",
+            { JoinProjects } };
+    case constants::ReportGroupings::Client:
+        return { "projects.client_id",
+            "COALESCE(clients.name, '(No client)')",
+            "clients.name COLLATE NOCASE",
+            { JoinProjects, JoinClients } };
+    case constants::ReportGroupings::Employer:
+        return { "projects.employer_id",
+            "employers.name",
+            "employers.name COLLATE NOCASE",
+            { JoinProjects, JoinEmployers } };
+    case constants::ReportGroupings::Category:
+        return { "task_items.category_id",
+            "categories.name",
+            "categories.name COLLATE NOCASE",
+            { JoinCategories } };
+    case constants::ReportGroupings::TaskItemType:
+        return { "task_items.task_item_type_id",
+            "task_item_types.name",
+            "task_item_types.name COLLATE NOCASE",
+            { JoinTaskItemTypes } };
+    case constants::ReportGroupings::Day:
+        return { "tasks.task_date", "tasks.task_date", "tasks.task_date", {} };
+    case constants::ReportGroupings::Week:
+        return { "CAST(julianday(tasks.task_date) + 0.5 AS INTEGER) / 7",
+            "strftime('%Y', " + IsoWeekThursday + ") || '-W' || printf('%02d', (strftime('%j', " + IsoWeekThursday +
+                ") - 1) / 7 + 1)",
+            "MIN(tasks.task_date)",
+            {} };
+    case constants::ReportGroupings::Month:
+        return { "substr(tasks.task_date, 1, 7)", "substr(tasks.task_date, 1, 7)", "substr(tasks.task_date, 1, 7)", {} };
+    default:
+        return { "NULL", "''", "NULL", {} };
+    }
+}
+} // namespace
+
+/* task_items.duration is stored as a zero padded "HH:MM:SS" string */
+const std::string ReportService::SelectTotals =
+    ", COUNT(*) "
+    ", SUM(CAST(substr(task_items.duration, 1, 2) AS INTEGER) * 3600 "
+    "+ CAST(substr(task_items.duration, 4, 2) AS INTEGER) * 60 "
+    "+ CAST(substr(task_items.duration, 7, 2) AS INTEGER)) "
+    ", SUM(CASE WHEN task_items.billable = 1 "
+    "THEN CAST(substr(task_items.duration, 1, 2) AS INTEGER) * 3600 "
+    "+ CAST(substr(task_items.duration, 4, 2) AS INTEGER) * 60 "
+    "+ CAST(substr(task_items.duration, 7, 2) AS INTEGER) "
+    "ELSE 0 END) "
+    ", TOTAL(CASE WHEN task_items.billable = 1 THEN task_items.calculated_rate END) ";
+
+const std::string ReportService::FromTaskItems = "FROM task_items "
+                                                 "INNER JOIN tasks "
+                                                 "ON task_items.task_id = tasks.task_id ";
+
+const std::string ReportService::WhereDateRange = "WHERE tasks.task_date >= ? "
+                                                  "AND tasks.task_date <= ? "
+                                                  "AND task_items.is_active = 1 ";
+
+ReportService::ReportService(std::shared_ptr<spdlog::logger> logger)
+    : pLogger(logger)
+{
+    pConnection = db::ConnectionProvider::Get().Handle()->Acquire();
+}
+
+ReportService::~ReportService()
+{
+    db::ConnectionProvider::Get().Handle()->Release(pConnection);
+}
+
+bool ReportService::Run(constants::ReportGroupings grouping,
+    constants::ReportGroupings breakdown,
+    const std::string& fromDate,
+    const std::string& toDate,
+    ReportTable& table)
+{
+    if (breakdown == grouping) {
+        breakdown = constants::ReportGroupings::None;
+    }
+
+    table.Grouping = grouping;
+    table.Breakdown = breakdown;
+    table.FromDate = fromDate;
+    table.ToDate = toDate;
+    table.Rows.clear();
+    table.Totals = ReportRow{ "Total", "", 0, 0, 0, 0.0 };
+
+    const std::string query = BuildQuery(grouping, breakdown);
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        *pConnection->DatabaseExecutableHandle() << query << fromDate << toDate >>
+            [&](std::unique_ptr<std::string> group,
+                std::unique_ptr<std::string> breakdownLabel,
+                int entries,
+                std::int64_t seconds,
+                std::int64_t billableSeconds,
+                double billableAmount) {
+                ReportRow row{ group ? *group : "",
+                    breakdownLabel ? *breakdownLabel : "",
+                    entries,
+                    seconds,
+                    billableSeconds,
+                    billableAmount };
+
+                table.Totals.Entries += entries;
+                table.Totals.Seconds += seconds;
+                table.Totals.BillableSeconds += billableSeconds;
+                table.Totals.BillableAmount += billableAmount;
+
+                table.Rows.push_back(std::move(row));
+            };
+    } catch (const sqlite::sqlite_exception& e) {
+        pLogger->error("Error occured in ReportService::Run() - {0:d} : {1}", e.get_code(), e.what());
+        return false;
+    }
+
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    pLogger->debug("Report by {0} ({1}) returned {2:d} rows in {3:d} ms",
+        GetReportGroupingName(grouping),
+        GetReportGroupingName(breakdown),
+        table.Rows.size(),
+        elapsed);
+
+    return true;
+}
+
+std::string ReportService::BuildQuery(constants::ReportGroupings grouping, constants::ReportGroupings breakdown) const
+{
+    GroupingColumns groupColumns = GetGroupingColumns(grouping);
+    GroupingColumns breakdownColumns = GetGroupingColumns(breakdown);
+
+    std::string joins;
+    for (const auto* columns : { &groupColumns, &breakdownColumns }) {
+        for (const auto& join : columns->Joins) {
+            if (joins.find(join) == std::string::npos) {
+                joins += join;
+            }
+        }
+    }
+
+    std::string query = "SELECT " + groupColumns.Label + ", " + breakdownColumns.Label + SelectTotals + FromTaskItems +
+                        joins + WhereDateRange + "GROUP BY " + groupColumns.Key;
+    if (breakdown != constants::ReportGroupings::None) {
+        query += ", " + breakdownColumns.Key;
+    }
+
+    query += " ORDER BY " + groupColumns.Order;
+    if (breakdown != constants::ReportGroupings::None) {
+        query += ", " + breakdownColumns.Order;
+    }
+
+    return query;
+}
+
+std::string GetReportGroupingName(constants::ReportGroupings grouping)
+{
+    switch (grouping) {
+    case constants::ReportGroupings::Project:
+        return "Project";
+    case constants::ReportGroupings::Client:
+        return "Client";
+    case constants::ReportGroupings::Employer:
+        return "Employer";
+    case constants::ReportGroupings::Category:
+        return "Category";
+    case constants::ReportGroupings::TaskItemType:
+        return "Task Item Type";
+    case constants::ReportGroupings::Day:
+        return "Day";
+    case constants::ReportGroupings::Week:
+        return "Week";
+    case constants::ReportGroupings::Month:
+        return "Month";
+    default:
+        return "None";
+    }
+}
+
+std::string FormatReportHours(std::int64_t seconds)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f", static_cast<double>(seconds) / 3600.0);
+    return buffer;
+}
+
+std::string FormatReportAmount(double amount)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f", amount);
+    return buffer;
+}
+
+bool WriteReportCsv(const ReportTable& table, std::ostream& output, char delimiter)
+{
+    const bool hasBreakdown = table.Breakdown != constants::ReportGroupings::None;
+
+    CsvWriter writer(output, delimiter);
+
+    writer.WriteField(GetReportGroupingName(table.Grouping));
+    if (hasBreakdown) {
+        writer.WriteField(GetReportGroupingName(table.Breakdown));
+    }
+    for (const char* header : { "Entries", "Hours", "Billable Hours", "Billable Amount" }) {
+        writer.WriteField(header, std::strlen(header));
+    }
+    writer.EndRow();
+
+    auto writeRow = [&](const ReportRow& row) {
+        writer.WriteField(row.Group);
+        if (hasBreakdown) {
+            writer.WriteField(row.Breakdown);
+        }
+        writer.WriteField(std::to_string(row.Entries));
+        writer.WriteField(FormatReportHours(row.Seconds));
+        writer.WriteField(FormatReportHours(row.BillableSeconds));
+        writer.WriteField(FormatReportAmount(row.BillableAmount));
+        writer.EndRow();
+    };
+
+    for (const auto& row : table.Rows) {
+        writeRow(row);
+    }
+    writeRow(table.Totals);
+
+    return !output.fail();
+}
+} // namespace app::svc
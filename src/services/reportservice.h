@@ -0,0 +1,92 @@
+// Productivity tool to help you track the time you spend on tasks
+// Copyright (C) 2020  Szymon Welgus
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//  Contact:
+//    szymonwelgus at gmail dot com
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "../common/constants.h"
+#include "../database/connectionprovider.h"
+#include "../database/sqliteconnection.h"
+
+namespace app::svc
+{
+struct ReportRow {
+    std::string Group;
+    std::string Breakdown;
+    int Entries;
+    std::int64_t Seconds;
+    std::int64_t BillableSeconds;
+    double BillableAmount;
+};
+
+struct ReportTable {
+    constants::ReportGroupings Grouping;
+    constants::ReportGroupings Breakdown;
+    std::string FromDate;
+    std::string ToDate;
+    std::vector<ReportRow> Rows;
+    ReportRow Totals;
+};
+
+/*
+ Summarizes task items between two dates by one grouping (e.g. project) and optionally breaks
+ each group down further (e.g. by week). All of the aggregation is done by SQLite with GROUP BY
+ so only one row per group is read back, regardless of how many task items are in the range.
+ Billable amounts are the sum of the calculated rate of each billable task item, a rate stored for an
+ item on a billable project that is itself not billable is left out.
+ */
+class ReportService final
+{
+public:
+    ReportService() = delete;
+    ReportService(std::shared_ptr<spdlog::logger> logger);
+    ~ReportService();
+
+    bool Run(constants::ReportGroupings grouping,
+        constants::ReportGroupings breakdown,
+        const std::string& fromDate,
+        const std::string& toDate,
+        ReportTable& table);
+
+private:
+    std::string BuildQuery(constants::ReportGroupings grouping, constants::ReportGroupings breakdown) const;
+
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::shared_ptr<db::SqliteConnection> pConnection;
+
+    static const std::string SelectTotals;
+    static const std::string FromTaskItems;
+    static const std::string WhereDateRange;
+};
+
+std::string GetReportGroupingName(constants::ReportGroupings grouping);
+
+std::string FormatReportHours(std::int64_t seconds);
+
+std::string FormatReportAmount(double amount);
+
+bool WriteReportCsv(const ReportTable& table, std::ostream& output, char delimiter);
+} // namespace app::svc
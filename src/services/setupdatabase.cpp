@@ -19,91 +19,50 @@
 
 #include "setupdatabase.h"
 
-#include <wx/textfile.h>
-#include <wx/stdpaths.h>
+#include "sqlscripts.h"
 
-#include "../common/util.h"
+#include "../database/connectionprovider.h"
+#include "../database/sqliteconnection.h"
 
 namespace app::svc
 {
-const wxString SetupTables::CreateDatabaseFile = wxT("create-taskable.sql");
-const wxString SetupTables::SeedDatabaseFile = wxT("seed-taskable.sql");
-
 SetupTables::SetupTables(std::shared_ptr<spdlog::logger> logger)
     : pLogger(logger)
 {
 }
 
 bool SetupTables::CreateTables()
-{
-    return Create() && Seed();
-}
-
-std::vector<std::string> SetupTables::ReadFile(wxString fileToRead)
-{
-    auto scriptPath =
-        wxString::Format(wxT("%s\\%s"), wxPathOnly(wxStandardPaths::Get().GetExecutablePath()), fileToRead);
-    wxTextFile file;
-    if (!file.Open(scriptPath)) {
-        pLogger->error("Error occured: Unable to open file: {0}", scriptPath.ToStdString());
-        return std::vector<std::string>();
-    }
-
-    wxString fileData;
-    fileData = file.GetFirstLine();
-    while (!file.Eof()) {
-        fileData += file.GetNextLine();
-    }
-
-    /* Since some currencies symbols are UTF8 specific characters
-       we cannot use ToStdString() as that (tries) to convert to regular
-       ASCII and the conversion results in an error.
-       The solution is to first convert to UTF8 explicitly and then
-       initialize a std::string from that. This way std::string will handle
-       the symbol character encodings correctly
-    */
-    /* TODO: Internationalization of Taskable might require using this approach everywhere */
-    // Note that in the debugger, the encodings do not look correct
-    auto fileDataString = fileData.ToUTF8();
-    return util::lib::split(std::string(fileDataString), ';');
-}
-
-bool SetupTables::ExecuteDatabaseAction(std::vector<std::string> sqlTokens)
 {
     auto connectionHandle = db::ConnectionProvider::Get().Handle()->Acquire();
-
-    try {
-        auto databaseHandle = connectionHandle->DatabaseExecutableHandle();
-        for (const auto& token : sqlTokens) {
-            *databaseHandle << token;
-        }
-
-    } catch (const sqlite::sqlite_exception& e) {
-        pLogger->error("Error occured: Database Create Table Procedure - {0:d} : {1}", e.get_code(), e.what());
-        return false;
+    auto database = connectionHandle->DatabaseExecutableHandle()->connection().get();
+
+    /* a deferred BEGIN on purpose: PRAGMA auto_vacuum at the top of create-taskable.sql is only
+       honoured if it runs before the first write starts the write transaction */
+    bool success = ExecuteScript(database, "BEGIN", "BEGIN;") &&
+                   ExecuteScript(database, "create-taskable.sql", scripts::CreateTaskable) &&
+                   ExecuteScript(database, "seed-taskable.sql", scripts::SeedTaskable) &&
+                   ExecuteScript(database, "COMMIT", "COMMIT;");
+    if (!success) {
+        sqlite3_exec(database, "ROLLBACK;", nullptr, nullptr, nullptr);
     }
 
     db::ConnectionProvider::Get().Handle()->Release(connectionHandle);
-    return true;
+    return success;
 }
 
-bool SetupTables::Create()
+bool SetupTables::ExecuteScript(sqlite3* database, const char* scriptName, const char* script)
 {
-    auto sqlTokens = ReadFile(SetupTables::CreateDatabaseFile);
-    if (sqlTokens.empty()) {
+    char* errorMessage = nullptr;
+    int rc = sqlite3_exec(database, script, nullptr, nullptr, &errorMessage);
+    if (rc != SQLITE_OK) {
+        pLogger->error("Error occured: Database Create Table Procedure {0} - {1:d} : {2}",
+            scriptName,
+            rc,
+            errorMessage != nullptr ? errorMessage : sqlite3_errstr(rc));
+        sqlite3_free(errorMessage);
         return false;
     }
 
-    return ExecuteDatabaseAction(sqlTokens);
-}
-
-bool SetupTables::Seed()
-{
-    auto sqlTokens = ReadFile(SetupTables::SeedDatabaseFile);
-    if (sqlTokens.empty()) {
-        return false;
-    }
-
-    return ExecuteDatabaseAction(sqlTokens);
+    return true;
 }
 } // namespace app::svc
@@ -19,19 +19,18 @@
 
 #pragma once
 
-#include <string>
-#include <vector>
+#include <memory>
 
 #include <spdlog/spdlog.h>
-#include <sqlite_modern_cpp.h>
-#include <wx/string.h>
-
-#include "../data/employerdata.h"
-#include "../data/clientdata.h"
-#include "../data/projectdata.h"
+#include <sqlite3.h>
 
 namespace app::svc
 {
+/*
+ Creates the schema of a new database and seeds its lookup tables. The scripts are compiled into
+ the executable (see cmake/EmbedSqlScripts.cmake) and run in a single transaction, so a failed setup
+ leaves an empty database behind rather than a partial one.
+ */
 class SetupTables final
 {
 public:
@@ -41,15 +40,8 @@ class SetupTables final
     bool CreateTables();
 
 private:
-    std::shared_ptr<spdlog::logger> pLogger;
-
-    std::vector<std::string> ReadFile(wxString fileToRead);
-    bool ExecuteDatabaseAction(std::vector<std::string> sqlTokens);
+    bool ExecuteScript(sqlite3* database, const char* scriptName, const char* script);
 
-    bool Create();
-    bool Seed();
-
-    static const wxString CreateDatabaseFile;
-    static const wxString SeedDatabaseFile;
+    std::shared_ptr<spdlog::logger> pLogger;
 };
 } // namespace app::svc
@@ -23,7 +23,8 @@
 #include <tuple>
 #include <vector>
 
-#include <wx/wx.h>
+#include <wx/datetime.h>
+#include <wx/string.h>
 
 namespace app::services
 {
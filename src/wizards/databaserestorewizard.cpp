@@ -19,18 +19,16 @@
 
 #include "databaserestorewizard.h"
 
-#include <string>
-
-#include <wx/file.h>
-#include <wx/filefn.h>
 #include <wx/filename.h>
-#include <wx/regex.h>
-#include <wx/stdpaths.h>
 
 #include "../config/configurationprovider.h"
-#include "../database/sqliteconnectionfactory.h"
-#include "../database/sqliteconnection.h"
-#include "../database/connectionprovider.h"
+#include "../services/backupindex.h"
+#include "../services/backuppreview.h"
+#include "../services/backupverifier.h"
+#include "../services/databaserestore.h"
+
+wxDEFINE_EVENT(BACKUP_PREVIEW_THREAD_COMPLETED, wxThreadEvent);
+wxDEFINE_EVENT(DATABASE_RESTORE_THREAD_COMPLETED, wxThreadEvent);
 
 namespace app::wizard
 {
@@ -50,7 +48,7 @@ DatabaseRestoreWizard::DatabaseRestoreWizard(frm::MainFrame* frame,
     , bRestoreWithNoPreviousFileExisting(restoreWithNoPreviousFileExisting)
 {
     pPage1 = new DatabaseRestoreWelcomePage(this);
-    auto page2 = new SelectDatabaseVersionPage(this);
+    auto page2 = new SelectDatabaseVersionPage(this, pLogger);
     auto page3 = new DatabaseRestoredPage(this, pLogger);
 
     wxWizardPageSimple::Chain(pPage1, page2);
@@ -114,17 +112,76 @@ void DatabaseRestoreWelcomePage::CreateControls()
     SetSizerAndFit(mainSizer);
 }
 
-SelectDatabaseVersionPage::SelectDatabaseVersionPage(DatabaseRestoreWizard* parent)
+BackupPreviewThread::BackupPreviewThread(SelectDatabaseVersionPage* handler,
+    std::shared_ptr<spdlog::logger> logger,
+    const wxString& backupFileName,
+    long generation)
+    : wxThread(wxTHREAD_JOINABLE)
+    , pHandler(handler)
+    , pLogger(logger)
+    , mBackupFileName(backupFileName)
+    , mBackupPath(cfg::ConfigurationProvider::Get().Configuration->GetBackupPath())
+    , mDatabaseFilePath(
+          common::GetDatabaseFilePath(cfg::ConfigurationProvider::Get().Configuration->GetDatabasePath()))
+    , mGeneration(generation)
+{
+}
+
+wxThread::ExitCode BackupPreviewThread::Entry()
+{
+    /* created first, its time budget covers extracting the backup as well as the queries */
+    svc::BackupPreviewer backupPreviewer(pLogger, [&]() { return TestDestroy(); });
+
+    /* compressed and incremental backups are previewed from a temporary copy */
+    svc::BackupVerifier backupVerifier(
+        pLogger, mBackupPath, wxGetEmptyString(), [&]() { return backupPreviewer.ShouldStop(); });
+    auto previewFilePath = backupVerifier.ExtractBackup(mBackupFileName);
+
+    auto preview = std::make_shared<svc::BackupPreview>();
+    bool success = !previewFilePath.empty() && backupPreviewer.Preview(previewFilePath, mDatabaseFilePath, *preview);
+    /* 1 previewed, 2 the budget ran out before the backup was extracted, 0 failed */
+    int result = success ? 1 : (previewFilePath.empty() && backupVerifier.IsCancelled() ? 2 : 0);
+
+    if (!previewFilePath.empty() && previewFilePath != wxFileName(mBackupPath, mBackupFileName).GetFullPath()) {
+        wxRemoveFile(previewFilePath);
+    }
+
+    if (TestDestroy()) {
+        return (wxThread::ExitCode) 1;
+    }
+
+    auto event = new wxThreadEvent(BACKUP_PREVIEW_THREAD_COMPLETED);
+    event->SetString(mBackupFileName);
+    event->SetInt(result);
+    event->SetExtraLong(mGeneration);
+    event->SetPayload(preview);
+    wxQueueEvent(pHandler, event);
+
+    return (wxThread::ExitCode) 0;
+}
+
+SelectDatabaseVersionPage::SelectDatabaseVersionPage(DatabaseRestoreWizard* parent,
+    std::shared_ptr<spdlog::logger> logger)
     : wxWizardPageSimple(parent)
     , pParent(parent)
+    , pLogger(logger)
     , pListCtrl(nullptr)
+    , pPreviewText(nullptr)
+    , pPreviewThread(nullptr)
     , mSelectedIndex(-1)
+    , mPreviewGeneration(0)
+    , mPendingPreview()
 {
     CreateControls();
     ConfigureEventBindings();
     FillControls();
 }
 
+SelectDatabaseVersionPage::~SelectDatabaseVersionPage()
+{
+    StopPreview();
+}
+
 bool SelectDatabaseVersionPage::TransferDataFromWindow()
 {
     if (mSelectedIndex < 0) {
@@ -141,6 +198,10 @@ bool SelectDatabaseVersionPage::TransferDataFromWindow()
     wxString databaseSelection = item.GetText();
     pParent->SetDatabaseVersionToRestore(databaseSelection);
 
+    /* the restore replaces the database the preview compares against */
+    mPendingPreview.clear();
+    StopPreview();
+
     return true;
 }
 
@@ -176,6 +237,9 @@ void SelectDatabaseVersionPage::CreateControls()
     dateColumn.SetWidth(98);
     pListCtrl->InsertColumn(1, dateColumn);
 
+    pPreviewText = new wxStaticText(this, wxID_ANY, wxT("Select a version to preview its contents"));
+    databaseVersionSizer->Add(pPreviewText, wxSizerFlags().Border(wxALL, 5).Expand());
+
     SetSizerAndFit(mainSizer);
 }
 
@@ -199,27 +263,29 @@ void SelectDatabaseVersionPage::ConfigureEventBindings()
         &SelectDatabaseVersionPage::OnWizardCancel,
         this
     );
+
+    Bind(
+        BACKUP_PREVIEW_THREAD_COMPLETED,
+        &SelectDatabaseVersionPage::OnPreviewCompleted,
+        this
+    );
 }
 // clang-format on
 
 void SelectDatabaseVersionPage::FillControls()
 {
     const wxString backupPath = cfg::ConfigurationProvider::Get().Configuration->GetBackupPath();
-    wxArrayString files;
-    wxDir::GetAllFiles(backupPath, &files, wxEmptyString, wxDIR_FILES);
+    svc::BackupIndex backupIndex(pLogger, backupPath);
+    if (!backupIndex.Load()) {
+        return;
+    }
 
     int listIndex = 0;
     int columnIndex = 0;
-    for (const auto& file : files) {
-        wxRegEx dateRegex(wxT("([0-9]{4}-[0-9]{2}-[0-9]{2})"));
-        if (dateRegex.IsValid()) {
-            if (dateRegex.Matches(file)) {
-                wxFileName filename(file);
-                auto dateComponent = dateRegex.GetMatch(file, 0);
-                listIndex = pListCtrl->InsertItem(columnIndex++, filename.GetFullName());
-                pListCtrl->SetItem(listIndex, columnIndex++, dateComponent);
-            }
-        }
+    for (const auto& entry : backupIndex.GetEntries()) {
+        auto dateComponent = wxDateTime(static_cast<time_t>(entry.Timestamp)).FormatISODate();
+        listIndex = pListCtrl->InsertItem(columnIndex++, entry.FileName);
+        pListCtrl->SetItem(listIndex, columnIndex++, dateComponent);
         columnIndex = 0;
     }
 }
@@ -227,11 +293,14 @@ void SelectDatabaseVersionPage::FillControls()
 void SelectDatabaseVersionPage::OnItemChecked(wxListEvent& event)
 {
     mSelectedIndex = event.GetIndex();
+    StartPreview(pListCtrl->GetItemText(mSelectedIndex));
 }
 
 void SelectDatabaseVersionPage::OnItemUnchecked(wxListEvent& event)
 {
     mSelectedIndex = -1;
+    mPendingPreview.clear();
+    pPreviewText->SetLabel(wxT("Select a version to preview its contents"));
 }
 
 void SelectDatabaseVersionPage::OnWizardCancel(wxWizardEvent& event)
@@ -243,6 +312,162 @@ void SelectDatabaseVersionPage::OnWizardCancel(wxWizardEvent& event)
     }
 }
 
+void SelectDatabaseVersionPage::OnPreviewCompleted(wxThreadEvent& event)
+{
+    /* queued before StopPreview deleted its thread, pPreviewThread is another preview by now (or none) */
+    if (event.GetExtraLong() != mPreviewGeneration) {
+        return;
+    }
+
+    /* Entry has returned, so this does not block */
+    if (pPreviewThread) {
+        pPreviewThread->Wait();
+        delete pPreviewThread;
+        pPreviewThread = nullptr;
+    }
+
+    if (!mPendingPreview.empty()) {
+        auto backupFileName = mPendingPreview;
+        mPendingPreview.clear();
+        StartPreview(backupFileName);
+        return;
+    }
+
+    /* the selection changed or was cleared while the preview was running */
+    if (mSelectedIndex < 0 || pListCtrl->GetItemText(mSelectedIndex) != event.GetString()) {
+        return;
+    }
+
+    if (event.GetInt() == 2) {
+        pPreviewText->SetLabel(wxT("Preview stopped, the selected version took too long to extract"));
+        return;
+    }
+
+    if (event.GetInt() != 1) {
+        pPreviewText->SetLabel(wxT("The selected version could not be read"));
+        return;
+    }
+
+    const auto& preview = *event.GetPayload<std::shared_ptr<svc::BackupPreview>>();
+
+    auto formatDuration = [](std::int64_t seconds) {
+        return seconds < 0 ? wxString(wxT("none")) : wxTimeSpan::Seconds(seconds).Format(wxT("%H:%M:%S"));
+    };
+
+    wxString previewText = wxString::Format(wxT("Schema version %d, tasks from %s to %s\n"
+                                                "%lld task items, %lld meetings\n"),
+        preview.SchemaVersion,
+        preview.FirstTaskDate,
+        preview.LastTaskDate,
+        static_cast<long long>(preview.TaskItemCount),
+        static_cast<long long>(preview.MeetingCount));
+
+    if (preview.LastModified > 0) {
+        previewText += wxString::Format(wxT("Last modified %s: %s\n"),
+            wxDateTime(static_cast<time_t>(preview.LastModified)).FormatISOCombined(' '),
+            wxString::FromUTF8(preview.LastModifiedDescription));
+    }
+
+    if (preview.Truncated) {
+        previewText += wxT("Preview stopped and comparison with the current database skipped, it took too long");
+    } else if (preview.DatabaseCompared && preview.DifferingDays.empty()) {
+        previewText += wxString::Format(
+            wxT("Daily totals match the current database (last %d days)"), preview.ComparedDays);
+    } else if (preview.DatabaseCompared) {
+        previewText += wxString::Format(wxT("%d days differ from the current database (last %d days):"),
+            static_cast<int>(preview.DifferingDays.size()),
+            preview.ComparedDays);
+
+        /* newest differences first, they are the ones a restore is most likely about */
+        const std::size_t MaxListedDays = 5;
+        std::size_t listedDays = 0;
+        for (auto day = preview.DifferingDays.rbegin();
+             day != preview.DifferingDays.rend() && listedDays < MaxListedDays;
+             ++day, ++listedDays) {
+            previewText += wxString::Format(wxT("\n    %s  backup %s, current %s"),
+                day->Date,
+                formatDuration(day->BackupSeconds),
+                formatDuration(day->DatabaseSeconds));
+        }
+
+        if (preview.DifferingDays.size() > MaxListedDays) {
+            previewText += wxString::Format(
+                wxT("\n    and %d more"), static_cast<int>(preview.DifferingDays.size() - MaxListedDays));
+        }
+    }
+
+    pPreviewText->SetLabel(previewText);
+    GetSizer()->Layout();
+}
+
+/* runs off the UI thread, one preview at a time; a selection made meanwhile is previewed next */
+void SelectDatabaseVersionPage::StartPreview(const wxString& backupFileName)
+{
+    pPreviewText->SetLabel(wxT("Loading preview..."));
+    if (pPreviewThread) {
+        mPendingPreview = backupFileName;
+        return;
+    }
+
+    pPreviewThread = new BackupPreviewThread(this, pLogger, backupFileName, ++mPreviewGeneration);
+    auto ret = pPreviewThread->Create();
+    if (ret == wxTHREAD_NO_ERROR) {
+        ret = pPreviewThread->Run();
+    }
+
+    if (ret != wxTHREAD_NO_ERROR) {
+        pLogger->error("Could not start the backup preview thread");
+        delete pPreviewThread;
+        pPreviewThread = nullptr;
+        pPreviewText->SetLabel(wxT("The selected version could not be read"));
+    }
+}
+
+void SelectDatabaseVersionPage::StopPreview()
+{
+    if (!pPreviewThread) {
+        return;
+    }
+
+    /* makes TestDestroy() return true and waits, extracting and the preview queries stop straight away */
+    auto ret = pPreviewThread->Delete();
+    if (ret != wxTHREAD_NO_ERROR && ret != wxTHREAD_NOT_RUNNING) {
+        pLogger->error("Could not stop the backup preview thread");
+    }
+    delete pPreviewThread;
+    pPreviewThread = nullptr;
+    /* its completion event may already be queued */
+    mPreviewGeneration++;
+}
+
+DatabaseRestoreThread::DatabaseRestoreThread(DatabaseRestoredPage* handler,
+    std::shared_ptr<spdlog::logger> logger,
+    const wxString& backupFilePath,
+    const wxString& databaseFilePath)
+    : wxThread(wxTHREAD_JOINABLE)
+    , pHandler(handler)
+    , pLogger(logger)
+    , mBackupFilePath(backupFilePath)
+    , mDatabaseFilePath(databaseFilePath)
+{
+}
+
+wxThread::ExitCode DatabaseRestoreThread::Entry()
+{
+    /*
+     Restores through the SQLite backup API into the live database, the existing connection pool
+     keeps working, or renames a verified copy into place when there is no database yet
+     */
+    svc::DatabaseRestore databaseRestore(pLogger, mDatabaseFilePath);
+    bool success = databaseRestore.Execute(mBackupFilePath);
+
+    auto event = new wxThreadEvent(DATABASE_RESTORE_THREAD_COMPLETED);
+    event->SetInt(success ? 1 : 0);
+    wxQueueEvent(pHandler, event);
+
+    return (wxThread::ExitCode) 0;
+}
+
 DatabaseRestoredPage::DatabaseRestoredPage(DatabaseRestoreWizard* parent, std::shared_ptr<spdlog::logger> logger)
     : wxWizardPageSimple(parent)
     , pParent(parent)
@@ -250,11 +475,18 @@ DatabaseRestoredPage::DatabaseRestoredPage(DatabaseRestoreWizard* parent, std::s
     , pStatusInOperationLabel(nullptr)
     , pGaugeCtrl(nullptr)
     , pStatusCompleteLabel(nullptr)
+    , pRestoreThread(nullptr)
+    , pPulseTimer(std::make_unique<wxTimer>(this, IDC_PULSE_TIMER))
 {
     CreateControls();
     ConfigureEventBindings();
 }
 
+DatabaseRestoredPage::~DatabaseRestoredPage()
+{
+    StopRestore();
+}
+
 void DatabaseRestoredPage::CreateControls()
 {
     auto mainSizer = new wxBoxSizer(wxVERTICAL);
@@ -291,81 +523,64 @@ void DatabaseRestoredPage::ConfigureEventBindings()
         &DatabaseRestoredPage::OnWizardCancel,
         this
     );
+
+    Bind(
+        DATABASE_RESTORE_THREAD_COMPLETED,
+        &DatabaseRestoredPage::OnRestoreCompleted,
+        this
+    );
+
+    Bind(
+        wxEVT_TIMER,
+        &DatabaseRestoredPage::OnPulseTimer,
+        this,
+        IDC_PULSE_TIMER
+    );
 }
 // clang-format on
 
 void DatabaseRestoredPage::OnWizardPageShown(wxWizardEvent& event)
 {
-    pGaugeCtrl->Pulse();
+    if (pRestoreThread) {
+        return;
+    }
 
     const wxString fileToRestore = pParent->GetDatabaseFileVersionToRestore();
-
     const wxString backupPath = cfg::ConfigurationProvider::Get().Configuration->GetBackupPath();
-    const wxString dataPath = cfg::ConfigurationProvider::Get().Configuration->GetDatabasePath();
-
-    auto fullBackupDatabaseFilePath = wxString::Format(wxT("%s\\%s"), backupPath, fileToRestore);
-    auto toCopyDatabaseFilePath = wxString::Format(wxT("%s\\%s"), dataPath, fileToRestore);
-
-    /* Check if the backups are in the same place as main database */
-    if (backupPath != dataPath) {
-        /* Copy selected database file to correct path */
-        bool copySuccessful = wxCopyFile(fullBackupDatabaseFilePath, toCopyDatabaseFilePath);
-        if (!copySuccessful) {
-            FileOperationErrorFeedback();
-            pLogger->error("Failed to copy {0} to destination {1}",
-                fullBackupDatabaseFilePath.ToStdString(),
-                toCopyDatabaseFilePath.ToStdString());
-            return;
-        }
-    }
+    auto fullBackupDatabaseFilePath = wxFileName(backupPath, fileToRestore).GetFullPath();
 
     auto existingDatabaseFile =
         common::GetDatabaseFilePath(cfg::ConfigurationProvider::Get().Configuration->GetDatabasePath());
 
-    /* If there is a existing 'db' file */
-    if (!pParent->IsRestoreWithNoPreviousFileExisting()) {
-        /* Terminate connection to database */
-        db::ConnectionProvider::Get().PurgeConnectionPool();
-
-        /* Rename existing file temporarily (in case any of the next steps fail) */
-        bool tmpRenameOfCurrentDatabaseFileSuccessful =
-            wxRenameFile(existingDatabaseFile, wxString::Format(wxT("%s.tmp"), existingDatabaseFile));
-        if (!tmpRenameOfCurrentDatabaseFileSuccessful) {
-            FileOperationErrorFeedback();
-            pLogger->error("Failed to rename file {0} to {1}",
-                existingDatabaseFile.ToStdString(),
-                wxString::Format(wxT("%s.tmp"), existingDatabaseFile).ToStdString());
-            return;
-        }
+    /* extracting, checking and copying a large backup takes a while, the page keeps pulsing meanwhile */
+    pRestoreThread = new DatabaseRestoreThread(this, pLogger, fullBackupDatabaseFilePath, existingDatabaseFile);
+    auto ret = pRestoreThread->Create();
+    if (ret == wxTHREAD_NO_ERROR) {
+        ret = pRestoreThread->Run();
     }
 
-    /* Rename the selected database file to the plain name */
-    bool renameToNewNameSuccessful = wxRenameFile(toCopyDatabaseFilePath, existingDatabaseFile);
-    if (!renameToNewNameSuccessful) {
+    if (ret != wxTHREAD_NO_ERROR) {
+        pLogger->error("Could not start the database restore thread");
+        delete pRestoreThread;
+        pRestoreThread = nullptr;
         FileOperationErrorFeedback();
-        pLogger->error("Failed to rename file {0} to {1}",
-            toCopyDatabaseFilePath.ToStdString(),
-            existingDatabaseFile.ToStdString());
         return;
     }
 
-    /* If there is a existing 'db' file */
-    if (!pParent->IsRestoreWithNoPreviousFileExisting()) {
-        /* Remove the temporary file */
-        bool removeTmpDatabaseFile = wxRemoveFile(wxString::Format(wxT("%s.tmp"), existingDatabaseFile));
-        if (!removeTmpDatabaseFile) {
-            FileOperationErrorFeedback();
-            pLogger->error(
-                "Failed to remove file {0}", wxString::Format(wxT("%s.tmp"), existingDatabaseFile).ToStdString());
-            return;
-        }
+    EnableWizardButtons(false);
+    pGaugeCtrl->Pulse();
+    pPulseTimer->Start(100);
+}
 
-        /* Restore connection to database */
-        if (!InitializeDatabaseConnectionProvider()) {
-            FileOperationErrorFeedback();
-            pLogger->error("Failed to re-initialize database connection provider");
-            return;
-        }
+void DatabaseRestoredPage::OnRestoreCompleted(wxThreadEvent& event)
+{
+    /* queued as the thread's last step, joining it is immediate */
+    StopRestore();
+    EnableWizardButtons(true);
+
+    if (event.GetInt() != 1) {
+        FileOperationErrorFeedback();
+        return;
     }
 
     /* Complete operation */
@@ -376,8 +591,41 @@ void DatabaseRestoredPage::OnWizardPageShown(wxWizardEvent& event)
     pGaugeCtrl->SetValue(100);
 }
 
+void DatabaseRestoredPage::OnPulseTimer(wxTimerEvent& WXUNUSED(event))
+{
+    pGaugeCtrl->Pulse();
+}
+
+void DatabaseRestoredPage::StopRestore()
+{
+    pPulseTimer->Stop();
+    if (!pRestoreThread) {
+        return;
+    }
+
+    pRestoreThread->Wait();
+    delete pRestoreThread;
+    pRestoreThread = nullptr;
+}
+
+void DatabaseRestoredPage::EnableWizardButtons(bool enable)
+{
+    for (auto id : { wxID_BACKWARD, wxID_FORWARD, wxID_CANCEL }) {
+        auto button = pParent->FindWindow(id);
+        if (button != nullptr) {
+            button->Enable(enable);
+        }
+    }
+}
+
 void DatabaseRestoredPage::OnWizardCancel(wxWizardEvent& event)
 {
+    /* the buttons are disabled while restoring, closing the window must not leave the restore half done */
+    if (pRestoreThread) {
+        event.Veto();
+        return;
+    }
+
     auto userResponse = wxMessageBox(
         wxT("Are you sure want to cancel and exit?"), common::GetProgramName(), wxICON_QUESTION | wxYES_NO);
     if (userResponse == wxNO) {
@@ -394,14 +642,4 @@ void DatabaseRestoredPage::FileOperationErrorFeedback()
     pStatusCompleteLabel->SetLabel(statusError);
     pGaugeCtrl->SetValue(100);
 }
-
-bool DatabaseRestoredPage::InitializeDatabaseConnectionProvider()
-{
-    auto sqliteConnectionFactory = std::make_shared<db::SqliteConnectionFactory>(
-        common::GetDatabaseFilePath(cfg::ConfigurationProvider::Get().Configuration->GetDatabasePath()).ToStdString());
-    auto connectionPool = std::make_unique<db::ConnectionPool<db::SqliteConnection>>(sqliteConnectionFactory, 14);
-    db::ConnectionProvider::Get().ReInitializeConnectionPool(std::move(connectionPool));
-
-    return true;
-}
 } // namespace app::wizard
@@ -25,6 +25,7 @@
 #include <wx/wx.h>
 #include <wx/dir.h>
 #include <wx/listctrl.h>
+#include <wx/thread.h>
 #include <wx/wizard.h>
 
 #include <spdlog/spdlog.h>
@@ -33,9 +34,14 @@
 #include "../frame/mainframe.h"
 #include "../../res/database-restore-wizard.xpm"
 
+wxDECLARE_EVENT(BACKUP_PREVIEW_THREAD_COMPLETED, wxThreadEvent);
+wxDECLARE_EVENT(DATABASE_RESTORE_THREAD_COMPLETED, wxThreadEvent);
+
 namespace app::wizard
 {
 class DatabaseRestoreWelcomePage;
+class SelectDatabaseVersionPage;
+class DatabaseRestoredPage;
 
 class DatabaseRestoreWizard final : public wxWizard
 {
@@ -74,12 +80,40 @@ class DatabaseRestoreWelcomePage final : public wxWizardPageSimple
     void CreateControls();
 };
 
+/*
+ Extracts and previews one backup. Joinable, so the page can wait for it before starting the next
+ preview or going away. Extracting and the preview queries stop as soon as the thread is asked to or
+ the preview's time budget runs out. The completion event carries the generation it was started with.
+ */
+class BackupPreviewThread final : public wxThread
+{
+public:
+    BackupPreviewThread() = delete;
+    BackupPreviewThread(SelectDatabaseVersionPage* handler,
+        std::shared_ptr<spdlog::logger> logger,
+        const wxString& backupFileName,
+        long generation);
+    virtual ~BackupPreviewThread() = default;
+
+protected:
+    ExitCode Entry() override;
+
+private:
+    SelectDatabaseVersionPage* pHandler;
+    std::shared_ptr<spdlog::logger> pLogger;
+    wxString mBackupFileName;
+    wxString mBackupPath;
+    wxString mDatabaseFilePath;
+    long mGeneration;
+};
+
 class SelectDatabaseVersionPage final : public wxWizardPageSimple
 {
 public:
     SelectDatabaseVersionPage() = delete;
-    SelectDatabaseVersionPage(DatabaseRestoreWizard* parent);
-    virtual ~SelectDatabaseVersionPage() = default;
+    SelectDatabaseVersionPage(DatabaseRestoreWizard* parent,
+        std::shared_ptr<spdlog::logger> logger);
+    virtual ~SelectDatabaseVersionPage();
 
     bool TransferDataFromWindow() override;
 
@@ -91,11 +125,46 @@ class SelectDatabaseVersionPage final : public wxWizardPageSimple
     void OnItemChecked(wxListEvent& event);
     void OnItemUnchecked(wxListEvent& event);
     void OnWizardCancel(wxWizardEvent& event);
+    void OnPreviewCompleted(wxThreadEvent& event);
+
+    void StartPreview(const wxString& backupFileName);
+    void StopPreview();
 
     DatabaseRestoreWizard* pParent;
+    std::shared_ptr<spdlog::logger> pLogger;
     wxListCtrl* pListCtrl;
+    wxStaticText* pPreviewText;
+    BackupPreviewThread* pPreviewThread;
 
     int mSelectedIndex;
+    /* bumped for every preview started, events of a thread stopped meanwhile are ignored */
+    long mPreviewGeneration;
+    /* selected while another preview was running, started once that one is done */
+    wxString mPendingPreview;
+};
+
+/*
+ Extracts, checks and restores one backup, see svc::DatabaseRestore. Joinable, the page waits for it
+ before going away; a restore is never interrupted half way.
+ */
+class DatabaseRestoreThread final : public wxThread
+{
+public:
+    DatabaseRestoreThread() = delete;
+    DatabaseRestoreThread(DatabaseRestoredPage* handler,
+        std::shared_ptr<spdlog::logger> logger,
+        const wxString& backupFilePath,
+        const wxString& databaseFilePath);
+    virtual ~DatabaseRestoreThread() = default;
+
+protected:
+    ExitCode Entry() override;
+
+private:
+    DatabaseRestoredPage* pHandler;
+    std::shared_ptr<spdlog::logger> pLogger;
+    wxString mBackupFilePath;
+    wxString mDatabaseFilePath;
 };
 
 class DatabaseRestoredPage final : public wxWizardPageSimple
@@ -104,7 +173,7 @@ class DatabaseRestoredPage final : public wxWizardPageSimple
     DatabaseRestoredPage() = delete;
     DatabaseRestoredPage(DatabaseRestoreWizard* parent,
         std::shared_ptr<spdlog::logger> logger);
-    virtual ~DatabaseRestoredPage() = default;
+    virtual ~DatabaseRestoredPage();
 
 private:
     void CreateControls();
@@ -112,16 +181,22 @@ class DatabaseRestoredPage final : public wxWizardPageSimple
 
     void OnWizardPageShown(wxWizardEvent& event);
     void OnWizardCancel(wxWizardEvent& event);
+    void OnRestoreCompleted(wxThreadEvent& event);
+    void OnPulseTimer(wxTimerEvent& event);
 
+    void StopRestore();
+    void EnableWizardButtons(bool enable);
     void FileOperationErrorFeedback();
 
-    bool InitializeDatabaseConnectionProvider();
-
     DatabaseRestoreWizard* pParent;
     std::shared_ptr<spdlog::logger> pLogger;
 
     wxStaticText* pStatusInOperationLabel;
     wxGauge* pGaugeCtrl;
     wxStaticText* pStatusCompleteLabel;
+    DatabaseRestoreThread* pRestoreThread;
+    std::unique_ptr<wxTimer> pPulseTimer;
+
+    enum { IDC_PULSE_TIMER = wxID_HIGHEST + 1 };
 };
 } // namespace app::wizard